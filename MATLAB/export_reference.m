@@ -0,0 +1,166 @@
+%% ---------------------------------------------------------------
+% Export golden reference vectors for the C++ plugin
+% ---------------------------------------------------------------
+%
+% Runs the reference models (adsr_envelope.m, filter_block.m and the
+% wavetable generators sine/saw/square/triangle.m) over a fixed set of
+% cases and writes one text file per case to MATLAB/reference/.
+%
+% The C++ tool TECGoldenCheck (Plugin/tools/GoldenCheck.cpp) replays every
+% file through Envelope, RCFilter and the wavetable oscillators and reports
+% the error against these vectors. Re-run this script whenever a model
+% changes, and commit the regenerated files together with the model.
+%
+% File format (plain text, one item per line):
+%   # comment lines
+%   name <case name>
+%   kind envelope | filter | wavetable
+%   model <reference model file>
+%   sampleRate <Hz>
+%   <parameter> <value>          (kind specific, see below)
+%   tolerance <max abs error>
+%   deviation <text>             (optional: known, documented difference)
+%   deviationMaxError <value>    (with deviation: bounds of the expected
+%   deviationRmsError <value>     difference; TECGoldenCheck fails above them)
+%   data <number of columns>
+%   <one row per sample>
+%
+%   envelope : attack decay sustain release (s), gate (samples until note-off)
+%              columns: env
+%   filter   : type, cutoff (Hz), blockSize; columns: x y
+%   wavetable: wave; columns: bank (0-based) value
+% ---------------------------------------------------------------
+tic;
+
+outDir = fullfile(fileparts(mfilename('fullpath')), 'reference');
+if ~exist(outDir, 'dir')
+    mkdir(outDir);
+end
+
+% -------------------------------
+% Envelope: [attack decay sustain release gateSeconds]
+% -------------------------------
+envCases = { ...
+    'default',        [0.010 0.100 0.80 0.200 0.250]; ...
+    'fast',           [0.002 0.020 0.50 0.050 0.100]; ...
+    'release_attack', [0.050 0.100 0.70 0.030 0.020]};   % note-off during attack
+
+for fs = [44100 48000]
+    for c = 1:size(envCases, 1)
+        p = envCases{c, 2};
+        gate = round(p(5) * fs);
+        total = gate + round((p(4) + 0.01) * fs);
+
+        voice = struct();
+        voice.adsr = struct('attack', p(1), 'decay', p(2), 'sustain', p(3), 'release', p(4));
+        voice.env = struct('stage', 'attack', 'stageSampleCounter', 0, 'level', 0, 'releaseStartLevel', 0);
+
+        % Note-off como en voicemanager.m
+        [segOn, voice] = adsr_envelope(voice, gate, fs);
+        voice.env.stage = 'release';
+        voice.env.stageSampleCounter = 0;
+        voice.env.releaseStartLevel = voice.env.level;
+        [segOff, ~] = adsr_envelope(voice, total - gate, fs);
+
+        header = { ...
+            'kind', 'envelope'; 'model', 'adsr_envelope.m'; 'sampleRate', num2str(fs); ...
+            'attack', num2str(p(1)); 'decay', num2str(p(2)); 'sustain', num2str(p(3)); ...
+            'release', num2str(p(4)); 'gate', num2str(gate); 'tolerance', '1e-05'};
+        write_reference(outDir, sprintf('envelope_%s_%dk', envCases{c, 1}, round(fs / 1000)), ...
+            header, [segOn segOff]');
+    end
+end
+
+% -------------------------------
+% Filter: same input for every case (impulse, step, sine, noise)
+% -------------------------------
+fs = 44100;
+blockSize = 256;
+rng(1);
+x = [1 zeros(1, 255), 0.5 * ones(1, 768), ...
+     0.8 * sin(2*pi*440*(0:2047)/fs), 0.3 * randn(1, 1024)];
+
+filterCases = { ...
+    'lowpass', 200; 'lowpass', 1000; 'lowpass', 5000; ...
+    'highpass', 100; 'highpass', 2000; ...
+    'bandpass', 1000};
+
+for c = 1:size(filterCases, 1)
+    voice = struct();
+    voice.filter = struct('type', filterCases{c, 1}, 'cutoff', filterCases{c, 2}, 'fs', fs, 'bank', []);
+
+    y = zeros(size(x));
+    for start = 1:blockSize:length(x)
+        idx = start:min(start + blockSize - 1, length(x));
+        [y(idx), voice] = filter_block(x(idx), voice);
+    end
+
+    header = { ...
+        'kind', 'filter'; 'model', 'filter_block.m'; 'sampleRate', num2str(fs); ...
+        'type', filterCases{c, 1}; 'cutoff', num2str(filterCases{c, 2}); ...
+        'blockSize', num2str(blockSize); 'tolerance', '1e-05'};
+
+    if strcmp(filterCases{c, 1}, 'bandpass')
+        header(end + 1, :) = {'deviation', ['RCFilter uses one cutoff for both stages and b_hp = 1; ' ...
+            'bandpass.m uses separate low/high banks and filter_block.m resets xPrev_hp every block']};
+        header(end + 1, :) = {'deviationMaxError', '1.2'};
+        header(end + 1, :) = {'deviationRmsError', '0.5'};
+    end
+
+    write_reference(outDir, sprintf('filter_%s_%d', filterCases{c, 1}, filterCases{c, 2}), ...
+        header, [x' y']);
+end
+
+% -------------------------------
+% Wavetables: every bank, velocity 1
+% -------------------------------
+waves = {'sine', @sine; 'saw', @saw; 'square', @square; 'triangle', @triangle};
+
+for fs = [44100 48000]
+    for w = 1:size(waves, 1)
+        waveforms = waves{w, 2}(440, fs, 1);
+        close all; % saw.m dibuja el ciclo
+
+        rows = [];
+        for b = 1:length(waveforms)
+            bank = waveforms{b};
+            rows = [rows; (b - 1) * ones(length(bank), 1), bank(:)]; %#ok<AGROW>
+        end
+
+        header = { ...
+            'kind', 'wavetable'; 'model', [waves{w, 1} '.m']; 'sampleRate', num2str(fs); ...
+            'wave', waves{w, 1}; 'tolerance', '1e-05'};
+
+        if any(strcmp(waves{w, 1}, {'square', 'triangle'}))
+            header(end + 1, :) = {'deviation', ['Square and Triangle are differences of phase-offset ' ...
+                'saw / integrated-saw reads, band-limited to the saw''s harmonics (square.m/triangle.m ' ...
+                'go up to 2N-1) and interpolated at the offsets']};
+            % Gibbs ripple of the shorter series: up to a full step in the top banks
+            header(end + 1, :) = {'deviationMaxError', '1.05'};
+            if strcmp(waves{w, 1}, 'square')
+                header(end + 1, :) = {'deviationRmsError', '0.06'};
+            else
+                header(end + 1, :) = {'deviationRmsError', '0.012'};
+            end
+        end
+
+        write_reference(outDir, sprintf('wavetable_%s_%dk', waves{w, 1}, round(fs / 1000)), ...
+            header, rows);
+    end
+end
+
+fprintf('[%0.3f s] Reference vectors written to %s\n', toc, outDir);
+
+% ---------------------------------------------------------------
+function write_reference(outDir, name, header, data)
+% WRITE_REFERENCE - Writes one case in the format read by TECGoldenCheck
+fid = fopen(fullfile(outDir, [name '.ref']), 'w');
+fprintf(fid, '# TEC Synth golden reference, generated by export_reference.m\n');
+fprintf(fid, 'name %s\n', name);
+for k = 1:size(header, 1)
+    fprintf(fid, '%s %s\n', header{k, 1}, header{k, 2});
+end
+fprintf(fid, 'data %d\n', size(data, 2));
+fprintf(fid, [strjoin(repmat({'%.17g'}, 1, size(data, 2)), ' ') '\n'], data');
+fclose(fid);
+end
@@ -0,0 +1,129 @@
+#include "InverseFFT.h"
+#include <JuceHeader.h>
+#include <cmath>
+#include <utility>
+
+InverseFFT::InverseFFT(int order)
+    : maxOrder(order)
+{
+    jassert(maxOrder >= 2);
+
+    const int maxSize = 1 << maxOrder;
+    twiddleRe.resize(size_t(maxSize / 2));
+    twiddleIm.resize(size_t(maxSize / 2));
+    for (int j = 0; j < maxSize / 2; ++j)
+    {
+        const double angle = 2.0 * M_PI * double(j) / double(maxSize);
+        twiddleRe[size_t(j)] = float(std::cos(angle));
+        twiddleIm[size_t(j)] = float(std::sin(angle));
+    }
+
+    // Complex stages of length 4 … maxSize/2, each e^(+2πi·j/length) for j < length/2
+    for (int length = 4; length <= maxSize / 2; length <<= 1)
+    {
+        const int step = maxSize / length;
+        for (int j = 0; j < length / 2; ++j)
+        {
+            stageRe.push_back(twiddleRe[size_t(j * step)]);
+            stageIm.push_back(twiddleIm[size_t(j * step)]);
+        }
+    }
+
+    workRe.resize(size_t(maxSize / 2));
+    workIm.resize(size_t(maxSize / 2));
+}
+
+void InverseFFT::performReal(const float *re, const float *im, float *out, int order)
+{
+    jassert(order >= 2 && order <= maxOrder);
+
+    const int half = 1 << (order - 1);
+    const int stride = 1 << (maxOrder - order); // W^k = twiddle[k · stride]
+
+    // Z[k] = E[k] + i·O[k], with E = X[k] + conj(X[M-k]) (even samples) and
+    // O = (X[k] - conj(X[M-k])) · W^k (odd samples), M = N/2
+    for (int k = 0; k < half; ++k)
+    {
+        const int mirror = half - k;
+        const float eRe = re[k] + re[mirror];
+        const float eIm = im[k] - im[mirror];
+        const float dRe = re[k] - re[mirror];
+        const float dIm = im[k] + im[mirror];
+
+        const float wRe = twiddleRe[size_t(k * stride)];
+        const float wIm = twiddleIm[size_t(k * stride)];
+        const float oRe = dRe * wRe - dIm * wIm;
+        const float oIm = dRe * wIm + dIm * wRe;
+
+        workRe[size_t(k)] = eRe - oIm;
+        workIm[size_t(k)] = eIm + oRe;
+    }
+
+    performComplex(order - 1);
+
+    for (int m = 0; m < half; ++m)
+    {
+        out[2 * m] = workRe[size_t(m)];
+        out[2 * m + 1] = workIm[size_t(m)];
+    }
+}
+
+void InverseFFT::performComplex(int order)
+{
+    const int size = 1 << order;
+    float *xr = workRe.data();
+    float *xi = workIm.data();
+
+    // Bit-reversed order
+    for (int i = 1, j = 0; i < size; ++i)
+    {
+        int bit = size >> 1;
+        for (; (j & bit) != 0; bit >>= 1)
+            j ^= bit;
+        j |= bit;
+
+        if (i < j)
+        {
+            std::swap(xr[i], xr[j]);
+            std::swap(xi[i], xi[j]);
+        }
+    }
+
+    // Length-2 stage: twiddle 1
+    for (int a = 0; a < size; a += 2)
+    {
+        const float vRe = xr[a + 1];
+        const float vIm = xi[a + 1];
+        xr[a + 1] = xr[a] - vRe;
+        xi[a + 1] = xi[a] - vIm;
+        xr[a] += vRe;
+        xi[a] += vIm;
+    }
+
+    // Longer stages: the twiddles of each length are stored contiguously
+    // (stageRe/stageIm from index length/2 - 2), so the inner loop vectorizes
+    for (int length = 4; length <= size; length <<= 1)
+    {
+        const int halfLength = length >> 1;
+        const float *wRe = stageRe.data() + (halfLength - 2);
+        const float *wIm = stageIm.data() + (halfLength - 2);
+
+        for (int start = 0; start < size; start += length)
+        {
+            float *aRe = xr + start;
+            float *aIm = xi + start;
+            float *bRe = aRe + halfLength;
+            float *bIm = aIm + halfLength;
+
+            for (int j = 0; j < halfLength; ++j)
+            {
+                const float vRe = bRe[j] * wRe[j] - bIm[j] * wIm[j];
+                const float vIm = bRe[j] * wIm[j] + bIm[j] * wRe[j];
+                bRe[j] = aRe[j] - vRe;
+                bIm[j] = aIm[j] - vIm;
+                aRe[j] += vRe;
+                aIm[j] += vIm;
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class InverseFFT
+ * @brief Radix-2 inverse FFT of a real signal, for sizes up to 2^maxOrder.
+ *
+ * performReal() takes the non-negative half of a Hermitian spectrum and
+ * returns the real signal, unnormalized:
+ *
+ *     x[n] = sum over k = 0 … N-1 of X[k] · e^(+2πi·kn/N)
+ *
+ * The N-point real transform runs as one N/2-point complex transform (even
+ * samples in the real part, odd samples in the imaginary part), so it costs
+ * about half of a complex transform of the same size.
+ *
+ * The constructor allocates; performReal() does not (audio thread).
+ */
+class InverseFFT
+{
+public:
+    /** @param maxOrder log2 of the largest real size (at least 2). */
+    explicit InverseFFT(int maxOrder);
+
+    /** @brief log2 of the largest real size. */
+    int getMaxOrder() const { return maxOrder; }
+
+    /**
+     * @brief Real signal from half of its spectrum.
+     * @param re Real part of bins 0 … N/2 (N/2 + 1 values).
+     * @param im Imaginary part of bins 0 … N/2 (N/2 + 1 values).
+     * @param out N = 2^order samples.
+     * @param order log2 of N, 2 … getMaxOrder().
+     */
+    void performReal(const float *re, const float *im, float *out, int order);
+
+    /** @brief Bytes of the twiddle table and the work buffers. */
+    size_t getMemoryBytes() const noexcept
+    {
+        return (twiddleRe.capacity() + twiddleIm.capacity() + stageRe.capacity() + stageIm.capacity() +
+                workRe.capacity() + workIm.capacity()) *
+               sizeof(float);
+    }
+
+private:
+    /** @brief In-place complex inverse transform of workRe/workIm, 2^order points. */
+    void performComplex(int order);
+
+    int maxOrder;
+
+    /** @brief e^(+2πi·j/maxSize) for j < maxSize/2, shared by every smaller size. */
+    std::vector<float> twiddleRe, twiddleIm;
+
+    /** @brief The same twiddles regrouped per stage length, contiguous for the butterflies. */
+    std::vector<float> stageRe, stageIm;
+
+    std::vector<float> workRe, workIm;
+};
@@ -0,0 +1,141 @@
+#include "KernelDispatch.h"
+#include <JuceHeader.h>
+
+// Defined in KernelsXXX.cpp; nullptr when the ISA is not compiled in
+const DspKernels *getKernelsScalar() noexcept;
+const DspKernels *getKernelsSSE2() noexcept;
+const DspKernels *getKernelsAVX2() noexcept;
+const DspKernels *getKernelsAVX512() noexcept;
+const DspKernels *getKernelsNEON() noexcept;
+
+namespace
+{
+    bool cpuSupports(KernelIsa isa) noexcept
+    {
+        switch (isa)
+        {
+        case KernelIsa::Scalar:
+            return true;
+        case KernelIsa::SSE2:
+            return juce::SystemStats::hasSSE2();
+        case KernelIsa::AVX2:
+            return juce::SystemStats::hasAVX2();
+        case KernelIsa::AVX512:
+            return juce::SystemStats::hasAVX512F();
+        case KernelIsa::NEON:
+            return juce::SystemStats::hasNeon();
+        }
+        return false;
+    }
+
+    const DspKernels *compiledKernels(KernelIsa isa) noexcept
+    {
+        switch (isa)
+        {
+        case KernelIsa::Scalar:
+            return getKernelsScalar();
+        case KernelIsa::SSE2:
+            return getKernelsSSE2();
+        case KernelIsa::AVX2:
+            return getKernelsAVX2();
+        case KernelIsa::AVX512:
+            return getKernelsAVX512();
+        case KernelIsa::NEON:
+            return getKernelsNEON();
+        }
+        return nullptr;
+    }
+
+    const DspKernels *selectAtStartup() noexcept
+    {
+        KernelIsa isa = KernelDispatch::detectBestIsa();
+
+        const auto forced = juce::SystemStats::getEnvironmentVariable("TEC_FORCE_ISA", {});
+        KernelIsa requested;
+        if (forced.isNotEmpty() && KernelDispatch::parseIsaName(forced.toRawUTF8(), requested))
+        {
+            if (KernelDispatch::getFor(requested) != nullptr)
+            {
+                isa = requested;
+            }
+            else
+            {
+                DBG("TEC_FORCE_ISA=" << forced << " is not available on this machine, using "
+                                     << KernelDispatch::getIsaName(isa));
+            }
+        }
+
+        return KernelDispatch::getFor(isa);
+    }
+}
+
+std::atomic<const DspKernels *> &KernelDispatch::activeKernels() noexcept
+{
+    static std::atomic<const DspKernels *> active{selectAtStartup()};
+    return active;
+}
+
+const DspKernels &KernelDispatch::get() noexcept
+{
+    return *activeKernels().load(std::memory_order_relaxed);
+}
+
+const DspKernels *KernelDispatch::getFor(KernelIsa isa) noexcept
+{
+    return cpuSupports(isa) ? compiledKernels(isa) : nullptr;
+}
+
+KernelIsa KernelDispatch::detectBestIsa() noexcept
+{
+    for (auto isa : {KernelIsa::AVX512, KernelIsa::AVX2, KernelIsa::NEON, KernelIsa::SSE2})
+        if (getFor(isa) != nullptr)
+            return isa;
+
+    return KernelIsa::Scalar;
+}
+
+bool KernelDispatch::force(KernelIsa isa) noexcept
+{
+    auto *kernels = getFor(isa);
+    if (kernels == nullptr)
+        return false;
+
+    activeKernels().store(kernels, std::memory_order_relaxed);
+    return true;
+}
+
+void KernelDispatch::restoreDefault() noexcept
+{
+    activeKernels().store(getFor(detectBestIsa()), std::memory_order_relaxed);
+}
+
+const char *KernelDispatch::getIsaName(KernelIsa isa) noexcept
+{
+    switch (isa)
+    {
+    case KernelIsa::Scalar:
+        return "scalar";
+    case KernelIsa::SSE2:
+        return "sse2";
+    case KernelIsa::AVX2:
+        return "avx2";
+    case KernelIsa::AVX512:
+        return "avx512";
+    case KernelIsa::NEON:
+        return "neon";
+    }
+    return "unknown";
+}
+
+bool KernelDispatch::parseIsaName(const char *text, KernelIsa &result)
+{
+    for (auto isa : {KernelIsa::Scalar, KernelIsa::SSE2, KernelIsa::AVX2, KernelIsa::AVX512, KernelIsa::NEON})
+    {
+        if (juce::String(text).trim().equalsIgnoreCase(getIsaName(isa)))
+        {
+            result = isa;
+            return true;
+        }
+    }
+    return false;
+}
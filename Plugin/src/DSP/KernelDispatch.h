@@ -0,0 +1,211 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Instruction set a DspKernels table was compiled for.
+ */
+enum class KernelIsa
+{
+    Scalar, ///< Portable C++, auto-vectorization disabled (reference).
+    SSE2,   ///< x86-64 baseline.
+    AVX2,   ///< x86-64 with AVX2 (Haswell and later).
+    AVX512, ///< x86-64 with AVX-512F (Skylake-SP and later).
+    NEON    ///< ARMv8 baseline (Apple Silicon, arm64 Windows/Linux).
+};
+
+/**
+ * @struct DspKernels
+ * @brief Block-processing kernels used by the voice render loop, for one ISA.
+ *
+ * Every ISA-specific table is built from the same source (DSP/KernelsImpl.h)
+ * compiled with different target flags, with floating-point contraction
+ * disabled, so all tables produce bit-identical output; they only differ in
+ * speed. All kernels are stateless and real-time safe.
+ */
+struct DspKernels
+{
+    KernelIsa isa;
+    const char *name;
+
+    /**
+     * @brief Reads numSamples from a single-cycle wavetable.
+     * @param table Table samples.
+     * @param tableSize Number of samples in the table.
+     * @param phase Start phase in [0, 1).
+     * @param phaseDelta Phase increment per sample (>= 0).
+     * @param amplitude Output gain.
+     * @param interpolate Linear interpolation when true, drop-sample read otherwise.
+     * @param out Destination, overwritten.
+     * @param numSamples Number of samples.
+     * @return Phase after the last sample, wrapped to [0, 1).
+     */
+    double (*renderWavetable)(const float *table, int tableSize, double phase, double phaseDelta,
+                              float amplitude, bool interpolate, float *out, int numSamples);
+
+    /**
+     * @brief renderWavetable() for an IEEE half-precision table.
+     *
+     * The table must hold tableSize + 1 elements (one guard element).
+     */
+    double (*renderWavetableF16)(const uint16_t *table, int tableSize, double phase, double phaseDelta,
+                                 float amplitude, bool interpolate, float *out, int numSamples);
+
+    /**
+     * @brief renderWavetable() for a normalized int16 table; sample = table[i] * scale.
+     *
+     * The table must hold tableSize + 1 elements (one guard element).
+     */
+    double (*renderWavetableI16)(const int16_t *table, int tableSize, float scale, double phase,
+                                 double phaseDelta, float amplitude, bool interpolate, float *out,
+                                 int numSamples);
+
+    /**
+     * @brief renderWavetable() with a per-sample phase increment.
+     * @param ratio numSamples multipliers; sample i advances by phaseDelta * ratio[i].
+     *
+     * Used for pitch bend, glide and vibrato. The phase is accumulated, so
+     * this loop is serial; the caller keeps the bank fixed over the call.
+     */
+    double (*renderWavetableModulated)(const float *table, int tableSize, double phase, double phaseDelta,
+                                       const float *ratio, float amplitude, bool interpolate, float *out,
+                                       int numSamples);
+
+    /** @brief renderWavetableModulated() for a half-precision table (with guard element). */
+    double (*renderWavetableModulatedF16)(const uint16_t *table, int tableSize, double phase, double phaseDelta,
+                                          const float *ratio, float amplitude, bool interpolate, float *out,
+                                          int numSamples);
+
+    /** @brief renderWavetableModulated() for a normalized int16 table (with guard element). */
+    double (*renderWavetableModulatedI16)(const int16_t *table, int tableSize, float scale, double phase,
+                                          double phaseDelta, const float *ratio, float amplitude,
+                                          bool interpolate, float *out, int numSamples);
+
+    /**
+     * @brief Reads a single-cycle table at a phase offset per sample (phase modulation / FM operator).
+     * @param ratio numSamples pitch multipliers, or nullptr (see renderWavetableModulated()).
+     * @param modulation numSamples phase offsets in cycles (any sign or size), or nullptr.
+     * @param feedback Self-modulation in cycles per unit of output; 0 disables it.
+     * @param feedbackState The last two table reads (before amplitude); updated when feedback != 0.
+     * @return Phase after the last sample, wrapped to [0, 1); modulation does not move it.
+     *
+     * Always interpolates. Without ratio and feedback, samples are independent
+     * and the loop vectorizes; feedback makes it a serial chain.
+     */
+    double (*renderPhaseModulated)(const float *table, int tableSize, double phase, double phaseDelta,
+                                   const float *ratio, const float *modulation, float amplitude,
+                                   float feedback, float *feedbackState, float *out, int numSamples);
+
+    /** @brief renderPhaseModulated() for a half-precision table (with guard element). */
+    double (*renderPhaseModulatedF16)(const uint16_t *table, int tableSize, double phase, double phaseDelta,
+                                      const float *ratio, const float *modulation, float amplitude,
+                                      float feedback, float *feedbackState, float *out, int numSamples);
+
+    /** @brief renderPhaseModulated() for a normalized int16 table (with guard element). */
+    double (*renderPhaseModulatedI16)(const int16_t *table, int tableSize, float scale, double phase,
+                                      double phaseDelta, const float *ratio, const float *modulation,
+                                      float amplitude, float feedback, float *feedbackState, float *out,
+                                      int numSamples);
+
+    /** @brief Lanes renderPartials() sums in; numPartials must be a multiple of it. */
+    static constexpr int partialLanes = 16;
+
+    /**
+     * @brief Sums a bank of sine partials, each a phasor rotated once per sample (additive synthesis).
+     * @param re Cosine of each partial's phase; advanced by numSamples.
+     * @param im Sine of each partial's phase (the output); advanced by numSamples.
+     * @param cosStep Per-sample rotation of each partial, cosine.
+     * @param sinStep Per-sample rotation of each partial, sine.
+     * @param amplitude Amplitude of each partial at ramp position 0.
+     * @param amplitudeStep Change of each amplitude per sample.
+     * @param rampPosition Ramp position of the first sample (sample i uses rampPosition + i).
+     * @param numPartials Multiple of partialLanes; pad with zero amplitudes.
+     * @param out Destination, overwritten.
+     * @param numSamples Number of samples.
+     *
+     * Partials are independent, so they run across the vector lanes. Each
+     * output sample is summed in partialLanes interleaved lanes and then in
+     * a fixed tree, so the sum order does not depend on the vector width.
+     */
+    void (*renderPartials)(float *re, float *im, const float *cosStep, const float *sinStep,
+                           const float *amplitude, const float *amplitudeStep, int rampPosition,
+                           int numPartials, float *out, int numSamples);
+
+    /** @brief buffer[i] *= start + step * i (one linear envelope segment). */
+    void (*multiplyByRamp)(float *buffer, int numSamples, float start, float step);
+
+    /** @brief One-pole lowpass in place: y = b * x + a * y[-1]. Updates *state. */
+    void (*onePoleLowpass)(float *buffer, int numSamples, float b, float a, float *state);
+
+    /** @brief One-pole highpass in place: y = alpha * (y[-1] + x - x[-1]). Updates *state, *xPrev. */
+    void (*onePoleHighpass)(float *buffer, int numSamples, float alpha, float *state, float *xPrev);
+
+    /** @brief RC bandpass in place (highpass stage into lowpass stage), as in RCFilter. */
+    void (*rcBandpass)(float *buffer, int numSamples, float aHp, float bLp, float aLp,
+                       float *stateHp, float *xPrevHp, float *stateLp);
+
+    /**
+     * @brief multiplyByRamp() followed by onePoleLowpass(), fused into one pass.
+     *
+     * Same per-sample operations, so the output is identical to the two calls.
+     * The fused kernels are specialized at compile time for constant
+     * segments (step == 0, e.g. Sustain) and for ramps.
+     */
+    void (*rampLowpass)(float *buffer, int numSamples, float start, float step, float b, float a, float *state);
+
+    /** @brief multiplyByRamp() followed by onePoleHighpass(), fused into one pass. */
+    void (*rampHighpass)(float *buffer, int numSamples, float start, float step, float alpha,
+                         float *state, float *xPrev);
+
+    /** @brief multiplyByRamp() followed by rcBandpass(), fused into one pass. */
+    void (*rampBandpass)(float *buffer, int numSamples, float start, float step, float aHp, float bLp,
+                         float aLp, float *stateHp, float *xPrevHp, float *stateLp);
+
+    /** @brief dest[i] += source[i]. */
+    void (*mixInto)(float *dest, const float *source, int numSamples);
+};
+
+/**
+ * @class KernelDispatch
+ * @brief Picks the fastest DspKernels table the running CPU supports.
+ *
+ * The selection happens once, the first time get() is called (the processor
+ * does this in its constructor). It can be forced for testing and A/B
+ * comparisons, either with the TEC_FORCE_ISA environment variable
+ * (scalar, sse2, avx2, avx512, neon) read at selection time, or at runtime
+ * with force(). Tables not compiled into this binary or not supported by
+ * the CPU are never selected.
+ */
+class KernelDispatch
+{
+public:
+    /** @brief Kernels in use. Lock-free; callable from the audio thread. */
+    static const DspKernels &get() noexcept;
+
+    /**
+     * @brief Returns the table for an ISA.
+     * @return nullptr if it was not compiled in or the CPU lacks the instructions.
+     */
+    static const DspKernels *getFor(KernelIsa isa) noexcept;
+
+    /** @brief Best ISA supported by both the binary and the CPU. */
+    static KernelIsa detectBestIsa() noexcept;
+
+    /**
+     * @brief Switches every voice to the kernels of another ISA.
+     * @return False (and no change) if that ISA is unavailable.
+     */
+    static bool force(KernelIsa isa) noexcept;
+
+    /** @brief Drops a forced selection and returns to detectBestIsa(). */
+    static void restoreDefault() noexcept;
+
+    /** @brief Lower-case name as accepted by TEC_FORCE_ISA. */
+    static const char *getIsaName(KernelIsa isa) noexcept;
+
+    /** @brief Parses a TEC_FORCE_ISA value; returns false if unknown. */
+    static bool parseIsaName(const char *text, KernelIsa &result);
+
+private:
+    static std::atomic<const DspKernels *> &activeKernels() noexcept;
+};
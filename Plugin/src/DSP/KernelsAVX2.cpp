@@ -0,0 +1,17 @@
+#include "KernelDispatch.h"
+
+// Compiled with -mavx2 (/arch:AVX2); empty on non-x86 targets and slices.
+#if defined(__AVX2__)
+#include "KernelsImpl.h"
+
+const DspKernels *getKernelsAVX2() noexcept
+{
+    static constexpr DspKernels kernels = makeKernels(KernelIsa::AVX2, "AVX2");
+    return &kernels;
+}
+#else
+const DspKernels *getKernelsAVX2() noexcept
+{
+    return nullptr;
+}
+#endif
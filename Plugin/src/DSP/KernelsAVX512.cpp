@@ -0,0 +1,17 @@
+#include "KernelDispatch.h"
+
+// Compiled with -mavx512f (/arch:AVX512); empty on non-x86 targets and slices.
+#if defined(__AVX512F__)
+#include "KernelsImpl.h"
+
+const DspKernels *getKernelsAVX512() noexcept
+{
+    static constexpr DspKernels kernels = makeKernels(KernelIsa::AVX512, "AVX512");
+    return &kernels;
+}
+#else
+const DspKernels *getKernelsAVX512() noexcept
+{
+    return nullptr;
+}
+#endif
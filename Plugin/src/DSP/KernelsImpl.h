@@ -0,0 +1,577 @@
+// Kernel bodies shared by every KernelsXXX.cpp. Each of those files includes
+// this header once, compiled with its own target flags (see CMakeLists.txt),
+// and exposes the resulting table through makeKernels().
+//
+// Rules for this file:
+//  - Everything has internal linkage (anonymous namespace), so the AVX
+//    versions can never be merged by the linker into a baseline caller.
+//  - No calls into inline library code (std::min, std::floor, ...): an
+//    out-of-line copy instantiated here with AVX encoding could be picked by
+//    the linker for the rest of the program. Plain arithmetic only.
+//  - Same operation order as the scalar per-sample code it replaces, and no
+//    FMA contraction (-ffp-contract=off), so every ISA is bit-identical.
+
+#include "KernelDispatch.h"
+#include <cstdint>
+#include <cstring>
+
+// AVX2 builds also get F16C (every AVX2 CPU has it; see CMakeLists.txt)
+#if defined(__AVX2__) && (defined(__F16C__) || defined(_MSC_VER))
+#define TEC_KERNELS_AVX2 1
+#include <immintrin.h>
+#else
+#define TEC_KERNELS_AVX2 0
+#endif
+
+namespace
+{
+    // Table sample loaders: widen one stored sample to float. The compact
+    // formats decode exactly (half -> float is lossless), so only the table
+    // contents differ between formats, never the arithmetic.
+    struct LoadFloat32
+    {
+        const float *table;
+        float operator()(int32_t i) const { return table[i]; }
+    };
+
+    struct LoadFloat16
+    {
+        const uint16_t *table;
+        float operator()(int32_t i) const
+        {
+            // IEEE 754 binary16 -> binary32, including subnormals and inf/NaN
+            const uint32_t h = table[i];
+            const uint32_t sign = (h & 0x8000u) << 16;
+            const uint32_t exponent = (h >> 10) & 0x1Fu;
+            const uint32_t mantissa = h & 0x3FFu;
+
+            uint32_t bits;
+            if (exponent == 0x1Fu)
+                bits = sign | 0x7F800000u | (mantissa << 13);
+            else if (exponent != 0)
+                bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+            else if (mantissa == 0)
+                bits = sign;
+            else
+            {
+                // Subnormal: value = mantissa * 2^-24, exact in float
+                const float magnitude = float(mantissa) * (1.0f / 16777216.0f);
+                return sign != 0 ? -magnitude : magnitude;
+            }
+
+            float f;
+            std::memcpy(&f, &bits, sizeof(f));
+            return f;
+        }
+    };
+
+    struct LoadInt16
+    {
+        const int16_t *table;
+        float scale;
+        float operator()(int32_t i) const { return float(table[i]) * scale; }
+    };
+
+#if TEC_KERNELS_AVX2
+    // Four samples per step with the same double-precision phase math as the
+    // scalar loop below, then a gather for both table taps. Compilers do not
+    // vectorize the scalar version (gathers are off in generic tuning).
+    // Compact tables are gathered as 32-bit words at 16-bit offsets and
+    // widened in registers; they carry one guard element so the last word
+    // read stays inside the allocation.
+    inline __m128 gatherTaps(const LoadFloat32 &load, __m128i idx)
+    {
+        return _mm_i32gather_ps(load.table, idx, 4);
+    }
+
+    inline __m128 gatherTaps(const LoadFloat16 &load, __m128i idx)
+    {
+        const __m128i words = _mm_i32gather_epi32(reinterpret_cast<const int *>(load.table), idx, 2);
+        const __m128i halves = _mm_and_si128(words, _mm_set1_epi32(0xFFFF));
+        return _mm_cvtph_ps(_mm_packus_epi32(halves, halves));
+    }
+
+    inline __m128 gatherTaps(const LoadInt16 &load, __m128i idx)
+    {
+        const __m128i words = _mm_i32gather_epi32(reinterpret_cast<const int *>(load.table), idx, 2);
+        const __m128i values = _mm_srai_epi32(_mm_slli_epi32(words, 16), 16);
+        return _mm_mul_ps(_mm_cvtepi32_ps(values), _mm_set1_ps(load.scale));
+    }
+
+    template <typename Loader>
+    int renderTableAvx2(const Loader &load, int tableSize, double phase, double phaseDelta,
+                        float amplitude, float *out, int numSamples)
+    {
+        const __m256d size = _mm256_set1_pd(double(tableSize));
+        const __m256d delta = _mm256_set1_pd(phaseDelta);
+        const __m256d start = _mm256_set1_pd(phase);
+        const __m128i limit = _mm_set1_epi32(tableSize);
+        const __m128i one = _mm_set1_epi32(1);
+        const __m128 ones = _mm_set1_ps(1.0f);
+        const __m128 gain = _mm_set1_ps(amplitude);
+
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const __m256d n = _mm256_cvtepi32_pd(_mm_add_epi32(_mm_set1_epi32(i), _mm_setr_epi32(0, 1, 2, 3)));
+            __m256d p = _mm256_add_pd(start, _mm256_mul_pd(delta, n));
+            p = _mm256_sub_pd(p, _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(p)));
+
+            // Fraction from the unwrapped index, then the wrap (see readTableAt())
+            const __m256d position = _mm256_mul_pd(p, size);
+            const __m128i whole = _mm256_cvttpd_epi32(position);
+            const __m128 frac = _mm256_cvtpd_ps(_mm256_sub_pd(position, _mm256_cvtepi32_pd(whole)));
+            const __m128i idx0 = _mm_and_si128(whole, _mm_cmplt_epi32(whole, limit));
+            const __m128i next = _mm_add_epi32(idx0, one);
+            const __m128i idx1 = _mm_and_si128(next, _mm_cmplt_epi32(next, limit));
+
+            const __m128 t0 = gatherTaps(load, idx0);
+            const __m128 t1 = gatherTaps(load, idx1);
+            const __m128 y = _mm_add_ps(_mm_mul_ps(t0, _mm_sub_ps(ones, frac)), _mm_mul_ps(t1, frac));
+            _mm_storeu_ps(out + i, _mm_mul_ps(y, gain));
+        }
+        return i;
+    }
+#endif
+
+    template <typename Loader>
+    double renderTable(const Loader &load, int tableSize, double phase, double phaseDelta,
+                       float amplitude, bool interpolate, float *out, int numSamples)
+    {
+        const double size = double(tableSize);
+
+        // Phase of each sample is computed from the block start, not accumulated,
+        // so iterations are independent and the loop vectorizes (gathers on AVX2+).
+        // Index wrap is done with arithmetic instead of branches for the same reason.
+        if (interpolate)
+        {
+            int i = 0;
+#if TEC_KERNELS_AVX2
+            i = renderTableAvx2(load, tableSize, phase, phaseDelta, amplitude, out, numSamples);
+#endif
+            for (; i < numSamples; ++i)
+            {
+                double p = phase + phaseDelta * double(i);
+                p -= double(int32_t(p));
+
+                // p * size can round up to size: fraction first, then the wrap
+                const double position = p * size;
+                const int32_t whole = int32_t(position);
+                const float frac = float(position - double(whole));
+                const int32_t idx0 = whole * int32_t(whole < tableSize);
+                const int32_t next = idx0 + 1;
+                const int32_t idx1 = next * int32_t(next < tableSize);
+
+                out[i] = (load(idx0) * (1.0f - frac) + load(idx1) * frac) * amplitude;
+            }
+        }
+        else
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                double p = phase + phaseDelta * double(i);
+                p -= double(int32_t(p));
+
+                int32_t idx0 = int32_t(p * size);
+                idx0 *= int32_t(idx0 < tableSize);
+
+                out[i] = load(idx0) * amplitude;
+            }
+        }
+
+        double end = phase + phaseDelta * double(numSamples);
+        return end - double(int32_t(end));
+    }
+
+    double renderWavetable(const float *table, int tableSize, double phase, double phaseDelta,
+                           float amplitude, bool interpolate, float *out, int numSamples)
+    {
+        return renderTable(LoadFloat32{table}, tableSize, phase, phaseDelta, amplitude, interpolate, out, numSamples);
+    }
+
+    double renderWavetableF16(const uint16_t *table, int tableSize, double phase, double phaseDelta,
+                              float amplitude, bool interpolate, float *out, int numSamples)
+    {
+        return renderTable(LoadFloat16{table}, tableSize, phase, phaseDelta, amplitude, interpolate, out, numSamples);
+    }
+
+    double renderWavetableI16(const int16_t *table, int tableSize, float scale, double phase, double phaseDelta,
+                              float amplitude, bool interpolate, float *out, int numSamples)
+    {
+        return renderTable(LoadInt16{table, scale}, tableSize, phase, phaseDelta, amplitude, interpolate, out, numSamples);
+    }
+
+    // Pitch-modulated read: the increment changes every sample, so the phase
+    // is accumulated (a serial chain) instead of computed from the block start.
+    template <typename Loader>
+    double renderTableModulated(const Loader &load, int tableSize, double phase, double phaseDelta,
+                                const float *ratio, float amplitude, bool interpolate, float *out,
+                                int numSamples)
+    {
+        const double size = double(tableSize);
+        double p = phase;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double position = p * size;
+            const int32_t whole = int32_t(position);
+            const int32_t idx0 = whole * int32_t(whole < tableSize);
+
+            if (interpolate)
+            {
+                // Fraction from the unwrapped index (see readTableAt())
+                const float frac = float(position - double(whole));
+                const int32_t next = idx0 + 1;
+                const int32_t idx1 = next * int32_t(next < tableSize);
+                out[i] = (load(idx0) * (1.0f - frac) + load(idx1) * frac) * amplitude;
+            }
+            else
+            {
+                out[i] = load(idx0) * amplitude;
+            }
+
+            p += phaseDelta * double(ratio[i]);
+            p -= double(int32_t(p));
+        }
+        return p;
+    }
+
+    double renderWavetableModulated(const float *table, int tableSize, double phase, double phaseDelta,
+                                    const float *ratio, float amplitude, bool interpolate, float *out,
+                                    int numSamples)
+    {
+        return renderTableModulated(LoadFloat32{table}, tableSize, phase, phaseDelta, ratio, amplitude,
+                                    interpolate, out, numSamples);
+    }
+
+    double renderWavetableModulatedF16(const uint16_t *table, int tableSize, double phase, double phaseDelta,
+                                       const float *ratio, float amplitude, bool interpolate, float *out,
+                                       int numSamples)
+    {
+        return renderTableModulated(LoadFloat16{table}, tableSize, phase, phaseDelta, ratio, amplitude,
+                                    interpolate, out, numSamples);
+    }
+
+    double renderWavetableModulatedI16(const int16_t *table, int tableSize, float scale, double phase,
+                                       double phaseDelta, const float *ratio, float amplitude,
+                                       bool interpolate, float *out, int numSamples)
+    {
+        return renderTableModulated(LoadInt16{table, scale}, tableSize, phase, phaseDelta, ratio, amplitude,
+                                    interpolate, out, numSamples);
+    }
+
+    // Interpolated read at any phase, negative or beyond one cycle. The
+    // fraction is taken before the index wrap, so a phase that rounds up to
+    // the table size reads table[0] with fraction 0.
+    template <typename Loader>
+    inline float readTableAt(const Loader &load, int32_t tableSize, double size, double p)
+    {
+        p -= double(int32_t(p));
+        p += double(p < 0.0); // truncation leaves negative phases in (-1, 0)
+
+        const double position = p * size;
+        const int32_t whole = int32_t(position);
+        const float frac = float(position - double(whole));
+        const int32_t idx0 = whole * int32_t(whole < tableSize);
+        const int32_t next = idx0 + 1;
+        const int32_t idx1 = next * int32_t(next < tableSize);
+        return load(idx0) * (1.0f - frac) + load(idx1) * frac;
+    }
+
+    // Phase-modulated read (one FM operator). With a fixed pitch and no
+    // feedback each sample only depends on its own modulation input, so the
+    // phase comes from the block start as in renderTable(); pitch modulation
+    // and feedback accumulate sample by sample.
+    template <typename Loader>
+    double renderTablePhaseModulated(const Loader &load, int tableSize, double phase, double phaseDelta,
+                                     const float *ratio, const float *modulation, float amplitude,
+                                     float feedback, float *feedbackState, float *out, int numSamples)
+    {
+        const double size = double(tableSize);
+
+        if (ratio == nullptr && feedback == 0.0f)
+        {
+            if (modulation != nullptr)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    out[i] = readTableAt(load, tableSize, size, phase + phaseDelta * double(i) + double(modulation[i])) *
+                             amplitude;
+            }
+            else
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    out[i] = readTableAt(load, tableSize, size, phase + phaseDelta * double(i)) * amplitude;
+            }
+
+            double end = phase + phaseDelta * double(numSamples);
+            return end - double(int32_t(end));
+        }
+
+        // Feedback input is the mean of the last two reads (damps the
+        // period-two oscillation of a plain one-sample loop)
+        float y1 = feedbackState[0];
+        float y2 = feedbackState[1];
+        double p = phase;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            double q = p + double(feedback * (0.5f * (y1 + y2)));
+            if (modulation != nullptr)
+                q += double(modulation[i]);
+
+            const float y = readTableAt(load, tableSize, size, q);
+            y2 = y1;
+            y1 = y;
+            out[i] = y * amplitude;
+
+            p += ratio != nullptr ? phaseDelta * double(ratio[i]) : phaseDelta;
+            p -= double(int32_t(p));
+        }
+
+        feedbackState[0] = y1;
+        feedbackState[1] = y2;
+        return p;
+    }
+
+    double renderPhaseModulated(const float *table, int tableSize, double phase, double phaseDelta,
+                                const float *ratio, const float *modulation, float amplitude,
+                                float feedback, float *feedbackState, float *out, int numSamples)
+    {
+        return renderTablePhaseModulated(LoadFloat32{table}, tableSize, phase, phaseDelta, ratio, modulation,
+                                         amplitude, feedback, feedbackState, out, numSamples);
+    }
+
+    double renderPhaseModulatedF16(const uint16_t *table, int tableSize, double phase, double phaseDelta,
+                                   const float *ratio, const float *modulation, float amplitude,
+                                   float feedback, float *feedbackState, float *out, int numSamples)
+    {
+        return renderTablePhaseModulated(LoadFloat16{table}, tableSize, phase, phaseDelta, ratio, modulation,
+                                         amplitude, feedback, feedbackState, out, numSamples);
+    }
+
+    double renderPhaseModulatedI16(const int16_t *table, int tableSize, float scale, double phase,
+                                   double phaseDelta, const float *ratio, const float *modulation,
+                                   float amplitude, float feedback, float *feedbackState, float *out,
+                                   int numSamples)
+    {
+        return renderTablePhaseModulated(LoadInt16{table, scale}, tableSize, phase, phaseDelta, ratio, modulation,
+                                         amplitude, feedback, feedbackState, out, numSamples);
+    }
+
+    // Additive partial bank. Partial-major over short runs of samples: one
+    // group of lanes keeps its phasors in registers for the whole run and
+    // adds into the run's lane sums, which stay in a small local array.
+    // Sixteen lanes give every ISA enough independent rotations to hide the
+    // latency of the per-sample chain (one AVX-512 or two AVX2 registers).
+    void renderPartials(float *re, float *im, const float *cosStep, const float *sinStep,
+                        const float *amplitude, const float *amplitudeStep, int rampPosition,
+                        int numPartials, float *out, int numSamples)
+    {
+        constexpr int lanes = DspKernels::partialLanes;
+        constexpr int runLength = 64;
+        float sums[runLength][lanes];
+
+        for (int first = 0; first < numSamples; first += runLength)
+        {
+            const int count = numSamples - first < runLength ? numSamples - first : runLength;
+
+            for (int i = 0; i < count; ++i)
+                for (int l = 0; l < lanes; ++l)
+                    sums[i][l] = 0.0f;
+
+            for (int p = 0; p < numPartials; p += lanes)
+            {
+                float c[lanes], s[lanes], rc[lanes], rs[lanes], a[lanes], da[lanes];
+                for (int l = 0; l < lanes; ++l)
+                {
+                    c[l] = re[p + l];
+                    s[l] = im[p + l];
+                    rc[l] = cosStep[p + l];
+                    rs[l] = sinStep[p + l];
+                    a[l] = amplitude[p + l];
+                    da[l] = amplitudeStep[p + l];
+                }
+
+                for (int i = 0; i < count; ++i)
+                {
+                    const float position = float(rampPosition + first + i);
+                    for (int l = 0; l < lanes; ++l)
+                    {
+                        sums[i][l] += (a[l] + da[l] * position) * s[l];
+                        const float nextC = c[l] * rc[l] - s[l] * rs[l];
+                        s[l] = c[l] * rs[l] + s[l] * rc[l];
+                        c[l] = nextC;
+                    }
+                }
+
+                for (int l = 0; l < lanes; ++l)
+                {
+                    re[p + l] = c[l];
+                    im[p + l] = s[l];
+                }
+            }
+
+            for (int i = 0; i < count; ++i)
+            {
+                const float *x = sums[i];
+                out[first + i] = (((x[0] + x[1]) + (x[2] + x[3])) + ((x[4] + x[5]) + (x[6] + x[7]))) +
+                                 (((x[8] + x[9]) + (x[10] + x[11])) + ((x[12] + x[13]) + (x[14] + x[15])));
+            }
+        }
+    }
+
+    void multiplyByRamp(float *buffer, int numSamples, float start, float step)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            buffer[i] *= start + step * float(i);
+    }
+
+    // The IIR stages are a serial dependency chain: wider ISAs cannot split a
+    // single voice, they only save the per-sample dispatch of the old code.
+    void onePoleLowpass(float *buffer, int numSamples, float b, float a, float *state)
+    {
+        float y = *state;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            y = b * buffer[i] + a * y;
+            buffer[i] = y;
+        }
+        *state = y;
+    }
+
+    void onePoleHighpass(float *buffer, int numSamples, float alpha, float *state, float *xPrev)
+    {
+        float y = *state;
+        float x1 = *xPrev;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = buffer[i];
+            y = alpha * (y + x - x1);
+            x1 = x;
+            buffer[i] = y;
+        }
+        *state = y;
+        *xPrev = x1;
+    }
+
+    void rcBandpass(float *buffer, int numSamples, float aHp, float bLp, float aLp,
+                    float *stateHp, float *xPrevHp, float *stateLp)
+    {
+        float yHp = *stateHp;
+        float x1 = *xPrevHp;
+        float yLp = *stateLp;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = buffer[i];
+            yHp = (x - x1) + aHp * yHp;
+            x1 = x;
+            yLp = bLp * yHp + aLp * yLp;
+            buffer[i] = yLp;
+        }
+        *stateHp = yHp;
+        *xPrevHp = x1;
+        *stateLp = yLp;
+    }
+
+    // Envelope segment and filter in one pass: one load and one store per
+    // sample instead of two, and no second walk over the block. Each fused
+    // loop is instantiated for constant segments (Constant = true: the gain
+    // is start, and start + 0 * i == start, so both give the same result) and
+    // for ramps, and one instance is picked per segment.
+    template <bool Constant>
+    inline float segmentGain(float start, float step, int i)
+    {
+        return Constant ? start : start + step * float(i);
+    }
+
+    template <bool Constant>
+    void rampLowpassImpl(float *buffer, int numSamples, float start, float step, float b, float a, float *state)
+    {
+        float y = *state;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = buffer[i] * segmentGain<Constant>(start, step, i);
+            y = b * x + a * y;
+            buffer[i] = y;
+        }
+        *state = y;
+    }
+
+    template <bool Constant>
+    void rampHighpassImpl(float *buffer, int numSamples, float start, float step, float alpha,
+                          float *state, float *xPrev)
+    {
+        float y = *state;
+        float x1 = *xPrev;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = buffer[i] * segmentGain<Constant>(start, step, i);
+            y = alpha * (y + x - x1);
+            x1 = x;
+            buffer[i] = y;
+        }
+        *state = y;
+        *xPrev = x1;
+    }
+
+    template <bool Constant>
+    void rampBandpassImpl(float *buffer, int numSamples, float start, float step, float aHp, float bLp,
+                          float aLp, float *stateHp, float *xPrevHp, float *stateLp)
+    {
+        float yHp = *stateHp;
+        float x1 = *xPrevHp;
+        float yLp = *stateLp;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = buffer[i] * segmentGain<Constant>(start, step, i);
+            yHp = (x - x1) + aHp * yHp;
+            x1 = x;
+            yLp = bLp * yHp + aLp * yLp;
+            buffer[i] = yLp;
+        }
+        *stateHp = yHp;
+        *xPrevHp = x1;
+        *stateLp = yLp;
+    }
+
+    void rampLowpass(float *buffer, int numSamples, float start, float step, float b, float a, float *state)
+    {
+        if (step == 0.0f)
+            rampLowpassImpl<true>(buffer, numSamples, start, step, b, a, state);
+        else
+            rampLowpassImpl<false>(buffer, numSamples, start, step, b, a, state);
+    }
+
+    void rampHighpass(float *buffer, int numSamples, float start, float step, float alpha,
+                      float *state, float *xPrev)
+    {
+        if (step == 0.0f)
+            rampHighpassImpl<true>(buffer, numSamples, start, step, alpha, state, xPrev);
+        else
+            rampHighpassImpl<false>(buffer, numSamples, start, step, alpha, state, xPrev);
+    }
+
+    void rampBandpass(float *buffer, int numSamples, float start, float step, float aHp, float bLp,
+                      float aLp, float *stateHp, float *xPrevHp, float *stateLp)
+    {
+        if (step == 0.0f)
+            rampBandpassImpl<true>(buffer, numSamples, start, step, aHp, bLp, aLp, stateHp, xPrevHp, stateLp);
+        else
+            rampBandpassImpl<false>(buffer, numSamples, start, step, aHp, bLp, aLp, stateHp, xPrevHp, stateLp);
+    }
+
+    void mixInto(float *dest, const float *source, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] += source[i];
+    }
+
+    constexpr DspKernels makeKernels(KernelIsa isa, const char *name)
+    {
+        return {isa, name, renderWavetable, renderWavetableF16, renderWavetableI16,
+                renderWavetableModulated, renderWavetableModulatedF16, renderWavetableModulatedI16,
+                renderPhaseModulated, renderPhaseModulatedF16, renderPhaseModulatedI16, renderPartials,
+                multiplyByRamp, onePoleLowpass, onePoleHighpass, rcBandpass,
+                rampLowpass, rampHighpass, rampBandpass, mixInto};
+    }
+}
@@ -0,0 +1,17 @@
+#include "KernelDispatch.h"
+
+// ARMv8 baseline; no extra flags needed.
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#include "KernelsImpl.h"
+
+const DspKernels *getKernelsNEON() noexcept
+{
+    static constexpr DspKernels kernels = makeKernels(KernelIsa::NEON, "NEON");
+    return &kernels;
+}
+#else
+const DspKernels *getKernelsNEON() noexcept
+{
+    return nullptr;
+}
+#endif
@@ -0,0 +1,17 @@
+#include "KernelDispatch.h"
+
+// x86-64 baseline; no extra flags needed.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include "KernelsImpl.h"
+
+const DspKernels *getKernelsSSE2() noexcept
+{
+    static constexpr DspKernels kernels = makeKernels(KernelIsa::SSE2, "SSE2");
+    return &kernels;
+}
+#else
+const DspKernels *getKernelsSSE2() noexcept
+{
+    return nullptr;
+}
+#endif
@@ -0,0 +1,11 @@
+#include "KernelDispatch.h"
+
+// Reference build: compiled without auto-vectorization (see CMakeLists.txt),
+// always available.
+#include "KernelsImpl.h"
+
+const DspKernels *getKernelsScalar() noexcept
+{
+    static constexpr DspKernels kernels = makeKernels(KernelIsa::Scalar, "Scalar");
+    return &kernels;
+}
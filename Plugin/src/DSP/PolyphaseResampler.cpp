@@ -0,0 +1,132 @@
+#include "PolyphaseResampler.h"
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr double kaiserBeta = 8.0;
+
+    /** Modified Bessel function of the first kind, order 0 (series). */
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        const double q = 0.25 * x * x;
+        for (int k = 1; k < 50; ++k)
+        {
+            term *= q / (double(k) * double(k));
+            sum += term;
+            if (term < sum * 1.0e-12)
+                break;
+        }
+        return sum;
+    }
+}
+
+void PolyphaseResampler::prepare(double inputRate, double outputRate, int maxOutputBlock)
+{
+    jassert(inputRate > 0.0 && outputRate > 0.0 && maxOutputBlock > 0);
+
+    step = inputRate / outputRate;
+
+    // Ancho de transición de la ventana de Kaiser (fórmula de diseño de Kaiser),
+    // en unidades del Nyquist de entrada. La banda de rechazo empieza en el
+    // Nyquist más bajo de los dos: nada por encima de él se pliega en la salida
+    const double pi = juce::MathConstants<double>::pi;
+    const double attenuationDb = kaiserBeta / 0.1102 + 8.7;
+    const double transition = (attenuationDb - 7.95) / (2.285 * (numTaps - 1) * pi);
+    const double lowerNyquist = std::min(1.0, 1.0 / step);
+    const double cutoff = std::max(0.5 * lowerNyquist, lowerNyquist - 0.5 * transition);
+    const double halfLength = 0.5 * numTaps;
+    const double windowNorm = besselI0(kaiserBeta);
+
+    coefficients.assign(size_t(numPhases + 1) * numTaps, 0.0f);
+    for (int k = 0; k <= numPhases; ++k)
+    {
+        const double frac = double(k) / numPhases;
+        double h[numTaps];
+        double sum = 0.0;
+
+        for (int j = 0; j < numTaps; ++j)
+        {
+            // Distancia entre el tap j y el instante interpolado
+            const double x = (halfLength - 1.0 + frac) - j;
+            const double r = x / halfLength;
+            const double window = std::abs(r) < 1.0 ? besselI0(kaiserBeta * std::sqrt(1.0 - r * r)) / windowNorm : 0.0;
+            const double t = pi * cutoff * x;
+            const double sinc = std::abs(t) < 1.0e-12 ? 1.0 : std::sin(t) / t;
+
+            h[j] = cutoff * sinc * window;
+            sum += h[j];
+        }
+
+        for (int j = 0; j < numTaps; ++j)
+            coefficients[size_t(k) * numTaps + size_t(j)] = float(h[j] / sum);
+    }
+
+    maxInput = int(std::ceil(maxOutputBlock * step)) + 2;
+    history.assign(size_t(2 * numTaps + maxInput + int(std::ceil(step)) + 2), 0.0f);
+    reset();
+}
+
+void PolyphaseResampler::reset()
+{
+    std::fill(history.begin(), history.end(), 0.0f);
+    // Historia inicial de numTaps ceros: retardo fijo, nunca se lee el futuro
+    buffered = numTaps;
+    position = 0.0;
+}
+
+int PolyphaseResampler::getInputSamplesNeeded(int numOutput) const
+{
+    if (numOutput <= 0)
+        return 0;
+
+    const int lastFirstTap = int(position + (numOutput - 1) * step);
+    return std::max(0, lastFirstTap + numTaps - buffered);
+}
+
+void PolyphaseResampler::process(const float *input, int numInput, float *output, int numOutput)
+{
+    jassert(numInput == getInputSamplesNeeded(numOutput));
+    jassert(numInput <= maxInput);
+    jassert(buffered + numInput <= (int)history.size());
+
+    std::copy(input, input + numInput, history.begin() + buffered);
+    buffered += numInput;
+
+    const float *hist = history.data();
+    const float *coeffs = coefficients.data();
+
+    double p = position;
+    for (int n = 0; n < numOutput; ++n, p += step)
+    {
+        const int base = int(p);
+        const double phase = (p - base) * numPhases;
+        const int k = std::min(int(phase), numPhases - 1);
+        const float t = float(phase - k);
+
+        const float *c0 = coeffs + size_t(k) * numTaps;
+        const float *c1 = c0 + numTaps;
+        const float *x = hist + base;
+
+        float acc0 = 0.0f, acc1 = 0.0f;
+        for (int j = 0; j < numTaps; ++j)
+        {
+            acc0 += c0[j] * x[j];
+            acc1 += c1[j] * x[j];
+        }
+        output[n] = acc0 + t * (acc1 - acc0);
+    }
+
+    // Descarta la entrada ya consumida; queda el contexto del siguiente bloque
+    const int consumed = std::min(int(p), buffered);
+    std::copy(history.begin() + consumed, history.begin() + buffered, history.begin());
+    buffered -= consumed;
+    position = p - consumed;
+}
+
+double PolyphaseResampler::getLatencyInOutputSamples() const
+{
+    return (0.5 * numTaps + 1.0) / step;
+}
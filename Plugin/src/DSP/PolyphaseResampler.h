@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class PolyphaseResampler
+ * @brief Mono sample-rate converter from the engine rate to the host rate.
+ *
+ * Windowed-sinc polyphase FIR: numPhases sub-filters of numTaps taps, with
+ * linear interpolation between adjacent phases, so any ratio works (48 kHz →
+ * 44.1, 88.2, 96, 192 kHz...) without a rational factorization. The cutoff
+ * sits half a transition band below the lower Nyquist frequency of the two
+ * rates, so the stopband (about 80 dB, Kaiser β = 8) starts at that Nyquist:
+ * with 64 taps the passband reaches about 0.84 × Nyquist. Each phase is
+ * normalized to unity DC gain.
+ *
+ * It is pull-driven: the caller asks how many input samples the next
+ * numOutput samples need (getInputSamplesNeeded), renders exactly that many
+ * and calls process(). The input is delayed by numTaps samples internally so
+ * the filter never needs samples from a future block; the resulting constant
+ * delay is getLatencyInOutputSamples().
+ *
+ * prepare() allocates; process() does not (audio thread).
+ */
+class PolyphaseResampler
+{
+public:
+    static constexpr int numTaps = 64;
+    static constexpr int numPhases = 256;
+
+    /**
+     * @brief Builds the filter and sizes the buffers.
+     * @param inputRate Engine sample rate in Hz.
+     * @param outputRate Host sample rate in Hz.
+     * @param maxOutputBlock Largest numOutput passed to process().
+     */
+    void prepare(double inputRate, double outputRate, int maxOutputBlock);
+
+    /** @brief Clears the history and the fractional position. */
+    void reset();
+
+    /** @brief Input samples that the next process(…, numOutput) call consumes. */
+    int getInputSamplesNeeded(int numOutput) const;
+
+    /** @brief Upper bound of getInputSamplesNeeded() for maxOutputBlock. */
+    int getMaxInputSamples() const { return maxInput; }
+
+    /**
+     * @brief Converts one block.
+     * @param input getInputSamplesNeeded(numOutput) samples at the input rate.
+     * @param numInput Must equal getInputSamplesNeeded(numOutput).
+     * @param output Destination, numOutput samples at the output rate.
+     * @param numOutput At most the maxOutputBlock given to prepare().
+     */
+    void process(const float *input, int numInput, float *output, int numOutput);
+
+    /** @brief Constant delay added by the converter, in output samples. */
+    double getLatencyInOutputSamples() const;
+
+    /** @brief Bytes of the coefficient table and the history buffer. */
+    size_t getMemoryBytes() const noexcept { return (coefficients.capacity() + history.capacity()) * sizeof(float); }
+
+private:
+    double step = 1.0;     ///< Input samples per output sample.
+    double position = 0.0; ///< Read position of the next output in history (first tap).
+    int buffered = 0;      ///< Valid samples in history.
+    int maxInput = 0;
+
+    std::vector<float> coefficients; ///< (numPhases + 1) × numTaps, phase-major.
+    std::vector<float> history;
+};
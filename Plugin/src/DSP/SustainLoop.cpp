@@ -0,0 +1,95 @@
+#include "SustainLoop.h"
+#include "KernelDispatch.h"
+#include <algorithm>
+#include <cmath>
+
+int SustainLoop::findLength(double phaseDelta, int &cycles)
+{
+    cycles = 0;
+    if (!(phaseDelta > 0.0) || phaseDelta >= 0.5)
+        return 0;
+
+    // La longitud más corta con un número entero de ciclos (dentro de maxDetune)
+    for (int n = 1; n <= capacity; ++n)
+    {
+        const double exact = n * phaseDelta;
+        const double whole = std::round(exact);
+        if (whole < 1.0 || std::abs(exact - whole) > maxDetune * exact)
+            continue;
+
+        // Repetido hasta minLength: el replay copia tramos más largos
+        const int repeats = std::max(1, std::min(capacity / n, (minLength + n - 1) / n));
+        cycles = int(whole) * repeats;
+        return n * repeats;
+    }
+    return 0;
+}
+
+void SustainLoop::beginCapture(int newLength, int maxCaptureSamples)
+{
+    length = std::clamp(newLength, 1, capacity);
+    position = 0;
+    capturedLoops = 0;
+    captureBudget = maxCaptureSamples;
+    maxDifference = 0.0f;
+    state = newLength > 0 ? State::Capturing : State::Failed;
+}
+
+SustainLoop::State SustainLoop::capture(const float *input, int numSamples)
+{
+    if (state != State::Capturing)
+        return state;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Se compara con la vuelta anterior antes de sobrescribirla
+        maxDifference = std::max(maxDifference, std::abs(samples[size_t(position)] - input[i]));
+        samples[size_t(position)] = input[i];
+
+        if (++position < length)
+            continue;
+
+        position = 0;
+        if (capturedLoops > 0 && maxDifference <= settleTolerance)
+        {
+            // Las muestras que quedan ya coinciden con el comienzo del loop
+            position = (numSamples - 1 - i) % length;
+            state = State::Settled;
+            return state;
+        }
+
+        ++capturedLoops;
+        maxDifference = 0.0f;
+    }
+
+    captureBudget -= numSamples;
+    if (captureBudget <= 0)
+        state = State::Failed;
+    return state;
+}
+
+void SustainLoop::mixInto(float *out, int numSamples) const
+{
+    const auto &kernels = KernelDispatch::get();
+    int pos = position;
+    while (numSamples > 0)
+    {
+        const int n = std::min(numSamples, length - pos);
+        kernels.mixInto(out, samples.data() + pos, n);
+        out += n;
+        numSamples -= n;
+        pos = 0;
+    }
+}
+
+void SustainLoop::advance(int numSamples)
+{
+    position = (position + numSamples) % length;
+}
+
+void SustainLoop::reset()
+{
+    state = State::Idle;
+    position = 0;
+    capturedLoops = 0;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <array>
+
+/**
+ * @class SustainLoop
+ * @brief Captures one settled period of a sustained voice and replays it.
+ *
+ * While a voice is in Sustain with static settings, its output (oscillator ×
+ * sustain level → linear filter) is periodic once the filter has settled.
+ * The voice picks a loop length holding a whole number of oscillator cycles
+ * (findLength()), renders normally and feeds every sample to capture(). Each
+ * completed loop is compared with the previous one; when they match within
+ * settleTolerance the loop is settled and the voice can replay it instead of
+ * running the oscillator, envelope and filter.
+ *
+ * The class only holds the samples and the positions. Keeping the voice's
+ * own state consistent (pitch, phase, filter state on exit) is up to the
+ * voice. No allocation: the buffer is a fixed member.
+ */
+class SustainLoop
+{
+public:
+    /** @brief Longest loop, in samples. */
+    static constexpr int capacity = 4096;
+
+    /** @brief Shortest loop; short loops are repeated up to this length. */
+    static constexpr int minLength = 256;
+
+    /** @brief Largest pitch change accepted to make the loop exact (relative; ≈ 0.05 cent). */
+    static constexpr double maxDetune = 2.9e-5;
+
+    /** @brief Max sample difference between two consecutive loops to call them settled (≈ -100 dB). */
+    static constexpr float settleTolerance = 1.0e-5f;
+
+    enum class State
+    {
+        Idle,      ///< Not capturing.
+        Capturing, ///< Comparing consecutive loops.
+        Settled,   ///< The loop can be replayed.
+        Failed     ///< Did not settle within the capture budget.
+    };
+
+    /**
+     * @brief Finds a loop length that holds a whole number of cycles.
+     * @param phaseDelta Oscillator phase increment per sample.
+     * @param cycles Receives the number of cycles in the loop.
+     * @return Loop length in samples, or 0 if no length up to capacity is
+     *         within maxDetune. Playing at cycles / length per sample then
+     *         makes the loop exactly periodic.
+     */
+    static int findLength(double phaseDelta, int &cycles);
+
+    /**
+     * @brief Starts comparing loops of the given length.
+     * @param length Loop length from findLength(); 0 goes straight to Failed.
+     * @param maxCaptureSamples Samples after which the capture gives up.
+     */
+    void beginCapture(int length, int maxCaptureSamples);
+
+    /**
+     * @brief Feeds rendered samples while capturing.
+     * @return The state after these samples. On Settled, the samples past
+     *         the loop boundary count as already replayed.
+     */
+    State capture(const float *samples, int numSamples);
+
+    /**
+     * @brief Copies the next numSamples of the loop into out (adding).
+     *
+     * Used once per channel; call advance() after the last one.
+     */
+    void mixInto(float *out, int numSamples) const;
+
+    /** @brief Moves the replay position by numSamples. */
+    void advance(int numSamples);
+
+    /** @brief Back to Idle. */
+    void reset();
+
+    State getState() const { return state; }
+    int getLength() const { return length; }
+
+    /** @brief Position in the loop of the next sample. */
+    int getPosition() const { return position; }
+
+private:
+    std::array<float, capacity> samples{};
+    State state = State::Idle;
+    int length = 0;
+    int position = 0;
+    int capturedLoops = 0;
+    int captureBudget = 0;
+    float maxDifference = 0.0f;
+};
@@ -1,5 +1,7 @@
 #include "Envelope.h"
+#include "DSP/KernelDispatch.h"
 #include <algorithm>
+#include <cmath>
 
 /**
  * @brief Default constructor initializing internal parameters.
@@ -13,7 +15,8 @@ Envelope::Envelope()
       releaseTime(0.20f),
       stageCounter(0),
       currentLevel(0.0f),
-      releaseStartLevel(0.0f)
+      releaseStartLevel(0.0f),
+      fastRelease(false)
 {
     setSampleRate(sampleRate);
 }
@@ -22,10 +25,15 @@ void Envelope::setSampleRate(double sr)
 {
     sampleRate = sr;
 
-    // Convert seconds → samples
-    attackSamples = std::max(1, int(attackTime * sampleRate));
-    decaySamples = std::max(1, int(decayTime * sampleRate));
-    releaseSamples = std::max(1, int(releaseTime * sampleRate));
+    // Convert seconds → samples, rounded like adsr_envelope.m
+    attackSamples = std::max(1, int(std::lround(attackTime * sampleRate)));
+    decaySamples = std::max(1, int(std::lround(decayTime * sampleRate)));
+    releaseSamples = std::max(1, int(std::lround(releaseTime * sampleRate)));
+    fastReleaseSamples = std::max(1, int(std::lround(fastReleaseSeconds * sampleRate)));
+
+    // Parameters are refreshed every block; a fast release must survive that
+    activeReleaseSamples = fastRelease ? std::min(releaseSamples, fastReleaseSamples)
+                                       : releaseSamples;
 }
 
 void Envelope::setParameters(float a, float d, float s, float r)
@@ -43,13 +51,36 @@ void Envelope::enterAttack()
     stage = Stage::Attack;
     stageCounter = 0;
     currentLevel = 0.0f;
+    fastRelease = false;
 }
 
 void Envelope::enterRelease()
 {
+    // A Note-Off must not stretch a culled voice back to the full release
+    if (fastRelease)
+        return;
+
+    releaseStartLevel = currentLevel;
+    stage = Stage::Release;
+    stageCounter = 0;
+    activeReleaseSamples = releaseSamples;
+}
+
+void Envelope::enterFastRelease()
+{
+    if (stage == Stage::Idle || isInFastRelease())
+        return;
+
     releaseStartLevel = currentLevel;
     stage = Stage::Release;
     stageCounter = 0;
+    activeReleaseSamples = std::min(releaseSamples, fastReleaseSamples);
+    fastRelease = true;
+}
+
+bool Envelope::isInFastRelease() const
+{
+    return stage == Stage::Release && fastRelease;
 }
 
 void Envelope::reset()
@@ -57,6 +88,7 @@ void Envelope::reset()
     stage = Stage::Idle;
     stageCounter = 0;
     currentLevel = 0.0f;
+    fastRelease = false;
 }
 
 bool Envelope::isActive() const
@@ -103,9 +135,9 @@ float Envelope::processSample()
     case Stage::Release:
         stageCounter++;
         currentLevel = releaseStartLevel *
-                       (1.0f - float(stageCounter) / float(releaseSamples));
+                       (1.0f - float(stageCounter) / float(activeReleaseSamples));
 
-        if (stageCounter >= releaseSamples || currentLevel <= 1e-6f)
+        if (stageCounter >= activeReleaseSamples || currentLevel <= 1e-6f)
         {
             currentLevel = 0.0f;
             reset();
@@ -115,3 +147,20 @@ float Envelope::processSample()
 
     return currentLevel;
 }
+
+int Envelope::getReleaseEndCounter() const
+{
+    // processSample() also stops once the level falls to 1e-6
+    if (releaseStartLevel <= 1e-6f)
+        return stageCounter + 1;
+
+    const double thresholdCounter = std::ceil(activeReleaseSamples * (1.0 - 1e-6 / releaseStartLevel));
+    return std::max(stageCounter + 1, std::min(activeReleaseSamples, int(thresholdCounter)));
+}
+
+void Envelope::processBlock(float *buffer, int numSamples)
+{
+    const auto &kernels = KernelDispatch::get();
+    processSegments(buffer, numSamples, [&kernels](float *segment, int n, float start, float step)
+                    { kernels.multiplyByRamp(segment, n, start, step); });
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include <algorithm>
 
 /**
  * @class Envelope
@@ -77,9 +78,26 @@ public:
      *
      * Called by the voice on MIDI Note-Off. Stores the current level
      * and transitions toward 0.0 over the configured release time.
+     * Has no effect after enterFastRelease() until the next enterAttack().
      */
     void enterRelease();
 
+    /**
+     * @brief Begins a short release (fastReleaseSeconds) from the current level.
+     *
+     * Used to cull voices without a click when CPU headroom is low. Has no
+     * effect if the envelope is idle or already in a fast release. The fast
+     * release survives setParameters() and setSampleRate(); only
+     * enterAttack() and reset() end it.
+     */
+    void enterFastRelease();
+
+    /** @brief Indicates whether the envelope is currently in a fast release. */
+    bool isInFastRelease() const;
+
+    /** @brief Duration of the release started by enterFastRelease(), in seconds. */
+    static constexpr float fastReleaseSeconds = 0.005f;
+
     /**
      * @brief Forces the envelope into the idle state and resets internal values.
      */
@@ -94,6 +112,30 @@ public:
      */
     float processSample();
 
+    /**
+     * @brief Multiplies a buffer by the envelope, advancing it numSamples.
+     * @param buffer Samples to scale in place.
+     * @param numSamples Number of samples.
+     *
+     * Equivalent to buffer[i] *= processSample() for each sample, but each
+     * linear segment is applied in one KernelDispatch ramp call.
+     */
+    void processBlock(float *buffer, int numSamples);
+
+    /**
+     * @brief Walks the envelope over numSamples, one linear segment at a time.
+     * @param buffer Samples the segments refer to.
+     * @param numSamples Number of samples.
+     * @param applySegment Called as applySegment(segment, n, start, step) for
+     *        each segment: the gain of sample i is start + step * i. Idle
+     *        samples are zeroed first and passed as a zero-gain segment.
+     *
+     * processBlock() passes KernelDispatch::multiplyByRamp; the voice passes
+     * a fused ramp + filter kernel, so the filter reads the block once.
+     */
+    template <typename ApplySegment>
+    void processSegments(float *buffer, int numSamples, ApplySegment &&applySegment);
+
     /**
      * @brief Indicates whether the envelope is active.
      * @return True if the envelope is not in the Idle stage.
@@ -102,6 +144,9 @@ public:
      */
     bool isActive() const;
 
+    /** @brief Returns the current stage. */
+    Stage getStage() const { return stage; }
+
 private:
     Stage stage;       ///< Current ADSR stage.
     double sampleRate; ///< System sample rate.
@@ -118,4 +163,106 @@ private:
     int attackSamples;  ///< Attack duration in samples.
     int decaySamples;   ///< Decay duration in samples.
     int releaseSamples; ///< Release duration in samples.
+
+    int fastReleaseSamples;    ///< Fast release duration in samples.
+    int activeReleaseSamples;  ///< Duration of the release in progress.
+    bool fastRelease;          ///< Set by enterFastRelease(), cleared by enterAttack() and reset().
+
+    /** @brief Counter value at which the release in progress ends (length or level threshold). */
+    int getReleaseEndCounter() const;
 };
+
+template <typename ApplySegment>
+void Envelope::processSegments(float *buffer, int numSamples, ApplySegment &&applySegment)
+{
+    int pos = 0;
+
+    while (pos < numSamples)
+    {
+        const int remaining = numSamples - pos;
+
+        switch (stage)
+        {
+        case Stage::Idle:
+            std::fill(buffer + pos, buffer + numSamples, 0.0f);
+            applySegment(buffer + pos, remaining, 0.0f, 0.0f);
+            return;
+
+        case Stage::Attack:
+        {
+            // Stage shortened by setParameters() while running
+            if (stageCounter >= attackSamples)
+            {
+                stage = Stage::Decay;
+                stageCounter = 0;
+                currentLevel = 1.0f;
+                break;
+            }
+
+            // level(c) = c / attackSamples, for c = stageCounter + 1 ...
+            const int n = std::min(remaining, attackSamples - stageCounter);
+            const float step = 1.0f / float(attackSamples);
+            applySegment(buffer + pos, n, float(stageCounter + 1) * step, step);
+
+            stageCounter += n;
+            currentLevel = float(stageCounter) / float(attackSamples);
+            if (stageCounter >= attackSamples)
+            {
+                stage = Stage::Decay;
+                stageCounter = 0;
+                currentLevel = 1.0f;
+            }
+            pos += n;
+            break;
+        }
+
+        case Stage::Decay:
+        {
+            if (stageCounter >= decaySamples)
+            {
+                stage = Stage::Sustain;
+                currentLevel = sustainLevel;
+                stageCounter = 0;
+                break;
+            }
+
+            const int n = std::min(remaining, decaySamples - stageCounter);
+            const float step = -(1.0f - sustainLevel) / float(decaySamples);
+            applySegment(buffer + pos, n, 1.0f + float(stageCounter + 1) * step, step);
+
+            stageCounter += n;
+            currentLevel = 1.0f - (1.0f - sustainLevel) *
+                                      (float(stageCounter) / float(decaySamples));
+            if (stageCounter >= decaySamples)
+            {
+                stage = Stage::Sustain;
+                currentLevel = sustainLevel;
+                stageCounter = 0;
+            }
+            pos += n;
+            break;
+        }
+
+        case Stage::Sustain:
+            currentLevel = sustainLevel;
+            applySegment(buffer + pos, remaining, sustainLevel, 0.0f);
+            return;
+
+        case Stage::Release:
+        {
+            const int endCounter = getReleaseEndCounter();
+            const int n = std::min(remaining, endCounter - stageCounter);
+            const float step = -releaseStartLevel / float(activeReleaseSamples);
+            applySegment(buffer + pos, n, releaseStartLevel + float(stageCounter + 1) * step, step);
+
+            stageCounter += n;
+            currentLevel = releaseStartLevel *
+                           (1.0f - float(stageCounter) / float(activeReleaseSamples));
+            if (stageCounter >= endCounter)
+                reset();
+            pos += n;
+            break;
+        }
+        }
+    }
+}
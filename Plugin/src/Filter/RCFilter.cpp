@@ -1,4 +1,5 @@
 #include "RCFilter.h"
+#include "DSP/KernelDispatch.h"
 #include <cmath>
 #include <algorithm>
 
@@ -11,16 +12,25 @@ void RCFilter::setSampleRate(double sampleRate)
     generateLowpassBank();
     generateHighpassBank();
     generateBandpassBank();
+    bankIndexDirty = true;
 }
 
 void RCFilter::setType(RCFilterType newType)
 {
-    type = newType;
+    if (newType != type)
+    {
+        type = newType;
+        bankIndexDirty = true;
+    }
 }
 
 void RCFilter::setCutoff(float newCutoff)
 {
-    cutoff = newCutoff;
+    if (newCutoff != cutoff)
+    {
+        cutoff = newCutoff;
+        bankIndexDirty = true;
+    }
 }
 
 // -------------------------------------------------------
@@ -156,44 +166,61 @@ int RCFilter::findClosestIndexBP(float c) const
     return best;
 }
 
+void RCFilter::updateBankIndex()
+{
+    switch (type)
+    {
+    case RCFilterType::Lowpass:
+        bankIndex = findClosestIndexLP(cutoff);
+        break;
+    case RCFilterType::Highpass:
+        bankIndex = findClosestIndexHP(cutoff);
+        break;
+    case RCFilterType::Bandpass:
+        bankIndex = findClosestIndexBP(cutoff);
+        break;
+    }
+    bankIndexDirty = false;
+}
+
 // -------------------------------------------------------
 // Sample processing
 // -------------------------------------------------------
 float RCFilter::processSample(float x)
 {
+    if (bankIndexDirty)
+        updateBankIndex();
+
     switch (type)
     {
     case RCFilterType::Lowpass:
     {
-        int i = findClosestIndexLP(cutoff);
-        auto &s = lpBank[i];
-        float y = s.b * x + s.a * s.state;
-        s.state = y;
+        const auto &c = lpBank[bankIndex];
+        float y = c.b * x + c.a * state.lp;
+        state.lp = y;
         return y;
     }
 
     case RCFilterType::Highpass:
     {
-        int i = findClosestIndexHP(cutoff);
-        auto &s = hpBank[i];
+        const auto &c = hpBank[bankIndex];
 
-        float y = s.alpha * (s.state + x - s.xPrev);
-        s.state = y;
-        s.xPrev = x;
+        float y = c.alpha * (state.hp + x - state.hpXPrev);
+        state.hp = y;
+        state.hpXPrev = x;
         return y;
     }
 
     case RCFilterType::Bandpass:
     {
-        int i = findClosestIndexBP(cutoff);
-        auto &s = bpBank[i];
+        const auto &c = bpBank[bankIndex];
 
-        float y_hp = (x - s.xPrev_hp) + s.a_hp * s.state_hp;
-        s.state_hp = y_hp;
-        s.xPrev_hp = x;
+        float y_hp = (x - state.bpXPrev) + c.a_hp * state.bpHp;
+        state.bpHp = y_hp;
+        state.bpXPrev = x;
 
-        float y_lp = s.b_lp * y_hp + s.a_lp * s.state_lp;
-        s.state_lp = y_lp;
+        float y_lp = c.b_lp * y_hp + c.a_lp * state.bpLp;
+        state.bpLp = y_lp;
 
         return y_lp;
     }
@@ -202,26 +229,78 @@ float RCFilter::processSample(float x)
     return x;
 }
 
-void RCFilter::reset()
+// -------------------------------------------------------
+// Block processing (kernels de KernelDispatch)
+// -------------------------------------------------------
+void RCFilter::processBlock(float *buffer, int numSamples)
+{
+    const auto &kernels = KernelDispatch::get();
+
+    if (bankIndexDirty)
+        updateBankIndex();
+
+    switch (type)
+    {
+    case RCFilterType::Lowpass:
+    {
+        const auto &c = lpBank[bankIndex];
+        kernels.onePoleLowpass(buffer, numSamples, c.b, c.a, &state.lp);
+        break;
+    }
+
+    case RCFilterType::Highpass:
+    {
+        const auto &c = hpBank[bankIndex];
+        kernels.onePoleHighpass(buffer, numSamples, c.alpha, &state.hp, &state.hpXPrev);
+        break;
+    }
+
+    case RCFilterType::Bandpass:
+    {
+        const auto &c = bpBank[bankIndex];
+        kernels.rcBandpass(buffer, numSamples, c.a_hp, c.b_lp, c.a_lp,
+                           &state.bpHp, &state.bpXPrev, &state.bpLp);
+        break;
+    }
+    }
+}
+
+void RCFilter::processRampedBlock(float *buffer, int numSamples, float start, float step)
 {
-    // Lowpass
-    for (auto &s : lpBank)
+    const auto &kernels = KernelDispatch::get();
+
+    if (bankIndexDirty)
+        updateBankIndex();
+
+    // Kernel fusionado según el tipo; se elige una vez por segmento
+    switch (type)
     {
-        s.state = 0.0f;
+    case RCFilterType::Lowpass:
+    {
+        const auto &c = lpBank[bankIndex];
+        kernels.rampLowpass(buffer, numSamples, start, step, c.b, c.a, &state.lp);
+        break;
     }
 
-    // Highpass
-    for (auto &s : hpBank)
+    case RCFilterType::Highpass:
     {
-        s.state = 0.0f;
-        s.xPrev = 0.0f;
+        const auto &c = hpBank[bankIndex];
+        kernels.rampHighpass(buffer, numSamples, start, step, c.alpha, &state.hp, &state.hpXPrev);
+        break;
     }
 
-    // Bandpass
-    for (auto &s : bpBank)
+    case RCFilterType::Bandpass:
     {
-        s.state_hp = 0.0f;
-        s.xPrev_hp = 0.0f;
-        s.state_lp = 0.0f;
+        const auto &c = bpBank[bankIndex];
+        kernels.rampBandpass(buffer, numSamples, start, step, c.a_hp, c.b_lp, c.a_lp,
+                             &state.bpHp, &state.bpXPrev, &state.bpLp);
+        break;
+    }
     }
+}
+
+void RCFilter::reset()
+{
+    // Un solo estado por topologia: no hay que recorrer los bancos
+    state = RCFilterState{};
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <vector>
 
 enum class RCFilterType
@@ -8,20 +9,18 @@ enum class RCFilterType
     Bandpass
 };
 
+// Los bancos solo guardan coeficientes; el estado vive en RCFilterState
 struct RCLowpass
 {
     float cutoff;
     float b;
     float a;
-    float state = 0.0f;
 };
 
 struct RCHighpass
 {
     float cutoff;
     float alpha;
-    float state = 0.0f;
-    float xPrev = 0.0f;
 };
 
 struct RCBandpass
@@ -32,13 +31,24 @@ struct RCBandpass
     // HP stage
     float b_hp;
     float a_hp;
-    float state_hp = 0.0f;
-    float xPrev_hp = 0.0f;
 
     // LP stage
     float b_lp;
     float a_lp;
-    float state_lp = 0.0f;
+};
+
+// Estado de cada topologia, compartido por todas las entradas de su banco:
+// reset() es O(1) y un cambio de cutoff no salta a un estado distinto
+struct RCFilterState
+{
+    float lp = 0.0f;
+
+    float hp = 0.0f;
+    float hpXPrev = 0.0f;
+
+    float bpHp = 0.0f;
+    float bpXPrev = 0.0f;
+    float bpLp = 0.0f;
 };
 
 class RCFilter
@@ -50,13 +60,36 @@ public:
     void setCutoff(float newCutoff);
     float processSample(float x);
 
+    // Filtra un bloque in-place: el banco se resuelve una vez por bloque
+    void processBlock(float *buffer, int numSamples);
+
+    // Multiplica por la rampa start + step * i (segmento del envelope) y filtra,
+    // en una sola pasada; mismo resultado que multiplyByRamp + processBlock
+    void processRampedBlock(float *buffer, int numSamples, float start, float step);
+
     void reset();
 
+    // Estado completo (para guardar y restaurar la continuidad del filtro)
+    const RCFilterState &getState() const { return state; }
+    void setState(const RCFilterState &newState) { state = newState; }
+
+    // Bytes reservados por cada banco (contabilidad de memoria)
+    size_t getLowpassBankBytes() const { return lpBank.capacity() * sizeof(RCLowpass); }
+    size_t getHighpassBankBytes() const { return hpBank.capacity() * sizeof(RCHighpass); }
+    size_t getBandpassBankBytes() const { return bpBank.capacity() * sizeof(RCBandpass); }
+
 private:
     double fs = 44100.0;
     RCFilterType type = RCFilterType::Lowpass;
     float cutoff = 1000.0f;
 
+    RCFilterState state;
+
+    // Indice del banco para (type, cutoff); se recalcula solo si cambian
+    int bankIndex = 0;
+    bool bankIndexDirty = true;
+    void updateBankIndex();
+
     std::vector<RCLowpass> lpBank;
     std::vector<RCHighpass> hpBank;
     std::vector<RCBandpass> bpBank;
@@ -18,6 +18,16 @@ float VoiceFilter::processSample(float x)
     return filter.processSample(x);
 }
 
+void VoiceFilter::processBlock(float *buffer, int numSamples)
+{
+    filter.processBlock(buffer, numSamples);
+}
+
+void VoiceFilter::processRampedBlock(float *buffer, int numSamples, float start, float step)
+{
+    filter.processRampedBlock(buffer, numSamples, start, step);
+}
+
 void VoiceFilter::reset()
 {
     filter.reset();
@@ -8,9 +8,20 @@ public:
     void setSampleRate(double sampleRate);
     void setParameters(RCFilterType type, float cutoff);
     float processSample(float x);
+    void processBlock(float *buffer, int numSamples);
+
+    // Segmento del envelope y filtro en una pasada (ver RCFilter::processRampedBlock)
+    void processRampedBlock(float *buffer, int numSamples, float start, float step);
 
     void reset();
 
+    // Estado del filtro interno (caché de sustain de la voz)
+    const RCFilterState &getState() const { return filter.getState(); }
+    void setState(const RCFilterState &state) { filter.setState(state); }
+
+    // Bancos del RCFilter interno (contabilidad de memoria)
+    const RCFilter &getFilter() const { return filter; }
+
 private:
     RCFilter filter;
 };
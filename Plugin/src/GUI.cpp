@@ -1,13 +1,15 @@
 #include "GUI.h"
 #include "PluginProcessor.h"
+#include "DSP/KernelDispatch.h"
 
 GUI::GUI(AudioPluginAudioProcessor &p)
     : AudioProcessorEditor(&p),
       audioProcessor(p),
       keyboardComponent(audioProcessor.getKeyboardState(),
-                        juce::MidiKeyboardComponent::horizontalKeyboard)
+                        juce::MidiKeyboardComponent::horizontalKeyboard),
+      analyzer(audioProcessor.getScopeFifo())
 {
-    setSize(1000, 500);
+    setSize(1000, 850);
 
     // Waveform selector
 
@@ -37,6 +39,87 @@ GUI::GUI(AudioPluginAudioProcessor &p)
     velocityLabel.setJustificationType(juce::Justification::centredLeft);
     addAndMakeVisible(velocityLabel);
 
+    // Pulse width (solo afecta a Square)
+
+    pulseWidthSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    pulseWidthSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 50, 20);
+    addAndMakeVisible(pulseWidthSlider);
+
+    pulseWidthAttachment = std::make_unique<
+        juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "PULSE_WIDTH", pulseWidthSlider);
+
+    pulseWidthLabel.setText("Pulse Width", juce::dontSendNotification);
+    pulseWidthLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    pulseWidthLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(pulseWidthLabel);
+
+    // Preset selector
+
+    updatePresetSelector();
+    presetSelector.onChange = [this]
+    { audioProcessor.setCurrentProgram(presetSelector.getSelectedId() - 1); };
+    addAndMakeVisible(presetSelector);
+
+    // Guardar preset: pide el nombre y lo agrega al banco del usuario
+    presetSaveButton.onClick = [this]
+    {
+        presetNameWindow = std::make_unique<juce::AlertWindow>("Save preset", "Name of the new preset",
+                                                               juce::MessageBoxIconType::NoIcon);
+        presetNameWindow->addTextEditor("name", "User " + juce::String(audioProcessor.getNumPrograms() + 1));
+        presetNameWindow->addButton("Save", 1, juce::KeyPress(juce::KeyPress::returnKey));
+        presetNameWindow->addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+        presetNameWindow->enterModalState(true, juce::ModalCallbackFunction::create([this](int result)
+                                                                                     {
+                                                                                         const auto name = presetNameWindow->getTextEditorContents("name").trim();
+                                                                                         presetNameWindow.reset();
+                                                                                         if (result == 0 || name.isEmpty())
+                                                                                             return;
+
+                                                                                         if (!audioProcessor.saveCurrentAsPreset(name))
+                                                                                             juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+                                                                                                                                    "Preset", "Could not write the user preset bank.");
+                                                                                         updatePresetSelector(); }));
+    };
+    addAndMakeVisible(presetSaveButton);
+
+    presetLabel.setText("Preset", juce::dontSendNotification);
+    presetLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    presetLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(presetLabel);
+
+    // Tuning (Scala .scl)
+    tuningLoadButton.onClick = [this]
+    {
+        tuningChooser = std::make_unique<juce::FileChooser>("Load Scala tuning", juce::File(), "*.scl");
+        tuningChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                   [this](const juce::FileChooser &chooser)
+                                   {
+                                       const auto file = chooser.getResult();
+                                       if (file == juce::File())
+                                           return;
+
+                                       juce::String error;
+                                       if (!audioProcessor.loadTuningFile(file, &error))
+                                           juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+                                                                                  "Tuning", file.getFileName() + ": " + error);
+                                       updateTuningLabel();
+                                   });
+    };
+    addAndMakeVisible(tuningLoadButton);
+
+    tuningResetButton.onClick = [this]
+    {
+        audioProcessor.resetTuning();
+        updateTuningLabel();
+    };
+    addAndMakeVisible(tuningResetButton);
+
+    tuningLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    tuningLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(tuningLabel);
+    updateTuningLabel();
+
     // ADSR sliders
 
     attackSlider.setSliderStyle(juce::Slider::LinearHorizontal);
@@ -105,6 +188,13 @@ GUI::GUI(AudioPluginAudioProcessor &p)
     filterTypeLabel.setJustificationType(juce::Justification::centredLeft);
     addAndMakeVisible(filterTypeLabel);
 
+    // Modo del filtro: por voz o parafónico (uno sobre la mezcla)
+    filterModeSelector.addItem("Per Voice", 1);
+    filterModeSelector.addItem("Paraphonic", 2);
+    addAndMakeVisible(filterModeSelector);
+    filterModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.apvts, "FILTER_MODE", filterModeSelector);
+
     // Filter cutoff slider
     filterCutoffSlider.setSliderStyle(juce::Slider::LinearHorizontal);
     filterCutoffSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
@@ -119,9 +209,349 @@ GUI::GUI(AudioPluginAudioProcessor &p)
     filterCutoffLabel.setJustificationType(juce::Justification::centredLeft);
     addAndMakeVisible(filterCutoffLabel);
 
+    // Pitch sliders (el rango lo da el parámetro vía attachment)
+    auto setupPitchSlider = [this](juce::Slider &slider, juce::Label &label, const juce::String &text,
+                                   const juce::String &parameterID,
+                                   std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> &attachment)
+    {
+        slider.setSliderStyle(juce::Slider::LinearHorizontal);
+        slider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
+        addAndMakeVisible(slider);
+        attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            audioProcessor.apvts, parameterID, slider);
+
+        label.setText(text, juce::dontSendNotification);
+        label.setColour(juce::Label::textColourId, juce::Colours::white);
+        label.setJustificationType(juce::Justification::centredLeft);
+        addAndMakeVisible(label);
+    };
+
+    setupPitchSlider(glideSlider, glideLabel, "Glide (s)", "GLIDE", glideAttachment);
+    setupPitchSlider(vibratoRateSlider, vibratoRateLabel, "Vibrato Rate (Hz)", "VIBRATO_RATE", vibratoRateAttachment);
+    setupPitchSlider(vibratoDepthSlider, vibratoDepthLabel, "Vibrato Depth (st)", "VIBRATO_DEPTH", vibratoDepthAttachment);
+    setupPitchSlider(bendRangeSlider, bendRangeLabel, "Bend Range (st)", "BEND_RANGE", bendRangeAttachment);
+
+    // Capas: modo del oscilador y una columna por forma de onda
+    oscModeSelector.addItem("Single", 1);
+    oscModeSelector.addItem("Layer", 2);
+    oscModeSelector.addItem("FM", 3);
+    oscModeSelector.addItem("Additive", 4);
+    oscModeSelector.addItem("Wavetable", 5);
+    oscModeSelector.onChange = [this]
+    { updateSourceControls(); };
+    addAndMakeVisible(oscModeSelector);
+    oscModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.apvts, "OSC_MODE", oscModeSelector);
+
+    const char *const layerNames[] = {"Sine", "Saw", "Square", "Triangle"};
+    for (size_t i = 0; i < layerControls.size(); ++i)
+    {
+        auto &layer = layerControls[i];
+        const juce::String prefix = "LAYER_" + juce::String(layerNames[i]).toUpperCase() + "_";
+
+        layer.label.setText(layerNames[i], juce::dontSendNotification);
+        layer.label.setColour(juce::Label::textColourId, juce::Colours::white);
+        layer.label.setJustificationType(juce::Justification::centredLeft);
+        addAndMakeVisible(layer.label);
+
+        // Nivel ancho; octava y desafinación compartiendo la fila de abajo
+        for (auto *slider : {&layer.level, &layer.octave, &layer.detune})
+        {
+            slider->setSliderStyle(juce::Slider::LinearHorizontal);
+            slider->setTextBoxStyle(juce::Slider::TextBoxRight, false, 55, 20);
+            addAndMakeVisible(*slider);
+        }
+        layer.octave.setTextValueSuffix(" oct");
+        layer.detune.setTextValueSuffix(" ct");
+
+        layer.levelAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            audioProcessor.apvts, prefix + "LEVEL", layer.level);
+        layer.octaveAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            audioProcessor.apvts, prefix + "OCTAVE", layer.octave);
+        layer.detuneAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            audioProcessor.apvts, prefix + "DETUNE", layer.detune);
+
+        layer.sync.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+        addAndMakeVisible(layer.sync);
+        layer.syncAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            audioProcessor.apvts, prefix + "SYNC", layer.sync);
+    }
+
+    // FM: algoritmo, una columna por operador y el envelope de los moduladores
+    for (int i = 0; i < FMOscillator::numAlgorithms; ++i)
+        fmAlgorithmSelector.addItem(FMOscillator::getAlgorithmName(i), i + 1);
+    addChildComponent(fmAlgorithmSelector);
+    fmAlgorithmAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.apvts, "FM_ALGORITHM", fmAlgorithmSelector);
+
+    auto setupSourceSlider = [this](juce::Slider &slider, const juce::String &suffix)
+    {
+        slider.setSliderStyle(juce::Slider::LinearHorizontal);
+        slider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 55, 20);
+        slider.setTextValueSuffix(suffix);
+        addChildComponent(slider);
+    };
+
+    for (size_t i = 0; i < operatorControls.size(); ++i)
+    {
+        auto &op = operatorControls[i];
+        const juce::String prefix = "FM_OP" + juce::String(int(i) + 1) + "_";
+
+        op.label.setText("OP" + juce::String(int(i) + 1), juce::dontSendNotification);
+        op.label.setColour(juce::Label::textColourId, juce::Colours::white);
+        op.label.setJustificationType(juce::Justification::centredLeft);
+        addChildComponent(op.label);
+
+        setupSourceSlider(op.ratio, "x");
+        setupSourceSlider(op.level, " lvl");
+        setupSourceSlider(op.feedback, " fb");
+
+        op.ratioAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            audioProcessor.apvts, prefix + "RATIO", op.ratio);
+        op.levelAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            audioProcessor.apvts, prefix + "LEVEL", op.level);
+        op.feedbackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            audioProcessor.apvts, prefix + "FEEDBACK", op.feedback);
+    }
+
+    fmModEnvLabel.setText("Mod Env", juce::dontSendNotification);
+    fmModEnvLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    fmModEnvLabel.setJustificationType(juce::Justification::centredLeft);
+    addChildComponent(fmModEnvLabel);
+
+    setupSourceSlider(fmModDecaySlider, " s");
+    setupSourceSlider(fmModSustainSlider, "");
+    fmModDecayAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "FM_MOD_DECAY", fmModDecaySlider);
+    fmModSustainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "FM_MOD_SUSTAIN", fmModSustainSlider);
+
+    // Aditiva: espectro y envelope de los parciales, en dos columnas
+    for (auto *label : {&additiveSpectrumLabel, &additiveEnvLabel})
+    {
+        label->setColour(juce::Label::textColourId, juce::Colours::white);
+        label->setJustificationType(juce::Justification::centredLeft);
+        addChildComponent(*label);
+    }
+    additiveSpectrumLabel.setText("Spectrum", juce::dontSendNotification);
+    additiveEnvLabel.setText("Partial Env", juce::dontSendNotification);
+
+    setupSourceSlider(additivePartialsSlider, " p");
+    setupSourceSlider(additiveTiltSlider, " tilt");
+    setupSourceSlider(additiveEvenSlider, " even");
+    setupSourceSlider(additiveDecaySlider, " s");
+    setupSourceSlider(additiveDampingSlider, " damp");
+    setupSourceSlider(additiveSustainSlider, " sus");
+
+    const std::pair<const char *, juce::Slider *> additiveParameters[] = {
+        {"ADD_PARTIALS", &additivePartialsSlider}, {"ADD_TILT", &additiveTiltSlider},
+        {"ADD_EVEN", &additiveEvenSlider}, {"ADD_DECAY", &additiveDecaySlider},
+        {"ADD_DAMPING", &additiveDampingSlider}, {"ADD_SUSTAIN", &additiveSustainSlider}};
+    for (size_t i = 0; i < additiveAttachments.size(); ++i)
+        additiveAttachments[i] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            audioProcessor.apvts, additiveParameters[i].first, *additiveParameters[i].second);
+
+    // Wavetable importada: cargar un WAV y la posición del morph
+    wavetableLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    wavetableLabel.setJustificationType(juce::Justification::centredLeft);
+    addChildComponent(wavetableLabel);
+
+    wavetableLoadButton.onClick = [this]
+    {
+        wavetableChooser = std::make_unique<juce::FileChooser>("Load wavetable", juce::File(), "*.wav");
+        wavetableChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                      [this](const juce::FileChooser &chooser)
+                                      {
+                                          const auto file = chooser.getResult();
+                                          if (file == juce::File())
+                                              return;
+
+                                          juce::String error;
+                                          if (!audioProcessor.loadWavetableFile(file, &error))
+                                              juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+                                                                                     "Wavetable", file.getFileName() + ": " + error);
+                                          updateWavetableLabel();
+                                      });
+    };
+    addChildComponent(wavetableLoadButton);
+
+    setupSourceSlider(wavePositionSlider, " pos");
+    wavePositionAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "WAVE_POSITION", wavePositionSlider);
+    updateWavetableLabel();
+
+    updateSourceControls();
+
     // MIDI Keyboard
 
     addAndMakeVisible(keyboardComponent);
+
+    // Scope / spectrum
+
+    addAndMakeVisible(analyzer);
+
+    // CPU load meter
+    cpuResetButton.onClick = [this]
+    {
+        audioProcessor.resetCpuLoadStatistics();
+        audioProcessor.resetVoiceTelemetry();
+    };
+    addAndMakeVisible(cpuResetButton);
+
+    governorToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    addAndMakeVisible(governorToggle);
+    governorAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.apvts, "GOVERNOR", governorToggle);
+
+    sustainCacheToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    addAndMakeVisible(sustainCacheToggle);
+    sustainCacheAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.apvts, "SUSTAIN_CACHE", sustainCacheToggle);
+
+#if TEC_ENABLE_TRACING
+    traceDumpButton.onClick = []
+    {
+        auto file = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+                        .getChildFile("TECSynth-trace.json");
+        TraceRecorder::writeChromeJson(file);
+    };
+    addAndMakeVisible(traceDumpButton);
+#endif
+
+    startTimerHz(15);
+}
+
+void GUI::timerCallback()
+{
+    cpuLoad = audioProcessor.getCpuLoadSnapshot();
+    governorStatus = audioProcessor.getQualityGovernorStatus();
+    repaint(cpuMeterArea);
+
+    voiceActivity = audioProcessor.getVoiceTelemetrySnapshot();
+    repaint(voiceActivityArea);
+
+    const auto usage = audioProcessor.getMemoryUsage();
+    if (usage.totalBytes != memoryUsage.totalBytes || usage.peakTotalBytes != memoryUsage.peakTotalBytes ||
+        usage.mappedWavetableBytes != memoryUsage.mappedWavetableBytes)
+    {
+        memoryUsage = usage;
+        repaint(memoryArea);
+    }
+    updateTuningLabel();
+    updateWavetableLabel();
+}
+
+// Capas, FM, aditiva o wavetable según OSC_MODE (0 = Single, 1 = Layer, 2 = FM, 3 = Additive, 4 = Wavetable)
+void GUI::updateSourceControls()
+{
+    const int mode = oscModeSelector.getSelectedItemIndex();
+    const bool fm = mode == 2;
+    const bool additive = mode == 3;
+    const bool userWavetable = mode == 4;
+    const bool layers = !fm && !additive && !userWavetable;
+
+    for (auto &layer : layerControls)
+    {
+        layer.label.setVisible(layers);
+        layer.level.setVisible(layers);
+        layer.octave.setVisible(layers);
+        layer.detune.setVisible(layers);
+        layer.sync.setVisible(layers);
+    }
+
+    for (auto &op : operatorControls)
+    {
+        op.label.setVisible(fm);
+        op.ratio.setVisible(fm);
+        op.level.setVisible(fm);
+        op.feedback.setVisible(fm);
+    }
+
+    fmAlgorithmSelector.setVisible(fm);
+    fmModEnvLabel.setVisible(fm);
+    fmModDecaySlider.setVisible(fm);
+    fmModSustainSlider.setVisible(fm);
+
+    additiveSpectrumLabel.setVisible(additive);
+    additiveEnvLabel.setVisible(additive);
+    for (auto *slider : {&additivePartialsSlider, &additiveTiltSlider, &additiveEvenSlider,
+                         &additiveDecaySlider, &additiveDampingSlider, &additiveSustainSlider})
+        slider->setVisible(additive);
+
+    wavetableLabel.setVisible(userWavetable);
+    wavetableLoadButton.setVisible(userWavetable);
+    wavePositionSlider.setVisible(userWavetable);
+}
+
+void GUI::updateWavetableLabel()
+{
+    const auto status = audioProcessor.getWavetableStatus();
+    juce::String text = "Wavetable: ";
+    if (status.name.isEmpty())
+        text << "none";
+    else if (status.loading)
+        text << status.name << " (loading...)";
+    else if (status.numFrames == 0)
+        text << status.name << " (not found)";
+    else
+        text << status.name << " (" << status.numFrames << " frames" << (status.mapped ? ", cached)" : ")");
+
+    if (wavetableLabel.getText() != text)
+        wavetableLabel.setText(text, juce::dontSendNotification);
+}
+
+void GUI::updateTuningLabel()
+{
+    const auto text = "Tuning: " + audioProcessor.getTuning().get().description;
+    if (tuningLabel.getText() != text)
+        tuningLabel.setText(text, juce::dontSendNotification);
+}
+
+void GUI::updatePresetSelector()
+{
+    presetSelector.clear(juce::dontSendNotification);
+    for (int i = 0; i < audioProcessor.getNumPrograms(); ++i)
+        presetSelector.addItem(audioProcessor.getProgramName(i), i + 1);
+    presetSelector.setSelectedId(audioProcessor.getCurrentProgram() + 1, juce::dontSendNotification);
+}
+
+void GUI::drawCpuMeter(juce::Graphics &g, juce::Rectangle<int> bounds) const
+{
+    auto barArea = bounds.removeFromLeft(200).reduced(0, 6);
+    bounds.removeFromLeft(10);
+
+    // Bar covers 0..100% of the block budget
+    g.setColour(juce::Colours::darkgrey);
+    g.fillRect(barArea);
+
+    const float load = juce::jlimit(0.0f, 1.0f, cpuLoad.lastLoad);
+    const juce::Colour barColour = cpuLoad.lastLoad >= 1.0f  ? juce::Colours::red
+                                   : cpuLoad.lastLoad >= 0.7f ? juce::Colours::orange
+                                                              : juce::Colours::limegreen;
+    g.setColour(barColour);
+    g.fillRect(barArea.withWidth(juce::roundToInt(barArea.getWidth() * load)));
+
+    // Peak marker
+    const float peak = juce::jlimit(0.0f, 1.0f, cpuLoad.peakLoad);
+    const int peakX = barArea.getX() + juce::roundToInt(barArea.getWidth() * peak);
+    g.setColour(juce::Colours::white);
+    g.drawVerticalLine(juce::jmin(peakX, barArea.getRight() - 1),
+                       float(barArea.getY()), float(barArea.getBottom()));
+
+    auto percent = [](float v)
+    { return juce::String(juce::roundToInt(v * 100.0f)) + "%"; };
+
+    g.setFont(13.f);
+    g.drawText("CPU " + percent(cpuLoad.lastLoad) +
+                   "  avg " + percent(cpuLoad.averageLoad) +
+                   "  p50 " + percent(cpuLoad.p50Load) +
+                   "  p99 " + percent(cpuLoad.p99Load) +
+                   "  peak " + percent(cpuLoad.peakLoad) +
+                   "  xruns " + juce::String((juce::int64)cpuLoad.numXruns) +
+                   "  quality " + juce::String(governorStatus.levelName) +
+                   " (" + juce::String((int)governorStatus.numDownshifts) + " down)" +
+                   "  DSP " + juce::String(KernelDispatch::get().name),
+               bounds, juce::Justification::centredLeft);
 }
 
 void GUI::paint(juce::Graphics &g)
@@ -130,8 +560,14 @@ void GUI::paint(juce::Graphics &g)
 
     const int margin = 10;
     const int keyboardHeight = 100;
+    const int statusHeight = 70;
+    const int analyzerHeight = 160;
+    const int layersHeight = 120;
     auto area = getLocalBounds().reduced(margin);
+    area.removeFromTop(statusHeight);
     auto keyboardArea = area.removeFromBottom(keyboardHeight);
+    area.removeFromBottom(analyzerHeight);
+    auto layersArea = area.removeFromBottom(layersHeight);
     auto controlArea = area;
 
     // Split into 3 sections
@@ -143,12 +579,14 @@ void GUI::paint(juce::Graphics &g)
     g.fillRect(oscArea);
     g.fillRect(envArea);
     g.fillRect(filterArea);
+    g.fillRect(layersArea);
 
     g.setColour(juce::Colours::white);
     g.setFont(20.f);
     g.drawText("OSCILLATOR", oscArea, juce::Justification::centredTop);
     g.drawText("ENVELOPE", envArea, juce::Justification::centredTop);
-    g.drawText("FILTER", filterArea, juce::Justification::centredTop);
+    g.drawText("FILTER / PITCH", filterArea, juce::Justification::centredTop);
+    g.drawText("SOURCE", layersArea.reduced(10, 0).withWidth(140), juce::Justification::centredTop);
     g.drawText("MIDI KEYBOARD", keyboardArea, juce::Justification::centredTop);
 
     // Borders
@@ -156,16 +594,44 @@ void GUI::paint(juce::Graphics &g)
     g.drawRect(oscArea);
     g.drawRect(envArea);
     g.drawRect(filterArea);
+    g.drawRect(layersArea);
     g.drawRect(keyboardArea);
+
+    drawCpuMeter(g, cpuMeterArea);
+
+    g.setColour(juce::Colours::white);
+    g.setFont(13.f);
+    g.drawText(memoryUsage.toSummaryString(), memoryArea, juce::Justification::centredLeft);
+    g.drawText(voiceActivity.toSummaryString(), voiceActivityArea, juce::Justification::centredLeft);
 }
 
 void GUI::resized()
 {
     const int margin = 10;
     const int keyboardHeight = 100;
+    const int statusHeight = 70;
+    const int analyzerHeight = 160;
+    const int layersHeight = 120;
 
     auto area = getLocalBounds().reduced(margin);
+    auto statusArea = area.removeFromTop(statusHeight);
+    voiceActivityArea = statusArea.removeFromBottom(20);
+    memoryArea = statusArea.removeFromBottom(20);
     auto keyboardArea = area.removeFromBottom(keyboardHeight);
+    auto analyzerArea = area.removeFromBottom(analyzerHeight);
+    auto layersArea = area.removeFromBottom(layersHeight);
+
+    //  Status strip: CPU meter + reset
+    cpuResetButton.setBounds(statusArea.removeFromRight(70).reduced(0, 3));
+    statusArea.removeFromRight(6);
+    governorToggle.setBounds(statusArea.removeFromRight(100).reduced(0, 3));
+    statusArea.removeFromRight(6);
+    sustainCacheToggle.setBounds(statusArea.removeFromRight(120).reduced(0, 3));
+#if TEC_ENABLE_TRACING
+    statusArea.removeFromRight(6);
+    traceDumpButton.setBounds(statusArea.removeFromRight(100).reduced(0, 3));
+#endif
+    cpuMeterArea = statusArea;
 
     auto controlArea = area;
     auto oscArea = controlArea.removeFromLeft(controlArea.getWidth() / 3);
@@ -181,6 +647,18 @@ void GUI::resized()
     waveSelector.setBounds(oscContent.removeFromTop(40).reduced(0, 5));
     velocityLabel.setBounds(oscContent.removeFromTop(20));
     velocitySlider.setBounds(oscContent.removeFromTop(40).reduced(0, 5));
+    pulseWidthLabel.setBounds(oscContent.removeFromTop(20));
+    pulseWidthSlider.setBounds(oscContent.removeFromTop(40).reduced(0, 5));
+    presetLabel.setBounds(oscContent.removeFromTop(20));
+    auto presetRow = oscContent.removeFromTop(40).reduced(0, 5);
+    presetSaveButton.setBounds(presetRow.removeFromRight(presetRow.getWidth() / 3));
+    presetRow.removeFromRight(6);
+    presetSelector.setBounds(presetRow);
+    tuningLabel.setBounds(oscContent.removeFromTop(20));
+    auto tuningRow = oscContent.removeFromTop(40).reduced(0, 5);
+    tuningResetButton.setBounds(tuningRow.removeFromRight(tuningRow.getWidth() / 3));
+    tuningRow.removeFromRight(6);
+    tuningLoadButton.setBounds(tuningRow);
 
     //  Envelope Layout
     auto envContent = envArea.reduced(20, 10);
@@ -209,11 +687,84 @@ void GUI::resized()
     filterContent.removeFromTop(topPadding);
 
     filterTypeLabel.setBounds(filterContent.removeFromTop(18));
-    filterTypeSelector.setBounds(filterContent.removeFromTop(28).reduced(0, 2));
+    auto filterTypeRow = filterContent.removeFromTop(28).reduced(0, 2);
+    filterModeSelector.setBounds(filterTypeRow.removeFromRight(filterTypeRow.getWidth() / 2));
+    filterTypeRow.removeFromRight(6);
+    filterTypeSelector.setBounds(filterTypeRow);
     filterContent.removeFromTop(sliderGap);
 
     filterCutoffLabel.setBounds(filterContent.removeFromTop(18));
     filterCutoffSlider.setBounds(filterContent.removeFromTop(28).reduced(0, 2));
+    filterContent.removeFromTop(sliderGap);
+
+    glideLabel.setBounds(filterContent.removeFromTop(18));
+    glideSlider.setBounds(filterContent.removeFromTop(28).reduced(0, 2));
+    filterContent.removeFromTop(sliderGap);
+
+    vibratoRateLabel.setBounds(filterContent.removeFromTop(18));
+    vibratoRateSlider.setBounds(filterContent.removeFromTop(28).reduced(0, 2));
+    filterContent.removeFromTop(sliderGap);
+
+    vibratoDepthLabel.setBounds(filterContent.removeFromTop(18));
+    vibratoDepthSlider.setBounds(filterContent.removeFromTop(28).reduced(0, 2));
+    filterContent.removeFromTop(sliderGap);
+
+    bendRangeLabel.setBounds(filterContent.removeFromTop(18));
+    bendRangeSlider.setBounds(filterContent.removeFromTop(28).reduced(0, 2));
+
+    //  Source: modo (y algoritmo FM) a la izquierda, debajo del título; luego las
+    //  columnas de capas, de operadores, de la aditiva o de la wavetable, en el mismo lugar (solo unas son visibles)
+    auto layersContent = layersArea.reduced(10, 5);
+    auto modeColumn = layersContent.removeFromLeft(140);
+    modeColumn.removeFromTop(30);
+    oscModeSelector.setBounds(modeColumn.removeFromTop(28).reduced(0, 2));
+    modeColumn.removeFromTop(4);
+    fmAlgorithmSelector.setBounds(modeColumn.removeFromTop(28).reduced(0, 2));
+    layersContent.removeFromLeft(10);
+
+    auto fmContent = layersContent;
+    const int operatorWidth = fmContent.getWidth() / int(operatorControls.size() + 1);
+    auto placeColumn = [](juce::Rectangle<int> column, juce::Label &label,
+                          std::initializer_list<juce::Slider *> sliders)
+    {
+        label.setBounds(column.removeFromTop(22));
+        for (auto *slider : sliders)
+            slider->setBounds(column.removeFromTop(26).reduced(0, 2));
+    };
+    for (auto &op : operatorControls)
+        placeColumn(fmContent.removeFromLeft(operatorWidth).reduced(4, 0), op.label,
+                    {&op.ratio, &op.level, &op.feedback});
+    placeColumn(fmContent.reduced(4, 0), fmModEnvLabel, {&fmModDecaySlider, &fmModSustainSlider});
+
+    auto additiveContent = layersContent;
+    const int additiveWidth = additiveContent.getWidth() / 3;
+    placeColumn(additiveContent.removeFromLeft(additiveWidth).reduced(4, 0), additiveSpectrumLabel,
+                {&additivePartialsSlider, &additiveTiltSlider, &additiveEvenSlider});
+    placeColumn(additiveContent.removeFromLeft(additiveWidth).reduced(4, 0), additiveEnvLabel,
+                {&additiveDecaySlider, &additiveDampingSlider, &additiveSustainSlider});
+
+    auto wavetableContent = layersContent.withWidth(additiveWidth * 2).reduced(4, 0);
+    wavetableLabel.setBounds(wavetableContent.removeFromTop(22));
+    wavetableLoadButton.setBounds(wavetableContent.removeFromTop(26).reduced(0, 2).withWidth(120));
+    wavePositionSlider.setBounds(wavetableContent.removeFromTop(26).reduced(0, 2));
+
+    const int layerWidth = layersContent.getWidth() / int(layerControls.size());
+    for (auto &layer : layerControls)
+    {
+        auto column = layersContent.removeFromLeft(layerWidth).reduced(6, 0);
+        auto header = column.removeFromTop(22);
+        layer.sync.setBounds(header.removeFromRight(70));
+        layer.label.setBounds(header);
+        layer.level.setBounds(column.removeFromTop(28).reduced(0, 2));
+        column.removeFromTop(4);
+        auto pitchRow = column.removeFromTop(28).reduced(0, 2);
+        layer.octave.setBounds(pitchRow.removeFromLeft(pitchRow.getWidth() / 2).withTrimmedRight(3));
+        layer.detune.setBounds(pitchRow.withTrimmedLeft(3));
+    }
+
+    //  Scope / spectrum
+    analyzer.setBounds(analyzerArea.reduced(0, 5));
+
     //  MIDI keyboard
     keyboardComponent.setBounds(keyboardArea);
 }
@@ -1,5 +1,12 @@
 #pragma once
 #include <JuceHeader.h>
+#include "Performance/CpuLoadMeter.h"
+#include "Performance/MemoryUsage.h"
+#include "Performance/QualityGovernor.h"
+#include "Performance/Trace.h"
+#include "Performance/VoiceTelemetry.h"
+#include "Visualizer/AnalyzerComponent.h"
+#include <array>
 
 class AudioPluginAudioProcessor;
 
@@ -16,8 +23,15 @@ class AudioPluginAudioProcessor;
  * The GUI communicates with the processor through the
  * AudioProcessorValueTreeState attachments, ensuring automatic
  * synchronization between UI components and internal parameters.
+ *
+ * A status strip at the top shows the processBlock CPU load meter,
+ * refreshed by a timer on the message thread. Below the controls, the
+ * SOURCE strip sets the oscillator mode and its layers, FM operators, additive
+ * spectrum or imported wavetable; above the keyboard, an AnalyzerComponent draws the scope and
+ * spectrum of the synth output.
  */
-class GUI : public juce::AudioProcessorEditor
+class GUI : public juce::AudioProcessorEditor,
+            private juce::Timer
 {
 public:
     /**
@@ -50,6 +64,53 @@ public:
     void resized() override;
 
 private:
+    /** @brief Polls the processor's CPU load statistics and repaints the meter. */
+    void timerCallback() override;
+
+    /**
+     * @brief Draws the CPU load bar and its statistics line.
+     * @param g Graphics context.
+     * @param bounds Area reserved for the meter.
+     */
+    void drawCpuMeter(juce::Graphics &g, juce::Rectangle<int> bounds) const;
+
+    /** @brief Area of the CPU meter, updated in resized(). */
+    juce::Rectangle<int> cpuMeterArea;
+
+    /** @brief Last statistics read from the processor. */
+    CpuLoadMeter::Snapshot cpuLoad;
+
+    /** @brief Last quality governor state read from the processor. */
+    QualityGovernor::Status governorStatus;
+
+    /** @brief Memory line below the CPU meter, updated in resized(). */
+    juce::Rectangle<int> memoryArea;
+
+    /** @brief Last memory report read from the processor. */
+    MemoryUsage memoryUsage;
+
+    /** @brief Voice activity line below the memory line, updated in resized(). */
+    juce::Rectangle<int> voiceActivityArea;
+
+    /** @brief Last voice telemetry read from the processor. */
+    VoiceTelemetry::Snapshot voiceActivity;
+
+    /** @brief Toggles the adaptive quality governor. */
+    juce::ToggleButton governorToggle{"Governor"};
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> governorAttachment;
+
+    /** @brief Toggles the sustain cache (replay of settled held notes). */
+    juce::ToggleButton sustainCacheToggle{"Sustain cache"};
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> sustainCacheAttachment;
+
+    /** @brief Clears peak, percentiles and xrun count, and the voice counters. */
+    juce::TextButton cpuResetButton{"Reset"};
+
+#if TEC_ENABLE_TRACING
+    /** @brief Writes the trace rings to TECSynth-trace.json on the desktop. */
+    juce::TextButton traceDumpButton{"Dump trace"};
+#endif
+
     /** @brief Reference to the owning AudioProcessor. */
     AudioPluginAudioProcessor &audioProcessor;
 
@@ -63,12 +124,37 @@ private:
     /** @brief Menu → APVTS attachment for waveform selection. */
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> waveAttachment;
 
+    /** @brief Program (preset) selector; switching is an atomic snapshot swap in the processor. */
+    juce::ComboBox presetSelector;
+    juce::Label presetLabel;
+
+    /** @brief Saves the current sound as a user preset, asking for its name. */
+    juce::TextButton presetSaveButton{"Save..."};
+    std::unique_ptr<juce::AlertWindow> presetNameWindow;
+
+    /** @brief Refills the preset selector from the processor's programs. */
+    void updatePresetSelector();
+
+    /** @brief Scala tuning: load a .scl file or go back to 12-TET; the label shows the scale. */
+    juce::TextButton tuningLoadButton{"Tuning..."};
+    juce::TextButton tuningResetButton{"12-TET"};
+    juce::Label tuningLabel;
+    std::unique_ptr<juce::FileChooser> tuningChooser;
+
+    /** @brief Shows the current tuning's description (also follows host state restores). */
+    void updateTuningLabel();
+
     /** @brief Slider controlling global amplitude or note velocity. */
     juce::Slider velocitySlider;
 
     /** @brief Slider → APVTS attachment for amplitude. */
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> velocityAttachment;
 
+    /** @brief Pulse width of the Square waveform (0.5 = square). */
+    juce::Slider pulseWidthSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> pulseWidthAttachment;
+    juce::Label pulseWidthLabel;
+
     //  ADSR Sliders
     juce::Slider attackSlider;
     juce::Slider decaySlider;
@@ -95,12 +181,109 @@ private:
     juce::ComboBox filterTypeSelector;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> filterTypeAttachment;
 
+    /** @brief Per-voice or paraphonic (one filter on the voice mix). */
+    juce::ComboBox filterModeSelector;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> filterModeAttachment;
+
     // Labels
     juce::Label filterCutoffLabel;
     juce::Label filterTypeLabel;
 
+    // SOURCE UI: oscillator mode, then the layer, FM, additive or wavetable controls, between the controls and the analyzer
+    /** @brief Oscillator mode: single waveform, layers, FM, additive or imported wavetable. */
+    juce::ComboBox oscModeSelector;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oscModeAttachment;
+
+    /** @brief Controls of one layer (level, octave, detune, sync). */
+    struct LayerControls
+    {
+        juce::Label label;
+        juce::Slider level;
+        juce::Slider octave;
+        juce::Slider detune;
+        juce::ToggleButton sync{"Sync"};
+
+        std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> levelAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> octaveAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> detuneAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> syncAttachment;
+    };
+
+    /** @brief Sine, Saw, Square, Triangle. */
+    std::array<LayerControls, 4> layerControls;
+
+    /** @brief FM algorithm (shown in FM mode). */
+    juce::ComboBox fmAlgorithmSelector;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> fmAlgorithmAttachment;
+
+    /** @brief Controls of one FM operator (ratio, level, feedback). */
+    struct OperatorControls
+    {
+        juce::Label label;
+        juce::Slider ratio;
+        juce::Slider level;
+        juce::Slider feedback;
+
+        std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> ratioAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> levelAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> feedbackAttachment;
+    };
+
+    /** @brief Operators 1–6. */
+    std::array<OperatorControls, 6> operatorControls;
+
+    /** @brief Decay and sustain of the FM modulator envelope. */
+    juce::Label fmModEnvLabel;
+    juce::Slider fmModDecaySlider;
+    juce::Slider fmModSustainSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> fmModDecayAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> fmModSustainAttachment;
+
+    /** @brief Additive spectrum (partials, tilt, even level) and partial envelope (decay, damping, sustain). */
+    juce::Label additiveSpectrumLabel;
+    juce::Label additiveEnvLabel;
+    juce::Slider additivePartialsSlider;
+    juce::Slider additiveTiltSlider;
+    juce::Slider additiveEvenSlider;
+    juce::Slider additiveDecaySlider;
+    juce::Slider additiveDampingSlider;
+    juce::Slider additiveSustainSlider;
+    std::array<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>, 6> additiveAttachments;
+
+    /** @brief Imported wavetable: load a WAV, morph position; the label shows the table and its state. */
+    juce::Label wavetableLabel;
+    juce::TextButton wavetableLoadButton{"Load WAV..."};
+    juce::Slider wavePositionSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> wavePositionAttachment;
+    std::unique_ptr<juce::FileChooser> wavetableChooser;
+
+    /** @brief Shows the layer, FM, additive or wavetable controls, following OSC_MODE. */
+    void updateSourceControls();
+
+    /** @brief Shows the imported wavetable's name, frame count and loading state. */
+    void updateWavetableLabel();
+
+    // PITCH UI (bend, glide, vibrato), below the filter
+    juce::Slider glideSlider;
+    juce::Slider vibratoRateSlider;
+    juce::Slider vibratoDepthSlider;
+    juce::Slider bendRangeSlider;
+
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> glideAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> vibratoRateAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> vibratoDepthAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> bendRangeAttachment;
+
+    juce::Label glideLabel;
+    juce::Label vibratoRateLabel;
+    juce::Label vibratoDepthLabel;
+    juce::Label bendRangeLabel;
+
     /** @brief On-screen MIDI keyboard for manual note triggering. */
     juce::MidiKeyboardComponent keyboardComponent;
 
+    /** @brief Oscilloscope + spectrum of the output, fed by the processor's ScopeFifo. */
+    AnalyzerComponent analyzer;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GUI)
 };
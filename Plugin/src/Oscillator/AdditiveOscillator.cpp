@@ -0,0 +1,366 @@
+#include "AdditiveOscillator.h"
+#include "DSP/KernelDispatch.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr int lanes = DspKernels::partialLanes;
+
+    /** @brief log2 of a power of two. */
+    int log2Of(int size)
+    {
+        int order = 0;
+        while ((1 << order) < size)
+            ++order;
+        return order;
+    }
+
+    /** @brief ns per partial and sample of the oscillator path (x86-64, Release; NEON taken as SSE2). */
+    float getPartialCost(KernelIsa isa)
+    {
+        switch (isa)
+        {
+        case KernelIsa::SSE2:
+        case KernelIsa::NEON:
+            return 0.6f;
+        case KernelIsa::AVX2:
+            return 0.43f;
+        case KernelIsa::AVX512:
+            return 0.3f;
+        case KernelIsa::Scalar:
+            break;
+        }
+        return 2.7f;
+    }
+
+    /** @brief Spectral path: ns per point and stage of the inverse FFT, and per sample of the reads. */
+    constexpr float fftCost = 1.0f;
+    constexpr float tableReadCost = 7.0f;
+}
+
+AdditiveOscillator::Path AdditiveOscillator::getCheaperPath(int numPartials)
+{
+    if (numPartials <= 0)
+        return Path::Oscillators;
+
+    const int padded = (numPartials + lanes - 1) / lanes * lanes;
+    const float oscillatorCost = float(padded) * getPartialCost(KernelDispatch::get().isa);
+
+    const int tableSize = getTableSize(numPartials);
+    const float spectralCost = fftCost * float(tableSize * log2Of(tableSize)) / float(frameSize) + tableReadCost;
+
+    return spectralCost < oscillatorCost ? Path::Spectral : Path::Oscillators;
+}
+
+int AdditiveOscillator::getTableSize(int numPartials)
+{
+    int size = 16;
+    while (size < 16 * numPartials && size < maxTableSize)
+        size <<= 1;
+    return size;
+}
+
+AdditiveOscillator::AdditiveOscillator()
+    : fft(log2Of(maxTableSize))
+{
+    const auto count = size_t(maxPartials);
+    levels.assign(count, 0.0f);
+    decayFactors.assign(count, 1.0f);
+    envelopes.assign(count, 1.0f);
+    frameStart.assign(count, 0.0f);
+    frameEnd.assign(count, 0.0f);
+    frameStep.assign(count, 0.0f);
+
+    phasorRe.assign(count, 1.0f);
+    phasorIm.assign(count, 0.0f);
+    rotationRe.assign(count, 1.0f);
+    rotationIm.assign(count, 0.0f);
+
+    spectrumRe.assign(size_t(maxTableSize / 2 + 1), 0.0f);
+    spectrumIm.assign(size_t(maxTableSize / 2 + 1), 0.0f);
+    for (auto &table : tables)
+        table.assign(size_t(maxTableSize), 0.0f);
+    tableSizes.fill(getTableSize(1));
+
+    updateSpectrum();
+}
+
+void AdditiveOscillator::setSampleRate(double fs)
+{
+    sampleRate = fs;
+    spectrumDirty = true;
+}
+
+void AdditiveOscillator::setSettings(const Settings &newSettings)
+{
+    if (newSettings == settings)
+        return;
+
+    settings = newSettings;
+    spectrumDirty = true;
+}
+
+/** @brief pow() and exp() per partial: only after a change, at the next frame. */
+void AdditiveOscillator::updateSpectrum()
+{
+    const int count = std::clamp(settings.partials, 1, maxPartials);
+    const double decay = std::max(1.0e-3, double(settings.decay));
+
+    double sum = 0.0;
+    for (int k = 0; k < maxPartials; ++k)
+    {
+        const double harmonic = double(k + 1);
+        double level = 0.0;
+        if (k < count)
+        {
+            level = std::pow(harmonic, -double(settings.tilt));
+            if ((k + 1) % 2 == 0)
+                level *= double(settings.evenLevel);
+        }
+        levels[size_t(k)] = float(level);
+        sum += level;
+
+        const double timeConstant = decay / std::pow(harmonic, double(settings.damping));
+        decayFactors[size_t(k)] = float(std::exp(-double(frameSize) / (timeConstant * sampleRate)));
+    }
+
+    if (sum > 0.0)
+        for (auto &level : levels)
+            level = float(double(level) / sum);
+
+    spectrumDirty = false;
+}
+
+void AdditiveOscillator::noteOn()
+{
+    phase = 0.0;
+    std::fill(envelopes.begin(), envelopes.end(), 1.0f);
+    framePosition = frameSize;
+    phasorRatio = 0.0;
+    spectralFrame = false;
+}
+
+int AdditiveOscillator::getPaddedPartials() const
+{
+    return (activePartials + lanes - 1) / lanes * lanes;
+}
+
+/**
+ * @brief Moves the partial envelopes one frame ahead and sets up the frame.
+ *
+ * Each partial ramps from its amplitude now to its amplitude one frame
+ * later. Partials at or above Nyquist (at the frame's first pitch ratio)
+ * get zero. Only the partials in settings.partials move: a partial added
+ * while the note plays starts its envelope from the top.
+ */
+void AdditiveOscillator::startFrame(float ratio)
+{
+    if (spectrumDirty)
+        updateSpectrum();
+
+    const double delta = phaseDelta * double(ratio);
+    int belowNyquist = maxPartials;
+    if (delta > 0.0)
+        belowNyquist = std::min(maxPartials, int(std::ceil(0.5 / delta)) - 1);
+
+    const float sustain = settings.sustain;
+    const float silence = silenceLevel * amplitude;
+    const float toStep = 1.0f / float(frameSize);
+    int active = 0;
+
+    // Levels are zero from settings.partials on; the rest of the lanes is cleared
+    const int count = std::min(maxPartials, (std::clamp(settings.partials, 1, maxPartials) + lanes - 1) / lanes * lanes);
+    for (int k = 0; k < count; ++k)
+    {
+        const auto index = size_t(k);
+        const float gain = amplitude * levels[index];
+        const float start = gain * (sustain + (1.0f - sustain) * envelopes[index]);
+        envelopes[index] *= decayFactors[index];
+        const float end = gain * (sustain + (1.0f - sustain) * envelopes[index]);
+
+        const bool audible = k < belowNyquist;
+        frameStart[index] = audible ? start : 0.0f;
+        frameEnd[index] = audible ? end : 0.0f;
+        frameStep[index] = (frameEnd[index] - frameStart[index]) * toStep;
+
+        if (audible && std::max(start, end) > silence)
+            active = k + 1;
+    }
+    activePartials = active;
+
+    const Path path = requestedPath == Path::Automatic ? getCheaperPath(activePartials) : requestedPath;
+    const bool wasSpectral = spectralFrame;
+    spectralFrame = path == Path::Spectral;
+
+    if (spectralFrame)
+    {
+        // The previous frame's table fades out; rebuilt only after an oscillator frame
+        const int previous = currentTable;
+        currentTable ^= 1;
+        if (!wasSpectral)
+            buildTable(previous, frameStart.data());
+        buildTable(currentTable, frameEnd.data());
+    }
+
+    // Phasors restart from the shared phase each frame (no drift between paths)
+    phasorRatio = 0.0;
+    framePosition = 0;
+}
+
+/** @brief Phasor of partial k: e^(2πi·k·phase), rotated by e^(2πi·k·delta) per sample; in double. */
+void AdditiveOscillator::seedPhasors(double ratio)
+{
+    const double twoPi = 2.0 * M_PI;
+    const double startRe = std::cos(twoPi * phase), startIm = std::sin(twoPi * phase);
+    const double stepRe = std::cos(twoPi * phaseDelta * ratio), stepIm = std::sin(twoPi * phaseDelta * ratio);
+
+    double zRe = startRe, zIm = startIm;
+    double wRe = stepRe, wIm = stepIm;
+    const int count = getPaddedPartials();
+    for (int k = 0; k < count; ++k)
+    {
+        const auto index = size_t(k);
+        phasorRe[index] = float(zRe);
+        phasorIm[index] = float(zIm);
+        rotationRe[index] = float(wRe);
+        rotationIm[index] = float(wIm);
+
+        const double nextZ = zRe * startRe - zIm * startIm;
+        zIm = zRe * startIm + zIm * startRe;
+        zRe = nextZ;
+        const double nextW = wRe * stepRe - wIm * stepIm;
+        wIm = wRe * stepIm + wIm * stepRe;
+        wRe = nextW;
+    }
+    phasorRatio = ratio;
+}
+
+/** @brief Bin k + 1 holds partial k as -i·a/2, so the real inverse transform gives Σ a·sin. */
+void AdditiveOscillator::buildTable(int slot, const float *amplitudes)
+{
+    const int size = getTableSize(std::max(1, activePartials));
+    std::fill(spectrumRe.begin(), spectrumRe.begin() + size / 2 + 1, 0.0f);
+    std::fill(spectrumIm.begin(), spectrumIm.begin() + size / 2 + 1, 0.0f);
+    for (int k = 0; k < activePartials; ++k)
+        spectrumIm[size_t(k + 1)] = -0.5f * amplitudes[k];
+
+    fft.performReal(spectrumRe.data(), spectrumIm.data(), tables[size_t(slot)].data(), log2Of(size));
+    tableSizes[size_t(slot)] = size;
+}
+
+void AdditiveOscillator::renderBlock(float *out, int numSamples)
+{
+    while (numSamples > 0)
+    {
+        if (framePosition == frameSize)
+            startFrame(1.0f);
+
+        const int count = std::min(numSamples, frameSize - framePosition);
+        renderPiece(out, nullptr, count);
+        out += count;
+        numSamples -= count;
+    }
+}
+
+void AdditiveOscillator::renderBlockModulated(float *out, const float *ratio, int numSamples)
+{
+    while (numSamples > 0)
+    {
+        if (framePosition == frameSize)
+            startFrame(ratio[0]);
+
+        const int count = std::min(numSamples, frameSize - framePosition);
+        renderPiece(out, ratio, count);
+        out += count;
+        ratio += count;
+        numSamples -= count;
+    }
+}
+
+/**
+ * @brief Renders numSamples of the current frame with its path.
+ *
+ * With a per-sample pitch, the oscillator path rotates each short segment at
+ * the segment's mean ratio and re-derives the phasors from the shared phase,
+ * which follows every sample, at the next segment.
+ */
+void AdditiveOscillator::renderPiece(float *out, const float *ratio, int numSamples)
+{
+    const auto &kernels = KernelDispatch::get();
+
+    if (spectralFrame)
+    {
+        const float *oldTable = tables[size_t(currentTable ^ 1)].data();
+        const float *newTable = tables[size_t(currentTable)].data();
+        const int oldSize = tableSizes[size_t(currentTable ^ 1)];
+        const int newSize = tableSizes[size_t(currentTable)];
+        const float toStep = 1.0f / float(frameSize);
+        const float fade = float(framePosition) * toStep;
+
+        double end;
+        if (ratio != nullptr)
+        {
+            kernels.renderWavetableModulated(oldTable, oldSize, phase, phaseDelta, ratio, 1.0f, true, out, numSamples);
+            end = kernels.renderWavetableModulated(newTable, newSize, phase, phaseDelta, ratio, 1.0f, true,
+                                                   fadeIn.data(), numSamples);
+        }
+        else
+        {
+            kernels.renderWavetable(oldTable, oldSize, phase, phaseDelta, 1.0f, true, out, numSamples);
+            end = kernels.renderWavetable(newTable, newSize, phase, phaseDelta, 1.0f, true, fadeIn.data(), numSamples);
+        }
+        kernels.multiplyByRamp(out, numSamples, 1.0f - fade, -toStep);
+        kernels.multiplyByRamp(fadeIn.data(), numSamples, fade, toStep);
+        kernels.mixInto(out, fadeIn.data(), numSamples);
+
+        phase = end;
+        framePosition += numSamples;
+        return;
+    }
+
+    const int numPartials = getPaddedPartials();
+
+    if (ratio == nullptr)
+    {
+        if (phasorRatio != 1.0)
+            seedPhasors(1.0);
+
+        kernels.renderPartials(phasorRe.data(), phasorIm.data(), rotationRe.data(), rotationIm.data(),
+                               frameStart.data(), frameStep.data(), framePosition, numPartials, out, numSamples);
+
+        const double end = phase + phaseDelta * double(numSamples);
+        phase = end - std::floor(end);
+        framePosition += numSamples;
+        return;
+    }
+
+    for (int start = 0; start < numSamples; start += modulatedSegmentSize)
+    {
+        const int count = std::min(modulatedSegmentSize, numSamples - start);
+        double sum = 0.0;
+        for (int i = 0; i < count; ++i)
+            sum += double(ratio[start + i]);
+
+        seedPhasors(sum / double(count));
+        kernels.renderPartials(phasorRe.data(), phasorIm.data(), rotationRe.data(), rotationIm.data(),
+                               frameStart.data(), frameStep.data(), framePosition, numPartials, out + start, count);
+
+        const double end = phase + phaseDelta * sum;
+        phase = end - std::floor(end);
+        framePosition += count;
+    }
+
+    // The next piece cannot reuse the last segment's rotation
+    phasorRatio = 0.0;
+}
+
+size_t AdditiveOscillator::getMemoryBytes() const
+{
+    size_t floats = levels.capacity() + decayFactors.capacity() + envelopes.capacity() + frameStart.capacity() +
+                    frameEnd.capacity() + frameStep.capacity() + phasorRe.capacity() + phasorIm.capacity() +
+                    rotationRe.capacity() + rotationIm.capacity() + spectrumRe.capacity() + spectrumIm.capacity();
+    for (const auto &table : tables)
+        floats += table.capacity();
+    return floats * sizeof(float) + fft.getMemoryBytes();
+}
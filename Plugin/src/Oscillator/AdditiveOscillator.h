@@ -0,0 +1,186 @@
+#pragma once
+#include "DSP/InverseFFT.h"
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class AdditiveOscillator
+ * @brief Real-time additive voice source: up to 512 harmonic partials, each with its own envelope.
+ *
+ * This is the sum the wave classes compute offline (Saw adds 1/k harmonics
+ * into its tables), done while the note plays, so every partial can follow
+ * its own amplitude curve. The spectrum is set by a few settings: partial
+ * count, spectral tilt, even-partial level, and a decay per partial that
+ * gets shorter towards the top (like a struck string), down to a sustain
+ * level. Attack and release come from the voice's amplitude envelope.
+ *
+ * Amplitudes are computed once per frame (frameSize samples) and ramp
+ * linearly inside it. Each frame is rendered by one of two paths:
+ *  - Oscillators: one phasor per partial, rotated every sample by the
+ *    DspKernels::renderPartials() kernel (partials across vector lanes).
+ *    Cost grows with the partial count.
+ *  - Spectral: the frame's amplitudes go through an inverse FFT into a
+ *    single-cycle table, which is played with the wavetable kernel and
+ *    crossfaded from the previous frame's table (overlap-add of frames
+ *    with triangular windows). Cost grows with the table size, which
+ *    stops growing at maxTableSize.
+ * Both give the same signal (up to table interpolation), and the phasors
+ * are re-derived from the shared phase at every frame, so the path can
+ * change between frames. With Path::Automatic the cheaper one is picked
+ * per frame from the number of partials below Nyquist.
+ *
+ * Partials at or above Nyquist, and partials whose envelope has decayed
+ * to silence, are not rendered. The output never exceeds the amplitude:
+ * levels are normalized to sum to one.
+ *
+ * The constructor allocates; nothing else does (audio thread).
+ */
+class AdditiveOscillator
+{
+public:
+    /** @brief Most partials per voice. */
+    static constexpr int maxPartials = 512;
+
+    /** @brief Samples per frame: amplitude update and spectral table period. */
+    static constexpr int frameSize = 256;
+
+    /** @brief Largest spectral table (4 samples per cycle of partial 512). */
+    static constexpr int maxTableSize = 4 * maxPartials;
+
+    /** @brief How frames are rendered. */
+    enum class Path
+    {
+        Automatic,   ///< Cheaper of the two for the frame's partial count.
+        Oscillators, ///< One rotating phasor per partial.
+        Spectral     ///< Inverse FFT into a table, crossfaded between frames.
+    };
+
+    /** @brief Spectrum and partial envelopes. */
+    struct Settings
+    {
+        int partials = 64;      ///< Number of harmonics, 1–maxPartials.
+        float tilt = 1.0f;      ///< Partial k has level 1 / k^tilt (0 = flat, 1 = saw, 2 = triangle-like).
+        float evenLevel = 1.0f; ///< Gain of the even partials (0 = odd only, square-like).
+        float decay = 2.0f;     ///< Decay time constant of partial 1, in seconds.
+        float damping = 0.5f;   ///< Partial k decays with time constant decay / k^damping.
+        float sustain = 0.3f;   ///< Level each partial decays to, relative to its start, 0–1.
+
+        bool operator==(const Settings &other) const
+        {
+            return partials == other.partials && tilt == other.tilt && evenLevel == other.evenLevel &&
+                   decay == other.decay && damping == other.damping && sustain == other.sustain;
+        }
+        bool operator!=(const Settings &other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Cheaper path for a frame with numPartials partials, for the active kernels.
+     *
+     * Cost model in ns per output sample, from TECBenchmarks
+     * (oscillator/additive): the oscillator path costs a fixed amount per
+     * partial and sample, lower on wider ISAs; the spectral path costs one
+     * inverse FFT per frame plus two table reads per sample.
+     */
+    static Path getCheaperPath(int numPartials);
+
+    /**
+     * @brief Table size of the spectral path for numPartials partials.
+     *
+     * Power of two with 16 samples per cycle of the top partial, so the
+     * interpolated read stays close to the phasors; at most maxTableSize.
+     */
+    static int getTableSize(int numPartials);
+
+    AdditiveOscillator();
+
+    /** @brief Sets the sample rate of the partial decays. */
+    void setSampleRate(double fs);
+
+    /** @brief Sets the spectrum; takes effect at the next frame. */
+    void setSettings(const Settings &settings);
+
+    /** @brief Forces a path (benchmarks, A/B tests); Path::Automatic by default. */
+    void setPath(Path path) { requestedPath = path; }
+
+    /** @brief Path of the current frame. */
+    Path getActivePath() const { return spectralFrame ? Path::Spectral : Path::Oscillators; }
+
+    /** @brief Sets the note's phase increment per sample (frequency / sample rate). */
+    void setPhaseDelta(double delta) { phaseDelta = delta; }
+
+    /** @brief Output gain (velocity); takes effect at the next frame, as a ramp. */
+    void setAmplitude(float amp) { amplitude = amp; }
+
+    /** @brief Restarts the phase and every partial envelope. */
+    void noteOn();
+
+    /** @brief Renders numSamples into out (overwrites). */
+    void renderBlock(float *out, int numSamples);
+
+    /** @brief renderBlock() with per-sample frequency multipliers (pitch bend, glide, vibrato). */
+    void renderBlockModulated(float *out, const float *ratio, int numSamples);
+
+    /** @brief Bytes allocated by the constructor: partial state, phasors, spectrum, tables and FFT. */
+    size_t getMemoryBytes() const;
+
+private:
+    /** @brief Samples per phasor update when the pitch changes every sample. */
+    static constexpr int modulatedSegmentSize = 32;
+
+    /** @brief Partials quieter than this (relative to the amplitude) are not rendered. */
+    static constexpr float silenceLevel = 1.0e-5f;
+
+    /** @brief Recomputes levels and per-frame decay factors from settings. */
+    void updateSpectrum();
+
+    /** @brief Advances the partial envelopes one frame and prepares the frame's path. */
+    void startFrame(float ratio);
+
+    /** @brief Renders up to the end of the current frame. */
+    void renderPiece(float *out, const float *ratio, int numSamples);
+
+    /** @brief Sets every phasor from the shared phase, rotating by phaseDelta · ratio per sample. */
+    void seedPhasors(double ratio);
+
+    /** @brief Partials the oscillator path renders: activePartials rounded up to whole kernel lanes. */
+    int getPaddedPartials() const;
+
+    /** @brief Fills table slot with one cycle of the partials at the given amplitudes. */
+    void buildTable(int slot, const float *amplitudes);
+
+    Settings settings;
+    double sampleRate = 44100.0;
+    Path requestedPath = Path::Automatic;
+
+    double phaseDelta = 440.0 / 44100.0; ///< Phase increment of the note.
+    double phase = 0.0;                  ///< Shared phase of the fundamental, [0, 1).
+    float amplitude = 1.0f;
+
+    // Partial state, one entry per partial (index 0 = fundamental)
+    std::vector<float> levels;       ///< Normalized level of each partial.
+    std::vector<float> decayFactors; ///< Envelope decay per frame.
+    std::vector<float> envelopes;    ///< Decaying part of each envelope, 1 at note-on.
+    std::vector<float> frameStart;   ///< Amplitude at the start of the frame.
+    std::vector<float> frameEnd;     ///< Amplitude at the end of the frame.
+    std::vector<float> frameStep;    ///< Amplitude change per sample in the frame.
+
+    // Oscillator path: phasor and per-sample rotation of each partial
+    std::vector<float> phasorRe, phasorIm, rotationRe, rotationIm;
+
+    // Spectral path: two single-cycle tables (previous and current frame)
+    InverseFFT fft;
+    std::vector<float> spectrumRe, spectrumIm;
+    std::array<std::vector<float>, 2> tables;
+    std::array<int, 2> tableSizes{};
+    int currentTable = 0;
+
+    /** @brief Crossfade buffer of the spectral path. */
+    std::array<float, frameSize> fadeIn{};
+
+    int framePosition = frameSize; ///< Samples rendered in the current frame.
+    int activePartials = 0;        ///< Partials rendered this frame (highest audible index + 1).
+    double phasorRatio = 0.0;      ///< Pitch ratio the phasors rotate at; 0 = reseed before use.
+    bool spectralFrame = false;
+    bool spectrumDirty = true;
+};
@@ -0,0 +1,251 @@
+#include "FMOscillator.h"
+#include "DSP/KernelDispatch.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    /**
+     * @brief One FM algorithm.
+     *
+     * modulators[k] has bit j set when operator j modulates operator k. An
+     * operator is only modulated by higher-numbered ones, so rendering from
+     * the last operator down fills every modulation input before it is read.
+     */
+    struct Algorithm
+    {
+        const char *name;
+        uint8_t modulators[FMOscillator::numOperators];
+        uint8_t carriers;
+    };
+
+    constexpr uint8_t op(int index)
+    {
+        return uint8_t(1u << index);
+    }
+
+    const Algorithm algorithms[FMOscillator::numAlgorithms] = {
+        {"6>5>4>3>2>1", {op(1), op(2), op(3), op(4), op(5), 0}, op(0)},
+        {"3>2>1 + 6>5>4", {op(1), op(2), 0, op(4), op(5), 0}, uint8_t(op(0) | op(3))},
+        {"2>1 + 4>3 + 6>5", {op(1), 0, op(3), 0, op(5), 0}, uint8_t(op(0) | op(2) | op(4))},
+        {"(2 3 4)>1 + 6>5", {uint8_t(op(1) | op(2) | op(3)), 0, 0, 0, op(5), 0}, uint8_t(op(0) | op(4))},
+        {"4>3>2>1 + 6>5>1", {uint8_t(op(1) | op(4)), op(2), op(3), 0, op(5), 0}, op(0)},
+        {"6>5>(1 2 3 4)", {op(4), op(4), op(4), op(4), op(5), 0}, uint8_t(op(0) | op(1) | op(2) | op(3))},
+        {"2>1 + 3 4 5 6", {op(1), 0, 0, 0, 0, 0}, uint8_t(op(0) | op(2) | op(3) | op(4) | op(5))},
+        {"1 2 3 4 5 6", {0, 0, 0, 0, 0, 0}, uint8_t(0x3F)},
+    };
+
+    int countCarriers(uint8_t carriers)
+    {
+        int count = 0;
+        for (int k = 0; k < FMOscillator::numOperators; ++k)
+            count += (carriers >> k) & 1;
+        return count;
+    }
+}
+
+const char *FMOscillator::getAlgorithmName(int index)
+{
+    return index >= 0 && index < numAlgorithms ? algorithms[index].name : nullptr;
+}
+
+/** @brief Operator 1 at unit ratio and full level; the others muted. */
+FMOscillator::FMOscillator()
+{
+    ratios.fill(1.0f);
+    levels[0] = 1.0f;
+    modulatorEnvelope.setParameters(attackTime, modulatorDecay, modulatorSustain, releaseTime);
+}
+
+void FMOscillator::setSource(std::shared_ptr<const WavetableOscillator> sine)
+{
+    source = std::move(sine);
+}
+
+void FMOscillator::setSampleRate(double fs)
+{
+    modulatorEnvelope.setSampleRate(fs);
+}
+
+void FMOscillator::setAlgorithm(int index)
+{
+    algorithm = std::clamp(index, 0, numAlgorithms - 1);
+}
+
+void FMOscillator::setOperator(int index, const OperatorSettings &settings)
+{
+    if (index < 0 || index >= numOperators)
+        return;
+
+    ratios[size_t(index)] = settings.ratio;
+    levels[size_t(index)] = settings.level;
+    feedbacks[size_t(index)] = settings.feedback;
+}
+
+/** @brief Envelope::setParameters() recomputes sample counts: only called on a change. */
+void FMOscillator::setModulatorEnvelope(float attack, float decay, float sustain, float release)
+{
+    if (attack == attackTime && decay == modulatorDecay && sustain == modulatorSustain && release == releaseTime)
+        return;
+
+    attackTime = attack;
+    modulatorDecay = decay;
+    modulatorSustain = sustain;
+    releaseTime = release;
+    modulatorEnvelope.setParameters(attackTime, modulatorDecay, modulatorSustain, releaseTime);
+}
+
+void FMOscillator::noteOn()
+{
+    phases.fill(0.0);
+    for (auto &state : feedbackStates)
+        state.fill(0.0f);
+    modulatorEnvelope.enterAttack();
+}
+
+void FMOscillator::noteOff()
+{
+    modulatorEnvelope.enterRelease();
+}
+
+void FMOscillator::renderBlock(float *out, int numSamples)
+{
+    for (int start = 0; start < numSamples; start += pieceSize)
+        renderPiece(out + start, nullptr, std::min(pieceSize, numSamples - start));
+}
+
+void FMOscillator::renderBlockModulated(float *out, const float *ratio, int numSamples)
+{
+    for (int start = 0; start < numSamples; start += pieceSize)
+        renderPiece(out + start, ratio + start, std::min(pieceSize, numSamples - start));
+}
+
+/**
+ * @brief Audible carriers, then every modulator with a level that reaches one.
+ *
+ * Targets have lower indices than their modulators, so one ascending pass
+ * sees each target's state before its modulators.
+ */
+uint8_t FMOscillator::getAudibleOperators() const
+{
+    const auto &alg = algorithms[algorithm];
+    uint8_t audible = 0;
+
+    for (int k = 0; k < numOperators; ++k)
+    {
+        if (levels[size_t(k)] <= 0.0f)
+            continue;
+
+        if ((alg.carriers & op(k)) != 0)
+        {
+            audible |= op(k);
+            continue;
+        }
+
+        for (int target = 0; target < k; ++target)
+            if ((alg.modulators[target] & op(k)) != 0 && (audible & op(target)) != 0)
+                audible |= op(k);
+    }
+    return audible;
+}
+
+/**
+ * @brief Renders every audible operator over one piece, last operator first.
+ *
+ * Each operator is one kernel call over the piece. Its output is either
+ * added to the carrier mix or to the modulation input of its targets; a
+ * target's input is scaled by the modulator envelope just before the target
+ * reads it (the envelope is shared, so scaling the sum scales each term).
+ */
+void FMOscillator::renderPiece(float *out, const float *ratio, int numSamples)
+{
+    std::fill(out, out + numSamples, 0.0f);
+
+    if (source == nullptr)
+        return;
+
+    const auto &kernels = KernelDispatch::get();
+    const auto &alg = algorithms[algorithm];
+
+    // Segments of the modulator envelope over this piece (operatorOut is only scratch here)
+    struct Segment
+    {
+        int offset;
+        int length;
+        float start;
+        float step;
+    };
+    std::array<Segment, maxEnvelopeSegments> segments{};
+    int numSegments = 0;
+    modulatorEnvelope.processSegments(operatorOut.data(), numSamples, [&](float *segment, int n, float start, float step)
+                                      {
+                                          if (numSegments < maxEnvelopeSegments)
+                                              segments[size_t(numSegments++)] = {int(segment - operatorOut.data()), n, start, step};
+                                      });
+
+    const uint8_t audible = getAudibleOperators();
+    const float carrierGain = amplitude / float(std::max(1, countCarriers(alg.carriers)));
+    uint8_t written = 0;
+
+    for (int k = numOperators - 1; k >= 0; --k)
+    {
+        const auto index = size_t(k);
+        const double delta = phaseDelta * double(ratios[index]);
+
+        // Muted operators keep their phase moving, so unmuting does not shift them;
+        // under pitch modulation they accumulate as the kernel does for an audible one
+        if ((audible & op(k)) == 0)
+        {
+            if (ratio != nullptr)
+            {
+                double p = phases[index];
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    p += delta * double(ratio[i]);
+                    p -= double(int32_t(p));
+                }
+                phases[index] = p;
+            }
+            else
+            {
+                const double end = phases[index] + delta * double(numSamples);
+                phases[index] = end - std::floor(end);
+            }
+            continue;
+        }
+
+        float *input = nullptr;
+        if ((written & op(k)) != 0)
+        {
+            input = modulation[index].data();
+            for (int s = 0; s < numSegments; ++s)
+                kernels.multiplyByRamp(input + segments[size_t(s)].offset, segments[size_t(s)].length,
+                                       segments[size_t(s)].start, segments[size_t(s)].step);
+        }
+
+        const bool carrier = (alg.carriers & op(k)) != 0;
+        const float gain = levels[index] * (carrier ? carrierGain : maxModulationIndex);
+        phases[index] = source->readBankPhaseModulated(0, phases[index], delta, ratio, input, gain,
+                                                       feedbacks[index] * maxFeedback, feedbackStates[index].data(),
+                                                       operatorOut.data(), numSamples);
+
+        if (carrier)
+        {
+            kernels.mixInto(out, operatorOut.data(), numSamples);
+            continue;
+        }
+
+        for (int target = 0; target < k; ++target)
+        {
+            if ((alg.modulators[target] & op(k)) == 0 || (audible & op(target)) == 0)
+                continue;
+
+            auto *targetInput = modulation[size_t(target)].data();
+            if ((written & op(target)) == 0)
+                std::copy(operatorOut.begin(), operatorOut.begin() + numSamples, targetInput);
+            else
+                kernels.mixInto(targetInput, operatorOut.data(), numSamples);
+            written |= op(target);
+        }
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include "Oscillator.h"
+#include "Envelope.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @class FMOscillator
+ * @brief Six-operator phase-modulation (FM) voice source, an alternative to OscillatorWrapper.
+ *
+ * Every operator is a sine whose phase is offset, sample by sample, by the
+ * sum of its modulators' outputs. Which operator modulates which is chosen
+ * from a fixed set of algorithms; operators that nobody modulates further
+ * are carriers and go to the output. Each operator has a frequency ratio to
+ * the note, a level and a self-feedback amount.
+ *
+ * Rendering is operator-major: each operator renders a whole piece in one
+ * KernelDispatch::renderPhaseModulated() call, reading its modulation input
+ * from a buffer filled by the operators rendered before it. Operator state
+ * is kept as parallel arrays (one entry per operator) rather than one
+ * object per operator. The sine is the Sine oscillator's largest table,
+ * shared with the wrapper, so FM adds no table memory.
+ *
+ * Modulator output is shaped by one Envelope per voice (attack and release
+ * follow the amplitude envelope, decay and sustain are set separately),
+ * applied to each modulation input segment by segment with multiplyByRamp.
+ * Carriers are left to the voice's amplitude envelope.
+ *
+ * Real-time safe after setSource(): no allocation while rendering.
+ */
+class FMOscillator
+{
+public:
+    /** @brief Number of operators. */
+    static constexpr int numOperators = 6;
+
+    /** @brief Number of selectable algorithms. */
+    static constexpr int numAlgorithms = 8;
+
+    /** @brief Phase deviation, in cycles, of a modulator at level 1 (about 12.6 rad). */
+    static constexpr float maxModulationIndex = 2.0f;
+
+    /** @brief Self-modulation, in cycles, at feedback 1. */
+    static constexpr float maxFeedback = 0.25f;
+
+    /** @brief Settings of one operator. */
+    struct OperatorSettings
+    {
+        float ratio = 1.0f;    ///< Frequency multiplier from the note.
+        float level = 0.0f;    ///< Output level (carrier) or modulation depth (modulator), 0–1.
+        float feedback = 0.0f; ///< Self-modulation, 0–1.
+
+        bool operator==(const OperatorSettings &other) const
+        {
+            return ratio == other.ratio && level == other.level && feedback == other.feedback;
+        }
+        bool operator!=(const OperatorSettings &other) const { return !(*this == other); }
+    };
+
+    /** @brief Display name of an algorithm, e.g. "6>5>4>3>2>1" (nullptr if out of range). */
+    static const char *getAlgorithmName(int algorithm);
+
+    FMOscillator();
+
+    /**
+     * @brief Sets the sine the operators read.
+     * @param sine Built Sine oscillator; its first (largest) bank is used.
+     */
+    void setSource(std::shared_ptr<const WavetableOscillator> sine);
+
+    /** @brief Sets the sample rate of the modulator envelope. */
+    void setSampleRate(double fs);
+
+    /** @brief Selects the algorithm (clamped to the valid range). */
+    void setAlgorithm(int algorithm);
+
+    /** @brief Sets one operator (index 0 = operator 1). */
+    void setOperator(int index, const OperatorSettings &settings);
+
+    /**
+     * @brief Sets the modulator envelope.
+     * @param attack Attack in seconds (the voice's).
+     * @param decay Decay of the modulation depth, in seconds.
+     * @param sustain Modulation depth held while the note is down, 0–1.
+     * @param release Release in seconds (the voice's).
+     */
+    void setModulatorEnvelope(float attack, float decay, float sustain, float release);
+
+    /** @brief Sets the note's phase increment per sample (frequency / sample rate). */
+    void setPhaseDelta(double delta) { phaseDelta = delta; }
+
+    /** @brief Gain of the carrier mix (velocity). */
+    void setAmplitude(float amp) { amplitude = amp; }
+
+    /** @brief Restarts every operator at phase 0 and the modulator envelope at its attack. */
+    void noteOn();
+
+    /** @brief Moves the modulator envelope to its release. */
+    void noteOff();
+
+    /** @brief Renders numSamples into out (overwrites). */
+    void renderBlock(float *out, int numSamples);
+
+    /** @brief renderBlock() with per-sample frequency multipliers (pitch bend, glide, vibrato). */
+    void renderBlockModulated(float *out, const float *ratio, int numSamples);
+
+    /** @brief Bytes of the per-piece buffers (memory accounting). */
+    size_t getScratchBytes() const { return sizeof(modulation) + sizeof(operatorOut); }
+
+private:
+    /** @brief Samples per operator pass; bounds the modulation buffers. */
+    static constexpr int pieceSize = 256;
+
+    /** @brief Most envelope segments one piece can hold (Attack, Decay, Sustain). */
+    static constexpr int maxEnvelopeSegments = 4;
+
+    /** @brief Renders the operators over one piece. */
+    void renderPiece(float *out, const float *ratio, int numSamples);
+
+    /** @brief Operators worth rendering: audible carriers and the modulators that reach them. */
+    uint8_t getAudibleOperators() const;
+
+    std::shared_ptr<const WavetableOscillator> source; ///< Sine tables.
+
+    int algorithm = 0;
+    double phaseDelta = 440.0 / 44100.0; ///< Phase increment of the note.
+    float amplitude = 1.0f;
+
+    // Operator state, one entry per operator
+    std::array<double, numOperators> phases{};
+    std::array<float, numOperators> ratios{};
+    std::array<float, numOperators> levels{};
+    std::array<float, numOperators> feedbacks{};
+    std::array<std::array<float, 2>, numOperators> feedbackStates{};
+
+    /** @brief Modulation input of each operator for the current piece, in cycles. */
+    std::array<std::array<float, pieceSize>, numOperators> modulation{};
+
+    /** @brief Output of the operator being rendered. */
+    std::array<float, pieceSize> operatorOut{};
+
+    /** @brief Depth envelope of the modulators. */
+    Envelope modulatorEnvelope;
+    float attackTime = 0.01f;
+    float modulatorDecay = 0.5f;
+    float modulatorSustain = 0.5f;
+    float releaseTime = 0.2f;
+};
@@ -1,5 +1,91 @@
 #include "Oscillator.h"
+#include "DSP/KernelDispatch.h"
 #include <algorithm>
+#include <cstring>
+#include <limits>
+
+const WavetableOscillator::TableFormat WavetableOscillator::defaultTableFormat =
+#if TEC_WAVETABLE_FORMAT == 1
+    WavetableOscillator::TableFormat::Float16;
+#elif TEC_WAVETABLE_FORMAT == 2
+    WavetableOscillator::TableFormat::Int16;
+#else
+    WavetableOscillator::TableFormat::Float32;
+#endif
+
+namespace
+{
+    /** @brief float -> IEEE binary16 bits, round to nearest even (table building only). */
+    uint16_t floatToHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const uint32_t sign = (bits >> 16) & 0x8000u;
+        const int32_t exponent = int32_t((bits >> 23) & 0xFFu) - 127 + 15;
+        uint32_t mantissa = bits & 0x7FFFFFu;
+
+        if (((bits >> 23) & 0xFFu) == 0xFFu) // inf / NaN
+            return uint16_t(sign | 0x7C00u | (mantissa != 0 ? 0x200u : 0u));
+
+        if (exponent >= 0x1F) // overflow
+            return uint16_t(sign | 0x7C00u);
+
+        if (exponent <= 0) // subnormal or zero
+        {
+            if (exponent < -10)
+                return uint16_t(sign);
+
+            mantissa |= 0x800000u;
+            const int shift = 14 - exponent;
+            uint32_t half = mantissa >> shift;
+            const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+            const uint32_t halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (half & 1u)))
+                ++half;
+            return uint16_t(sign | half);
+        }
+
+        uint32_t half = (uint32_t(exponent) << 10) | (mantissa >> 13);
+        const uint32_t remainder = mantissa & 0x1FFFu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+            ++half; // may carry into the exponent, which is still correct
+        return uint16_t(sign | half);
+    }
+
+    float halfToFloat(uint16_t h)
+    {
+        const uint32_t sign = uint32_t(h & 0x8000u) << 16;
+        const uint32_t exponent = (h >> 10) & 0x1Fu;
+        const uint32_t mantissa = h & 0x3FFu;
+
+        if (exponent == 0)
+        {
+            const float magnitude = float(mantissa) * (1.0f / 16777216.0f);
+            return sign != 0 ? -magnitude : magnitude;
+        }
+
+        const uint32_t bits = exponent == 0x1Fu ? (sign | 0x7F800000u | (mantissa << 13))
+                                                : (sign | ((exponent + 112u) << 23) | (mantissa << 13));
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    float int16ScaleFor(const std::vector<float> &table)
+    {
+        float peak = 0.0f;
+        for (float v : table)
+            peak = std::max(peak, std::abs(v));
+        return peak > 0.0f ? peak / 32767.0f : 1.0f;
+    }
+
+    int16_t floatToInt16(float value, float scale)
+    {
+        const float q = std::round(value / scale);
+        return int16_t(std::max(-32767.0f, std::min(32767.0f, q)));
+    }
+}
 
 /**
  * @brief Constructs a WavetableOscillator and initializes its tables.
@@ -10,21 +96,49 @@
 WavetableOscillator::WavetableOscillator(const std::vector<std::vector<float>> &tables,
                                          const std::vector<double> &tableFreqs,
                                          float amp)
-    : waveTables(tables), bankFreqs(tableFreqs)
+    : bankFreqs(tableFreqs)
 {
     name = "SineWavetable";
     amplitude = amp;
+    if (!tables.empty())
+        setTables(tables);
+    if (!bankFreqs.empty())
+        currentBank = findClosestBank();
 }
 
 /**
- * @brief Sets oscillator frequency and updates the phase increment.
- * @param freq Frequency in Hz.
- * @param sampleRate Sampling rate in Hz.
+ * @brief Wraps the float banks in shared storage.
+ * @param tables Generated banks, one cycle each.
+ *
+ * Called while the oscillator is being built; copies made afterwards share
+ * the storage.
  */
-void WavetableOscillator::setFrequency(double freq, double sampleRate)
+void WavetableOscillator::setTables(std::vector<std::vector<float>> tables)
 {
-    frequency = freq;
-    phaseDelta = frequency / sampleRate;
+    auto data = std::make_shared<BankData>();
+    data->waveTables = std::move(tables);
+    bankData = std::move(data);
+    tableFormat = TableFormat::Float32;
+}
+
+/** @brief Float banks, or an empty list if there are none (or they were converted). */
+const std::vector<std::vector<float>> &WavetableOscillator::floatTables() const
+{
+    static const std::vector<std::vector<float>> none;
+    return bankData != nullptr ? bankData->waveTables : none;
+}
+
+/**
+ * @brief Caches the bank for the new frequency.
+ *
+ * The linear search over the bank centers used to run for every sample
+ * (and then every block); frequency only changes at note-on or on a
+ * parameter change.
+ */
+void WavetableOscillator::frequencyChanged()
+{
+    if (!bankFreqs.empty())
+        currentBank = findClosestBank();
 }
 
 /**
@@ -39,10 +153,48 @@ void WavetableOscillator::setFrequency(double freq, double sampleRate)
  */
 float WavetableOscillator::getNextSample()
 {
+    // Compact tables are only read through the block kernels
+    if (tableFormat != TableFormat::Float32)
+    {
+        float sample = 0.0f;
+        renderBlock(&sample, 1);
+        return sample;
+    }
+
+    const auto &waveTables = floatTables();
     if (waveTables.empty())
         return 0.0f;
 
-    // Select closest frequency bank
+    auto &table = waveTables[currentBank];
+
+    // Linear interpolation between samples
+    size_t idx0 = static_cast<size_t>(phase * table.size());
+    float sample;
+    if (linearInterpolation)
+    {
+        size_t idx1 = (idx0 + 1) % table.size();
+        float frac = static_cast<float>(phase * table.size() - idx0);
+        sample = (table[idx0] * (1.0f - frac) + table[idx1] * frac) * amplitude;
+    }
+    else
+    {
+        sample = table[idx0] * amplitude;
+    }
+
+    // Advance and wrap phase
+    phase += phaseDelta;
+    if (phase >= 1.0)
+        phase -= 1.0;
+
+    return sample;
+}
+
+/**
+ * @brief Selects the wavetable bank with the closest center frequency.
+ * @return Bank index.
+ */
+size_t WavetableOscillator::findClosestBank() const
+{
     size_t bankIndex = 0;
     double minDiff = std::abs(bankFreqs[0] - frequency);
     for (size_t i = 1; i < bankFreqs.size(); ++i)
@@ -54,20 +206,422 @@ float WavetableOscillator::getNextSample()
             bankIndex = i;
         }
     }
+    return bankIndex;
+}
 
-    auto &table = waveTables[bankIndex];
+/**
+ * @brief Renders a block of samples from the closest bank.
+ * @param out Destination buffer.
+ * @param numSamples Number of samples.
+ *
+ * Same output as calling getNextSample() numSamples times (phase is
+ * computed from the block start instead of accumulated per sample).
+ */
+void WavetableOscillator::renderBlock(float *out, int numSamples)
+{
+    if (bankFreqs.empty())
+    {
+        std::fill(out, out + numSamples, 0.0f);
+        return;
+    }
 
-    // Linear interpolation between samples
-    size_t idx0 = static_cast<size_t>(phase * table.size());
-    size_t idx1 = (idx0 + 1) % table.size();
-    float frac = static_cast<float>(phase * table.size() - idx0);
+    renderFromBank(currentBank, nullptr, out, numSamples);
+}
 
-    float sample = (table[idx0] * (1.0f - frac) + table[idx1] * frac) * amplitude;
+/**
+ * @brief Renders a block whose frequency changes every sample.
+ * @param out Destination buffer.
+ * @param ratio Per-sample multipliers of the base frequency.
+ * @param numSamples Number of samples.
+ *
+ * Bank b is the closest one for frequencies in (edge(b), edge(b + 1)], with
+ * the edges at the midpoints between centers (same choice as
+ * findClosestBank()). The edges are converted to ratios once per run, so a
+ * sample only costs two comparisons until the frequency leaves the bank;
+ * then the neighbouring bank is taken.
+ */
+void WavetableOscillator::renderBlockModulated(float *out, const float *ratio, int numSamples)
+{
+    if (bankFreqs.empty() || frequency <= 0.0)
+    {
+        renderBlock(out, numSamples);
+        return;
+    }
 
-    // Advance and wrap phase
-    phase += phaseDelta;
-    if (phase >= 1.0)
-        phase -= 1.0;
+    const size_t lastBank = bankFreqs.size() - 1;
+    const double invFrequency = 1.0 / frequency;
+
+    auto lowerEdge = [&](size_t b)
+    { return b == 0 ? 0.0 : 0.5 * (bankFreqs[b - 1] + bankFreqs[b]) * invFrequency; };
+    auto upperEdge = [&](size_t b)
+    { return b == lastBank ? std::numeric_limits<double>::max() : 0.5 * (bankFreqs[b] + bankFreqs[b + 1]) * invFrequency; };
+
+    size_t bank = currentBank;
+    int start = 0;
+    while (start < numSamples)
+    {
+        const double r = ratio[start];
+        while (bank > 0 && r <= lowerEdge(bank))
+            --bank;
+        while (bank < lastBank && r > upperEdge(bank))
+            ++bank;
+
+        const double lower = lowerEdge(bank);
+        const double upper = upperEdge(bank);
+        int end = start + 1;
+        while (end < numSamples && double(ratio[end]) > lower && double(ratio[end]) <= upper)
+            ++end;
+
+        renderFromBank(bank, ratio + start, out + start, end - start);
+        start = end;
+    }
+}
+
+/**
+ * @brief Renders from one bank and advances the phase.
+ * @param bank Bank index.
+ * @param ratio Per-sample multipliers, or nullptr for a constant frequency.
+ * @param out Destination buffer.
+ * @param numSamples Number of samples.
+ */
+void WavetableOscillator::renderFromBank(size_t bank, const float *ratio, float *out, int numSamples)
+{
+    phase = readWave(bank, phase, phaseDelta, ratio, amplitude, linearInterpolation, out, numSamples);
+}
+
+/** @brief Stored waveforms are read straight from their bank. */
+double WavetableOscillator::readWave(size_t bank, double startPhase, double delta, const float *ratio,
+                                     float gain, bool interpolate, float *out, int numSamples) const
+{
+    return readBank(bank, startPhase, delta, ratio, gain, interpolate, out, numSamples);
+}
+
+/**
+ * @brief Binary search over the ascending bank centers.
+ *
+ * Same choice as findClosestBank() (ties go to the lower bank), in
+ * O(log banks), for callers that pick banks for several frequencies.
+ */
+size_t WavetableOscillator::getBankFor(double hz) const
+{
+    if (bankFreqs.empty())
+        return 0;
+
+    const auto upper = std::lower_bound(bankFreqs.begin(), bankFreqs.end(), hz);
+    if (upper == bankFreqs.begin())
+        return 0;
+    if (upper == bankFreqs.end())
+        return bankFreqs.size() - 1;
+
+    const auto lower = upper - 1;
+    return size_t((hz - *lower <= *upper - hz ? lower : upper) - bankFreqs.begin());
+}
+
+/**
+ * @brief Runs the kernel for one bank and storage format.
+ * @return Phase after the last sample.
+ */
+double WavetableOscillator::readBank(size_t bank, double startPhase, double delta, const float *ratio,
+                                     float gain, bool interpolate, float *out, int numSamples) const
+{
+    const auto &kernels = KernelDispatch::get();
+    const auto &data = *bankData;
+
+    switch (tableFormat)
+    {
+    case TableFormat::Float32:
+    {
+        const auto &table = data.waveTables[bank];
+        return ratio == nullptr
+                   ? kernels.renderWavetable(table.data(), int(table.size()), startPhase, delta,
+                                             gain, interpolate, out, numSamples)
+                   : kernels.renderWavetableModulated(table.data(), int(table.size()), startPhase, delta,
+                                                      ratio, gain, interpolate, out, numSamples);
+    }
+
+    case TableFormat::Float16:
+    {
+        const auto &table = data.halfTables[bank];
+        return ratio == nullptr
+                   ? kernels.renderWavetableF16(table.data(), int(table.size()) - 1, startPhase, delta,
+                                                gain, interpolate, out, numSamples)
+                   : kernels.renderWavetableModulatedF16(table.data(), int(table.size()) - 1, startPhase, delta,
+                                                         ratio, gain, interpolate, out, numSamples);
+    }
+
+    case TableFormat::Int16:
+    {
+        const auto &table = data.int16Tables[bank];
+        return ratio == nullptr
+                   ? kernels.renderWavetableI16(table.data(), int(table.size()) - 1, data.int16Scales[bank], startPhase,
+                                                delta, gain, interpolate, out, numSamples)
+                   : kernels.renderWavetableModulatedI16(table.data(), int(table.size()) - 1, data.int16Scales[bank],
+                                                         startPhase, delta, ratio, gain, interpolate, out,
+                                                         numSamples);
+    }
+    }
+    return startPhase;
+}
+
+/** @brief Phase-modulated read of one bank, in any storage format. */
+double WavetableOscillator::readBankPhaseModulated(size_t bank, double startPhase, double delta, const float *ratio,
+                                                   const float *modulation, float gain, float feedback,
+                                                   float *feedbackState, float *out, int numSamples) const
+{
+    const auto &kernels = KernelDispatch::get();
+    const auto &data = *bankData;
+
+    switch (tableFormat)
+    {
+    case TableFormat::Float32:
+    {
+        const auto &table = data.waveTables[bank];
+        return kernels.renderPhaseModulated(table.data(), int(table.size()), startPhase, delta, ratio, modulation,
+                                            gain, feedback, feedbackState, out, numSamples);
+    }
+
+    case TableFormat::Float16:
+    {
+        const auto &table = data.halfTables[bank];
+        return kernels.renderPhaseModulatedF16(table.data(), int(table.size()) - 1, startPhase, delta, ratio,
+                                               modulation, gain, feedback, feedbackState, out, numSamples);
+    }
+
+    case TableFormat::Int16:
+    {
+        const auto &table = data.int16Tables[bank];
+        return kernels.renderPhaseModulatedI16(table.data(), int(table.size()) - 1, data.int16Scales[bank], startPhase,
+                                               delta, ratio, modulation, gain, feedback, feedbackState, out,
+                                               numSamples);
+    }
+    }
+    return startPhase;
+}
+
+/** @brief Samples per cycle of a bank, in any format (compact banks carry a guard element). */
+int WavetableOscillator::getBankLength(size_t bank) const
+{
+    if (bankData == nullptr)
+        return 0;
+    if (bank < bankData->waveTables.size())
+        return int(bankData->waveTables[bank].size());
+    if (bank < bankData->halfTables.size())
+        return int(bankData->halfTables[bank].size()) - 1;
+    if (bank < bankData->int16Tables.size())
+        return int(bankData->int16Tables[bank].size()) - 1;
+    return 0;
+}
+
+//==============================================================================
+namespace
+{
+    double wrapPhase(double p)
+    {
+        return p - std::floor(p);
+    }
+}
+
+/**
+ * @brief Computes each bank's gain by rendering one cycle of the difference.
+ *
+ * Goes through readBank(), so the gains match whatever storage format the
+ * source uses. Runs at construction only.
+ */
+void PhaseDifferenceOscillator::setSource(const WavetableOscillator *tables, double offsetA, double offsetB,
+                                          float velocity)
+{
+    source = tables;
+    firstOffset = offsetA;
+    secondOffset = offsetB;
+    bankFreqs = source->getBankFrequencies();
+
+    bankGains.assign(bankFreqs.size(), 0.0f);
+    std::vector<float> a, b;
+    for (size_t bank = 0; bank < bankFreqs.size(); ++bank)
+    {
+        const int length = source->getBankLength(bank);
+        if (length <= 0)
+            continue;
+
+        a.resize(size_t(length));
+        b.resize(size_t(length));
+        const double delta = 1.0 / length;
+        source->readBank(bank, wrapPhase(firstOffset), delta, nullptr, 1.0f, true, a.data(), length);
+        source->readBank(bank, wrapPhase(secondOffset), delta, nullptr, 1.0f, true, b.data(), length);
+
+        float peak = 0.0f;
+        for (int i = 0; i < length; ++i)
+            peak = std::max(peak, std::abs(a[size_t(i)] - b[size_t(i)]));
+        bankGains[bank] = peak > 0.0f ? velocity / peak : 0.0f;
+    }
+
+    if (!bankFreqs.empty())
+        currentBank = findClosestBank();
+}
+
+/** @brief Same offsets and gains; reads this copy's own banks if the original read its own. */
+PhaseDifferenceOscillator::PhaseDifferenceOscillator(const PhaseDifferenceOscillator &other)
+    : WavetableOscillator(other),
+      source(other.source == &other ? this : other.source),
+      firstOffset(other.firstOffset),
+      secondOffset(other.secondOffset),
+      bankGains(other.bankGains)
+{
+}
 
+/** @brief Single sample through the block path (the tables belong to the source). */
+float PhaseDifferenceOscillator::getNextSample()
+{
+    float sample = 0.0f;
+    renderBlock(&sample, 1);
     return sample;
 }
+
+/**
+ * @brief Two reads of the same source bank, the second one negated, summed.
+ *
+ * Both reads use the same increments (and ratio), so their phase distance
+ * stays exactly offsetB - offsetA. Processed in stack-sized pieces.
+ */
+double PhaseDifferenceOscillator::readWave(size_t bank, double startPhase, double delta, const float *ratio,
+                                           float gain, bool interpolate, float *out, int numSamples) const
+{
+    constexpr int pieceSize = 128;
+    float negative[pieceSize];
+
+    const auto &kernels = KernelDispatch::get();
+    const float bankGain = gain * bankGains[bank];
+    double p = startPhase;
+
+    for (int start = 0; start < numSamples; start += pieceSize)
+    {
+        const int n = std::min(pieceSize, numSamples - start);
+        const float *pieceRatio = ratio != nullptr ? ratio + start : nullptr;
+
+        const double endA = source->readBank(bank, wrapPhase(p + firstOffset), delta, pieceRatio,
+                                             bankGain, interpolate, out + start, n);
+        source->readBank(bank, wrapPhase(p + secondOffset), delta, pieceRatio,
+                         -bankGain, interpolate, negative, n);
+        kernels.mixInto(out + start, negative, n);
+
+        p = wrapPhase(endA - firstOffset);
+    }
+    return p;
+}
+
+/**
+ * @brief Converts the float banks to a compact format and releases them.
+ * @param format Target format.
+ *
+ * Replaces the shared storage; the float banks are freed with the last
+ * holder, which is this oscillator as long as it has not been copied.
+ */
+void WavetableOscillator::setTableFormat(TableFormat format)
+{
+    if (format == tableFormat || tableFormat != TableFormat::Float32 || bankData == nullptr)
+        return;
+
+    auto converted = std::make_shared<BankData>();
+    const auto &waveTables = bankData->waveTables;
+
+    if (format == TableFormat::Float16)
+    {
+        converted->halfTables.reserve(waveTables.size());
+        for (const auto &table : waveTables)
+        {
+            std::vector<uint16_t> half(table.size() + 1, 0);
+            for (size_t i = 0; i < table.size(); ++i)
+                half[i] = floatToHalf(table[i]);
+            converted->halfTables.push_back(std::move(half));
+        }
+    }
+    else
+    {
+        converted->int16Tables.reserve(waveTables.size());
+        converted->int16Scales.reserve(waveTables.size());
+        for (const auto &table : waveTables)
+        {
+            const float scale = int16ScaleFor(table);
+            std::vector<int16_t> quantized(table.size() + 1, 0);
+            for (size_t i = 0; i < table.size(); ++i)
+                quantized[i] = floatToInt16(table[i], scale);
+            converted->int16Tables.push_back(std::move(quantized));
+            converted->int16Scales.push_back(scale);
+        }
+    }
+
+    tableFormat = format;
+    bankData = std::move(converted);
+}
+
+/** @brief Bytes used by the table samples in the current format. */
+size_t WavetableOscillator::getTableBytes() const
+{
+    size_t bytes = 0;
+    if (bankData == nullptr)
+        return bytes;
+
+    for (const auto &t : bankData->waveTables)
+        bytes += t.size() * sizeof(float);
+    for (const auto &t : bankData->halfTables)
+        bytes += t.size() * sizeof(uint16_t);
+    for (const auto &t : bankData->int16Tables)
+        bytes += t.size() * sizeof(int16_t);
+    return bytes;
+}
+
+/** @brief Bytes allocated for each bank (capacity, not just samples in use). */
+std::vector<size_t> WavetableOscillator::getBankBytes() const
+{
+    std::vector<size_t> bytes;
+    if (bankData == nullptr)
+        return bytes;
+
+    for (const auto &t : bankData->waveTables)
+        bytes.push_back(t.capacity() * sizeof(float));
+    for (const auto &t : bankData->halfTables)
+        bytes.push_back(t.capacity() * sizeof(uint16_t));
+    for (size_t b = 0; b < bankData->int16Tables.size(); ++b)
+        bytes.push_back(bankData->int16Tables[b].capacity() * sizeof(int16_t) + sizeof(float)); // + escala
+    return bytes;
+}
+
+/**
+ * @brief Quantizes the float banks to a format and compares sample by sample.
+ * @param format Format to evaluate.
+ * @return Max/RMS error, SNR and size of that format.
+ */
+WavetableOscillator::FormatError WavetableOscillator::measureFormatError(TableFormat format) const
+{
+    FormatError result;
+    double errorEnergy = 0.0;
+    double signalEnergy = 0.0;
+    size_t count = 0;
+
+    for (const auto &table : floatTables())
+    {
+        const float scale = int16ScaleFor(table);
+        for (float v : table)
+        {
+            float decoded = v;
+            if (format == TableFormat::Float16)
+                decoded = halfToFloat(floatToHalf(v));
+            else if (format == TableFormat::Int16)
+                decoded = float(floatToInt16(v, scale)) * scale;
+
+            const double error = double(decoded) - double(v);
+            result.maxAbsError = std::max(result.maxAbsError, std::abs(error));
+            errorEnergy += error * error;
+            signalEnergy += double(v) * double(v);
+        }
+
+        count += table.size();
+        result.bytes += format == TableFormat::Float32 ? table.size() * sizeof(float)
+                                                       : (table.size() + 1) * sizeof(uint16_t);
+    }
+
+    if (count > 0)
+        result.rmsError = std::sqrt(errorEnergy / double(count));
+    result.snrDb = errorEnergy > 0.0 ? 10.0 * std::log10(signalEnergy / errorEnergy) : 0.0;
+    return result;
+}
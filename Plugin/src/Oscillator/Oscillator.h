@@ -1,8 +1,11 @@
 #pragma once
 #include <JuceHeader.h>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <cmath>
+#include <cstddef>
+#include <memory>
 
 /**
  * @class OscillatorBase
@@ -28,15 +31,67 @@ public:
      */
     virtual float getNextSample() = 0;
 
+    /**
+     * @brief Fills a buffer with the next numSamples samples.
+     * @param out Destination, overwritten.
+     * @param numSamples Number of samples.
+     *
+     * The default calls getNextSample() per sample; table oscillators
+     * override it with a dispatched SIMD kernel.
+     */
+    virtual void renderBlock(float *out, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            out[i] = getNextSample();
+    }
+
+    /**
+     * @brief Renders a block with a per-sample pitch multiplier.
+     * @param out Destination, overwritten.
+     * @param ratio numSamples frequency multipliers (1 = unmodulated).
+     * @param numSamples Number of samples.
+     *
+     * The base frequency is unchanged; sample i advances the phase by
+     * phaseDelta * ratio[i]. The default scales phaseDelta around
+     * getNextSample(); table oscillators override it.
+     */
+    virtual void renderBlockModulated(float *out, const float *ratio, int numSamples)
+    {
+        const double baseDelta = phaseDelta;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            phaseDelta = baseDelta * ratio[i];
+            out[i] = getNextSample();
+        }
+        phaseDelta = baseDelta;
+    }
+
     /** @brief Resets the oscillator’s phase to zero. */
     virtual void resetPhase() { phase = 0.0; }
 
+    /** @brief Current phase in [0, 1). */
+    double getPhase() const { return phase; }
+
+    /** @brief Sets the phase, e.g. to restore a saved state (in [0, 1)). */
+    void setPhase(double newPhase) { phase = newPhase; }
+
+    /** @brief Phase increment per sample. */
+    double getPhaseDelta() const { return phaseDelta; }
+
     /**
      * @brief Sets the oscillator amplitude (output gain).
      * @param amp Linear amplitude value (typically between 0.0 and 1.0).
      */
     void setAmplitude(float amp) { amplitude = amp; }
 
+    /**
+     * @brief Chooses between linear interpolation and drop-sample table reads.
+     * @param shouldInterpolate True for linear interpolation (default), false
+     *        to read the nearest lower table sample (cheaper, used by the
+     *        QualityGovernor when CPU headroom is low).
+     */
+    void setLinearInterpolation(bool shouldInterpolate) { linearInterpolation = shouldInterpolate; }
+
     /**
      * @brief Sets the oscillator frequency and updates the phase increment.
      * @param newFreq Frequency in Hz.
@@ -47,20 +102,41 @@ public:
      * \Delta \phi = \frac{f}{f_s}
      * \f]
      */
-    virtual void setFrequency(double newFreq, double sampleRate)
+    void setFrequency(double newFreq, double sampleRate)
+    {
+        setFrequencyAndDelta(newFreq, newFreq / sampleRate);
+    }
+
+    /**
+     * @brief Sets frequency and phase increment from precomputed values.
+     * @param newFreq Frequency in Hz.
+     * @param newPhaseDelta Phase increment per sample (newFreq / sampleRate).
+     *
+     * Used at note-on with the TuningTable entries, so no division or pow()
+     * is needed on the audio thread. Does nothing if the frequency is unchanged.
+     */
+    void setFrequencyAndDelta(double newFreq, double newPhaseDelta)
     {
+        if (newFreq == frequency && newPhaseDelta == phaseDelta)
+            return;
+
         frequency = newFreq;
-        phaseDelta = frequency / sampleRate;
+        phaseDelta = newPhaseDelta;
+        frequencyChanged();
     }
 
     /** @brief Returns the oscillator’s name identifier. */
     const std::string &getName() const { return name; }
 
 protected:
+    /** @brief Called after the frequency changed; lets subclasses update derived state. */
+    virtual void frequencyChanged() {}
+
     double phase = 0.0;        /**< Current phase position in [0, 1). */
     double phaseDelta = 0.0;   /**< Phase increment per sample. */
     double frequency = 440.0;  /**< Current oscillator frequency in Hz. */
     float amplitude = 1.0f;    /**< Output amplitude (velocity scaling). */
+    bool linearInterpolation = true; /**< Interpolate between table samples. */
     std::string name = "Base"; /**< Identifier name for the oscillator type. */
 };
 
@@ -71,10 +147,45 @@ protected:
  * The WavetableOscillator manages a set of band-limited waveforms (banks), each covering
  * a frequency range optimized to minimize aliasing. The class performs table lookup and
  * linear interpolation between adjacent samples.
+ *
+ * The banks are immutable once built and held through a shared pointer, so
+ * a copy of an oscillator is a new phase/frequency state over the same
+ * tables (WavetableSet hands every voice such a copy).
  */
 class WavetableOscillator : public OscillatorBase
 {
 public:
+    /**
+     * @brief Storage format of the wavetable banks.
+     *
+     * The compact formats halve the table bytes so more banks stay resident in
+     * L1/L2 at high polyphony; samples are widened to float on load by the
+     * KernelDispatch kernels.
+     */
+    enum class TableFormat
+    {
+        Float32, ///< 4 bytes per sample, exact.
+        Float16, ///< IEEE binary16, 2 bytes per sample (max error 2.4e-4, ~75 dB SNR).
+        Int16    ///< Normalized int16 with a per-table scale, 2 bytes per sample (~95 dB SNR).
+    };
+
+    /** @brief Format used by OscillatorWrapper for new oscillators (CMake TEC_WAVETABLE_FORMAT). */
+    static const TableFormat defaultTableFormat;
+
+    /**
+     * @brief Error of a compact format against the float tables.
+     *
+     * Computed over every sample of every bank, relative to a full-scale
+     * table (the tables are normalized to the velocity passed at construction).
+     */
+    struct FormatError
+    {
+        double maxAbsError = 0.0; ///< Largest absolute sample error.
+        double rmsError = 0.0;    ///< RMS sample error.
+        double snrDb = 0.0;       ///< Signal-to-error ratio in dB.
+        size_t bytes = 0;         ///< Table bytes in that format.
+    };
+
     /**
      * @brief Constructs a WavetableOscillator.
      * @param tables 2D vector containing multiple wavetable banks.
@@ -90,19 +201,197 @@ public:
      *
      * Performs:
      * 1. Bank selection based on closest frequency.
-     * 2. Linear interpolation between two consecutive samples.
+     * 2. Linear interpolation between two consecutive samples
+     *    (or a drop-sample read when interpolation is disabled).
      * 3. Phase advancement with wrap-around.
      */
     float getNextSample() override;
 
     /**
-     * @brief Sets oscillator frequency and computes the normalized phase increment.
-     * @param freq Frequency in Hz.
-     * @param sampleRate Sampling rate in Hz.
+     * @brief Renders a block with the KernelDispatch wavetable kernel.
+     * @param out Destination, overwritten.
+     * @param numSamples Number of samples.
+     *
+     * The bank is selected when the frequency changes, not per block or
+     * per sample.
+     */
+    void renderBlock(float *out, int numSamples) override;
+
+    /**
+     * @brief Renders a pitch-modulated block (bend, glide, vibrato).
+     * @param out Destination, overwritten.
+     * @param ratio Per-sample frequency multipliers.
+     * @param numSamples Number of samples.
+     *
+     * The block is split only where the modulated frequency crosses the edge
+     * of the current bank (midpoint between bank centers); each run is one
+     * kernel call. No bank search per sample or per block.
+     */
+    void renderBlockModulated(float *out, const float *ratio, int numSamples) override;
+
+    /**
+     * @brief Reads one bank without touching this oscillator's state.
+     * @param bank Bank index.
+     * @param startPhase Phase of the first sample, in [0, 1).
+     * @param delta Phase increment per sample.
+     * @param ratio Per-sample increment multipliers, or nullptr for a constant increment.
+     * @param gain Output gain (may be negative).
+     * @param interpolate Linear interpolation or drop-sample read.
+     * @param out Destination, overwritten.
+     * @param numSamples Number of samples.
+     * @return Phase after the last sample.
+     *
+     * Lets PhaseDifferenceOscillator read another oscillator's tables, in
+     * whatever format they are stored.
      */
-    void setFrequency(double freq, double sampleRate) override;
+    double readBank(size_t bank, double startPhase, double delta, const float *ratio, float gain,
+                    bool interpolate, float *out, int numSamples) const;
+
+    /**
+     * @brief Reads this oscillator's waveform from one bank without touching its state.
+     *
+     * Same arguments as readBank(). For stored waveforms it is readBank();
+     * PhaseDifferenceOscillator combines its two source reads. Lets
+     * OscillatorWrapper's layer mode drive every waveform from its own phase.
+     */
+    virtual double readWave(size_t bank, double startPhase, double delta, const float *ratio, float gain,
+                            bool interpolate, float *out, int numSamples) const;
+
+    /**
+     * @brief Reads one bank with a phase offset per sample, without touching this oscillator's state.
+     * @param modulation Phase offsets in cycles, or nullptr.
+     * @param feedback Self-modulation in cycles per unit of output (0 = none).
+     * @param feedbackState Two floats carried between calls when feedback != 0.
+     *
+     * Other arguments as readBank(); always interpolates. Used by
+     * FMOscillator to run its operators on the Sine tables.
+     */
+    double readBankPhaseModulated(size_t bank, double startPhase, double delta, const float *ratio,
+                                  const float *modulation, float gain, float feedback, float *feedbackState,
+                                  float *out, int numSamples) const;
+
+    /** @brief Index of the bank whose center is closest to hz (0 if there are no banks). */
+    size_t getBankFor(double hz) const;
+
+    /** @brief Samples per cycle of a bank (0 if out of range). */
+    int getBankLength(size_t bank) const;
+
+    /** @brief Center frequency of each bank, ascending. */
+    const std::vector<double> &getBankFrequencies() const { return bankFreqs; }
+
+    /**
+     * @brief Converts the banks to another storage format.
+     * @param format Target format.
+     *
+     * Converting to a compact format releases the float tables, so it can
+     * only be done once, before the oscillator is published to the audio
+     * thread or copied (WavetableSet does it right after construction).
+     * Converting back to Float32 is not supported and is ignored.
+     */
+    void setTableFormat(TableFormat format);
+
+    /** @brief Current storage format. */
+    TableFormat getTableFormat() const { return tableFormat; }
+
+    /** @brief Bytes used by the table samples in the current format. */
+    size_t getTableBytes() const;
+
+    /** @brief Bytes allocated for each bank in the current format (memory accounting). */
+    std::vector<size_t> getBankBytes() const;
+
+    /**
+     * @brief Measures what a compact format would cost in accuracy.
+     * @param format Format to evaluate.
+     * @return Error against the float tables (zeros if already converted).
+     */
+    FormatError measureFormatError(TableFormat format) const;
 
 protected:
-    std::vector<std::vector<float>> waveTables; // banked wavetables
-    std::vector<double> bankFreqs;              // center freqs for each bank
+    /** @brief Index of the bank whose center frequency is closest to the current frequency. */
+    size_t findClosestBank() const;
+
+    /** @brief Renders from one bank through readWave(), advancing the phase (ratio may be nullptr). */
+    void renderFromBank(size_t bank, const float *ratio, float *out, int numSamples);
+
+    /** @brief Re-selects the bank for the new frequency. */
+    void frequencyChanged() override;
+
+    /** @brief Installs freshly generated float banks (subclass constructors only). */
+    void setTables(std::vector<std::vector<float>> tables);
+
+    /** @brief Float banks (empty once converted to a compact format). */
+    const std::vector<std::vector<float>> &floatTables() const;
+
+    std::vector<double> bankFreqs; // center freqs for each bank
+    size_t currentBank = 0;        // findClosestBank() for the current frequency
+
+private:
+    /** @brief Bank samples in the current format; shared by copies, never modified once built. */
+    struct BankData
+    {
+        std::vector<std::vector<float>> waveTables; // banked wavetables
+
+        // Compact banks, each with one guard element after the cycle (see DspKernels)
+        std::vector<std::vector<uint16_t>> halfTables;
+        std::vector<std::vector<int16_t>> int16Tables;
+        std::vector<float> int16Scales;
+    };
+
+    TableFormat tableFormat = TableFormat::Float32;
+    std::shared_ptr<const BankData> bankData; // nullptr until tables are set
+};
+
+/**
+ * @class PhaseDifferenceOscillator
+ * @brief Waveform read as the difference of two phase-offset lookups into band-limited banks.
+ *
+ * Output = gain[bank] * (T(phase + offsetA) - T(phase + offsetB)), where T is
+ * a bank of another oscillator (or of this one). Two reads of a saw give a
+ * band-limited pulse of width offsetB - offsetA; two reads of an integrated
+ * saw a quarter cycle either side give a triangle. The derived waveform has
+ * no tables of its own, follows the source's bank edges and storage format,
+ * and supports bend/glide/vibrato through the inherited modulated path.
+ *
+ * The source's tables must outlive this oscillator and stay immutable. A
+ * copy reads the same source, or itself when the original read its own banks.
+ */
+class PhaseDifferenceOscillator : public WavetableOscillator
+{
+public:
+    /** @brief Renders a single sample through the block path. */
+    float getNextSample() override;
+
+    /** @brief Two reads of the source bank at the offsets, the second one negated, summed. */
+    double readWave(size_t bank, double startPhase, double delta, const float *ratio, float gain,
+                    bool interpolate, float *out, int numSamples) const override;
+
+protected:
+    /** @brief Empty; the subclass calls setSource() once its source banks exist. */
+    PhaseDifferenceOscillator() : WavetableOscillator({}, {}) {}
+
+    /** @brief Copies the state; a self-reading source is rebound to the copy. */
+    PhaseDifferenceOscillator(const PhaseDifferenceOscillator &other);
+
+    PhaseDifferenceOscillator &operator=(const PhaseDifferenceOscillator &) = delete;
+
+    /**
+     * @brief Sets the source banks and offsets and computes the per-bank gains.
+     * @param tables Oscillator whose banks are read (may be this).
+     * @param offsetA Phase offset of the positive read.
+     * @param offsetB Phase offset of the negative read.
+     * @param velocity Peak of the derived waveform (per bank).
+     *
+     * The gains normalize each bank's derived cycle to the given peak, as
+     * the stored tables of the other waveforms are.
+     */
+    void setSource(const WavetableOscillator *tables, double offsetA, double offsetB, float velocity);
+
+    /** @brief Moves the negative read (pulse width); gains are not recomputed. */
+    void setSecondOffset(double offset) { secondOffset = offset; }
+
+private:
+    const WavetableOscillator *source = nullptr;
+    double firstOffset = 0.0;
+    double secondOffset = 0.5;
+    std::vector<float> bankGains;
 };
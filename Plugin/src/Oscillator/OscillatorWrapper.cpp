@@ -1,37 +1,136 @@
 #include "OscillatorWrapper.h"
+#include "DSP/KernelDispatch.h"
+#include <algorithm>
 #include <cmath>
 
 /**
- * @brief Constructs the OscillatorWrapper and initializes all waveform oscillators.
+ * @brief Constructs the OscillatorWrapper with nothing built.
  *
- * Initializes Sine, Saw, Square, and Triangle oscillators and sets the default
- * active waveform to Sine.
+ * Table lengths depend on the sample rate, so no oscillator exists until
+ * setWavetables() or setSampleRate() provides one; until then the wrapper
+ * renders silence. The default active waveform is Sine.
  */
 OscillatorWrapper::OscillatorWrapper()
 {
-    oscillators[0] = std::make_unique<Sine>(sampleRate, 1.0f);
-    oscillators[1] = std::make_unique<Saw>(sampleRate, 1.0f);
-    oscillators[2] = std::make_unique<Square>(sampleRate, 1.0f);
-    oscillators[3] = std::make_unique<Triangle>(sampleRate, 1.0f);
-
     currentWaveIndex = 0;
-    activeOsc = oscillators[currentWaveIndex].get();
 }
 
-/** @brief Sets the sample rate for all oscillators and updates frequency. */
-void OscillatorWrapper::setSampleRate(double fs)
+/** @brief Copies a waveform from the shared set and publishes it to the audio thread. */
+void OscillatorWrapper::installOscillator(int waveIndex)
+{
+    auto osc = wavetables->createOscillator(waveIndex);
+    osc->setLinearInterpolation(linearInterpolation);
+    if (waveIndex == 2)
+        static_cast<Square &>(*osc).setPulseWidth(pulseWidth);
+
+    oscillators[waveIndex] = std::move(osc);
+    readyOscillators[waveIndex].store(oscillators[waveIndex].get(), std::memory_order_release);
+}
+
+/**
+ * @brief Builds the oscillator for a waveform and publishes it to the audio thread.
+ * @param waveIndex Index of the waveform to build.
+ *
+ * The first voice to ask generates the banks in the shared set; the others
+ * only copy the prototype. Does nothing before the sample rate is known.
+ */
+void OscillatorWrapper::materialize(int waveIndex)
+{
+    if (waveIndex < 0 || waveIndex >= numWaveTypes)
+        return;
+
+    std::lock_guard<std::mutex> lock(materializeMutex);
+
+    if (oscillators[waveIndex] || wavetables == nullptr)
+        return;
+
+    installOscillator(waveIndex);
+}
+
+/** @brief Returns true if the waveform's oscillator has been built. */
+bool OscillatorWrapper::isMaterialized(int waveIndex) const
+{
+    return waveIndex >= 0 && waveIndex < numWaveTypes &&
+           readyOscillators[waveIndex].load(std::memory_order_acquire) != nullptr;
+}
+
+/** @brief Switches to another set and rescales the phase increment of the current frequency. */
+void OscillatorWrapper::setWavetables(std::shared_ptr<WavetableSet> tables)
 {
-    sampleRate = fs;
+    {
+        std::lock_guard<std::mutex> lock(materializeMutex);
+        if (tables == nullptr || tables == wavetables)
+            return;
+
+        wavetables = std::move(tables);
+        sampleRate = wavetables->getSampleRate();
+        rebuildMaterialized();
+    }
     updateFrequency();
 }
 
+/**
+ * @brief Sets the sample rate and rescales the phase increment of the current frequency.
+ *
+ * Table lengths depend on the sample rate: if the installed set was built
+ * for another rate (or there is none), a private set is created and every
+ * oscillator built so far is copied from it. Only while the audio thread is
+ * not rendering (prepareToPlay).
+ */
+void OscillatorWrapper::setSampleRate(double fs)
+{
+    std::shared_ptr<WavetableSet> tables;
+    {
+        std::lock_guard<std::mutex> lock(materializeMutex);
+        if (wavetables == nullptr || wavetables->getSampleRate() != fs)
+            tables = std::make_shared<WavetableSet>(fs);
+    }
+
+    if (tables != nullptr)
+        setWavetables(std::move(tables));
+    else
+        updateFrequency();
+}
+
+/** @brief Copies the built oscillators (and the Sine) from wavetables (materializeMutex held). */
+void OscillatorWrapper::rebuildMaterialized()
+{
+    // The Sine is always built: FM reads its tables and the layers its bank grid
+    for (int waveIndex = 0; waveIndex < numWaveTypes; ++waveIndex)
+        if (waveIndex == 0 || oscillators[waveIndex])
+            installOscillator(waveIndex);
+
+    activeOsc = readyOscillators[currentWaveIndex].load(std::memory_order_acquire);
+    if (activeOsc)
+        activeOsc->setAmplitude(amplitude);
+}
+
 /** @brief Sets the MIDI note and updates oscillator frequency accordingly. */
-void OscillatorWrapper::setNote(int midiNoteIn)
+void OscillatorWrapper::setNote(int midiNote)
 {
-    midiNote = midiNoteIn;
+    frequency = 440.0 * std::pow(2.0, (midiNote - 69) / 12.0);
     updateFrequency();
 }
 
+/** @brief Sets a precomputed note frequency on the active oscillator. */
+void OscillatorWrapper::setNoteFrequency(double hz, double delta)
+{
+    frequency = hz;
+    phaseDelta = delta;
+    if (activeOsc)
+        activeOsc->setFrequencyAndDelta(frequency, phaseDelta);
+    if (layerMode)
+        updateLayerBanks();
+}
+
+/** @brief Stores the pulse width and applies it to Square if it is built (active or layer). */
+void OscillatorWrapper::setPulseWidth(float width)
+{
+    pulseWidth = width;
+    if (auto *square = readyOscillators[2].load(std::memory_order_acquire))
+        static_cast<Square *>(square)->setPulseWidth(pulseWidth);
+}
+
 /** @brief Sets the amplitude of the active oscillator. */
 void OscillatorWrapper::setAmplitude(float amp)
 {
@@ -44,30 +143,291 @@ void OscillatorWrapper::setAmplitude(float amp)
  * @brief Switches the active waveform.
  * @param waveIndex Index of the desired waveform.
  *
- * Updates amplitude and frequency of the newly selected oscillator.
+ * Updates amplitude and frequency of the newly selected oscillator. If it has
+ * not been materialized yet, the current oscillator keeps playing and the
+ * request stays pending until it is.
  */
 void OscillatorWrapper::setWaveType(int waveIndex)
 {
-    if (waveIndex != currentWaveIndex && waveIndex >= 0 && waveIndex < (int)oscillators.size())
+    if (waveIndex != currentWaveIndex && waveIndex >= 0 && waveIndex < numWaveTypes)
     {
+        auto *osc = readyOscillators[waveIndex].load(std::memory_order_acquire);
+        if (osc == nullptr)
+        {
+            pendingWaveIndex.store(waveIndex, std::memory_order_release);
+            return;
+        }
+
         currentWaveIndex = waveIndex;
-        activeOsc = oscillators[currentWaveIndex].get();
+        activeOsc = osc;
         activeOsc->setAmplitude(amplitude);
-        activeOsc->setFrequency(frequency, sampleRate);
+        activeOsc->setFrequencyAndDelta(frequency, phaseDelta);
+        activeOsc->setLinearInterpolation(linearInterpolation);
+        if (currentWaveIndex == 2)
+            static_cast<Square *>(activeOsc)->setPulseWidth(pulseWidth);
     }
+
+    if (pendingWaveIndex.load(std::memory_order_relaxed) != -1)
+        pendingWaveIndex.store(-1, std::memory_order_release);
+}
+
+/** @brief Enables or disables linear table interpolation on all oscillators. */
+void OscillatorWrapper::setLinearInterpolation(bool shouldInterpolate)
+{
+    linearInterpolation = shouldInterpolate;
+    for (auto &osc : readyOscillators)
+        if (auto *o = osc.load(std::memory_order_acquire))
+            o->setLinearInterpolation(shouldInterpolate);
 }
 
-/** @brief Updates the frequency of all oscillators based on the current MIDI note. */
+/**
+ * @brief Recomputes the phase increment of the current frequency and updates the active oscillator.
+ *
+ * The frequency is kept as set, so a note tuned by setNoteFrequency() keeps
+ * its pitch across a sample rate change. Inactive oscillators are updated by
+ * setWaveType() when they become active.
+ */
 void OscillatorWrapper::updateFrequency()
 {
-    frequency = 440.0 * pow(2.0, (midiNote - 69) / 12.0);
-    for (auto &osc : oscillators)
-        if (osc)
-            osc->setFrequency(frequency, sampleRate);
+    phaseDelta = frequency / sampleRate;
+    if (activeOsc)
+        activeOsc->setFrequencyAndDelta(frequency, phaseDelta);
+    if (layerMode)
+        updateLayerBanks();
 }
 
-/** @brief Returns the next sample from the currently active oscillator. */
+/** @brief Returns the next sample from the currently active oscillator (or the layers). */
 float OscillatorWrapper::getNextSample()
 {
+    if (layerMode)
+    {
+        float sample = 0.0f;
+        renderLayers(&sample, nullptr, 1);
+        return sample;
+    }
     return activeOsc ? activeOsc->getNextSample() : 0.0f;
 }
+
+/** @brief Sets the phase of the currently active oscillator, or of the note in layer mode. */
+void OscillatorWrapper::setPhase(double phase)
+{
+    if (layerMode)
+        layerPhase = phase;
+    else if (activeOsc)
+        activeOsc->setPhase(phase);
+}
+
+/** @brief Renders a block from the currently active oscillator (or the layers). */
+void OscillatorWrapper::renderBlock(float *out, int numSamples)
+{
+    if (layerMode)
+        renderLayers(out, nullptr, numSamples);
+    else if (activeOsc)
+        activeOsc->renderBlock(out, numSamples);
+    else
+        std::fill(out, out + numSamples, 0.0f);
+}
+
+/** @brief Renders a pitch-modulated block from the currently active oscillator (or the layers). */
+void OscillatorWrapper::renderBlockModulated(float *out, const float *ratio, int numSamples)
+{
+    if (layerMode)
+        renderLayers(out, ratio, numSamples);
+    else if (activeOsc)
+        activeOsc->renderBlockModulated(out, ratio, numSamples);
+    else
+        std::fill(out, out + numSamples, 0.0f);
+}
+
+//==============================================================================
+namespace
+{
+    double wrapPhase(double p)
+    {
+        return p - std::floor(p);
+    }
+}
+
+/**
+ * @brief Switches layer mode on or off.
+ *
+ * Entering layer mode continues from the active oscillator's phase, with
+ * every layer aligned to the start of the note cycle.
+ */
+void OscillatorWrapper::setLayerMode(bool enabled)
+{
+    if (enabled == layerMode)
+        return;
+
+    layerMode = enabled;
+    if (layerMode)
+    {
+        layerPhase = activeOsc ? activeOsc->getPhase() : 0.0;
+        for (auto &layer : layers)
+            layer.cycleOffset = 0.0;
+        updateLayerBanks();
+    }
+    else
+    {
+        pendingLayerWave.store(-1, std::memory_order_release);
+    }
+}
+
+/** @brief Stores a layer's settings; ratio and bank only change with octave or detune. */
+void OscillatorWrapper::setLayer(int waveIndex, const LayerSettings &settings)
+{
+    if (waveIndex < 0 || waveIndex >= numWaveTypes)
+        return;
+
+    auto &layer = layers[size_t(waveIndex)];
+    const bool pitchChanged = settings.octave != layer.settings.octave ||
+                              settings.detuneCents != layer.settings.detuneCents;
+    layer.settings = settings;
+
+    if (pitchChanged)
+    {
+        layer.ratio = std::exp2(double(settings.octave) + double(settings.detuneCents) / 1200.0);
+        if (const auto *grid = static_cast<const WavetableOscillator *>(readyOscillators[0].load(std::memory_order_acquire)))
+            layer.bank = grid->getBankFor(frequency * layer.ratio);
+    }
+}
+
+/**
+ * @brief Looks up each layer's bank on the shared grid.
+ *
+ * Every waveform uses the Sine's bank centers (Square and Triangle follow
+ * the saw grid, which is the same), so one grid serves all layers.
+ */
+void OscillatorWrapper::updateLayerBanks()
+{
+    const auto *grid = static_cast<const WavetableOscillator *>(readyOscillators[0].load(std::memory_order_acquire));
+    if (grid == nullptr)
+        return;
+
+    for (auto &layer : layers)
+        layer.bank = grid->getBankFor(frequency * layer.ratio);
+}
+
+/** @brief Clears out and adds the layers piece by piece. */
+void OscillatorWrapper::renderLayers(float *out, const float *ratio, int numSamples)
+{
+    std::fill(out, out + numSamples, 0.0f);
+
+    for (int start = 0; start < numSamples; start += layerPieceSize)
+    {
+        const int n = std::min(layerPieceSize, numSamples - start);
+        renderLayerPiece(out + start, ratio != nullptr ? ratio + start : nullptr, n);
+    }
+}
+
+/**
+ * @brief Adds every audible layer to out, driven by the note's phase.
+ *
+ * Free-running layers are read once over the piece, starting at
+ * cycleOffset + ratio × phase. The note's phase is then advanced once for
+ * all layers; synced layers are read run by run between its wraps, each
+ * run starting at ratio × (phase since the wrap), so the restart keeps its
+ * sub-sample position. Under pitch modulation each layer reads the bank for
+ * the highest frequency of the piece, so no layer aliases.
+ */
+void OscillatorWrapper::renderLayerPiece(float *out, const float *ratio, int numSamples)
+{
+    const auto &kernels = KernelDispatch::get();
+    float layerOut[layerPieceSize];
+
+    // Banks come from the shared grid: one lookup per layer frequency
+    std::array<size_t, numWaveTypes> banks{};
+    const auto *grid = static_cast<const WavetableOscillator *>(readyOscillators[0].load(std::memory_order_acquire));
+    const double maxRatio = ratio != nullptr ? double(*std::max_element(ratio, ratio + numSamples)) : 1.0;
+
+    std::array<const WavetableOscillator *, numWaveTypes> sources{};
+    bool anySynced = false;
+    int missing = -1;
+
+    for (int k = 0; k < numWaveTypes; ++k)
+    {
+        const auto &layer = layers[size_t(k)];
+        if (layer.settings.level <= 0.0f)
+            continue;
+
+        sources[size_t(k)] = static_cast<const WavetableOscillator *>(readyOscillators[size_t(k)].load(std::memory_order_acquire));
+        if (sources[size_t(k)] == nullptr)
+        {
+            if (missing == -1)
+                missing = k;
+            continue;
+        }
+
+        banks[size_t(k)] = ratio != nullptr && grid != nullptr ? grid->getBankFor(frequency * layer.ratio * maxRatio)
+                                                               : layer.bank;
+        anySynced = anySynced || layer.settings.sync;
+    }
+
+    if (pendingLayerWave.load(std::memory_order_relaxed) != missing)
+        pendingLayerWave.store(missing, std::memory_order_release);
+
+    // Free-running layers: one read over the piece from the shared phase
+    const double startPhase = layerPhase;
+    for (int k = 0; k < numWaveTypes; ++k)
+    {
+        const auto &layer = layers[size_t(k)];
+        if (sources[size_t(k)] == nullptr || layer.settings.sync)
+            continue;
+
+        sources[size_t(k)]->readWave(banks[size_t(k)], wrapPhase(layer.cycleOffset + layer.ratio * startPhase),
+                                     phaseDelta * layer.ratio, ratio, amplitude * layer.settings.level,
+                                     linearInterpolation, layerOut, numSamples);
+        kernels.mixInto(out, layerOut, numSamples);
+    }
+
+    // Synced layers: one run per cycle of the note
+    auto renderSyncedRun = [&](int runStart, int runLength, double runPhase)
+    {
+        for (int k = 0; k < numWaveTypes; ++k)
+        {
+            const auto &layer = layers[size_t(k)];
+            if (sources[size_t(k)] == nullptr || !layer.settings.sync)
+                continue;
+
+            sources[size_t(k)]->readWave(banks[size_t(k)], wrapPhase(layer.ratio * runPhase),
+                                         phaseDelta * layer.ratio, ratio != nullptr ? ratio + runStart : nullptr,
+                                         amplitude * layer.settings.level, linearInterpolation, layerOut, runLength);
+            kernels.mixInto(out + runStart, layerOut, runLength);
+        }
+    };
+
+    // The shared accumulator advances once for all layers
+    double phase = startPhase;
+    double wraps = 0.0;
+    if (!anySynced && ratio == nullptr)
+    {
+        phase = startPhase + phaseDelta * numSamples;
+        wraps = std::floor(phase);
+        phase -= wraps;
+    }
+    else
+    {
+        int runStart = 0;
+        double runPhase = startPhase;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            phase += ratio != nullptr ? phaseDelta * ratio[i] : phaseDelta;
+            if (phase < 1.0)
+                continue;
+
+            phase -= 1.0;
+            wraps += 1.0;
+            if (anySynced)
+                renderSyncedRun(runStart, i + 1 - runStart, runPhase);
+            runStart = i + 1;
+            runPhase = phase;
+        }
+        if (anySynced && runStart < numSamples)
+            renderSyncedRun(runStart, numSamples - runStart, runPhase);
+    }
+    layerPhase = phase;
+
+    // Each full note cycle moves a free-running layer by ratio cycles
+    for (auto &layer : layers)
+        layer.cycleOffset = layer.settings.sync ? 0.0 : wrapPhase(layer.cycleOffset + layer.ratio * wraps);
+}
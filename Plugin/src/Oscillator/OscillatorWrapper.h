@@ -1,11 +1,16 @@
 #pragma once
 #include "Oscillator.h"
+#include "WavetableSet.h"
 #include "Waves/Sine.h"
 #include "Waves/Saw.h"
 #include "Waves/Square.h"
 #include "Waves/Triangle.h"
 #include <array>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 /**
  * @class OscillatorWrapper
@@ -14,42 +19,237 @@
  * Provides a unified interface to switch between Sine, Saw, Square, and Triangle
  * waveforms while maintaining frequency, amplitude, and sample rate consistency.
  *
- * Handles MIDI note input and converts it to frequency for all internal oscillators.
+ * Handles MIDI note input and converts it to frequency. Only the active
+ * oscillator follows the frequency; the others pick it up when setWaveType()
+ * switches to them.
+ *
+ * Square has no tables of its own: it reads the Saw banks, so building
+ * Square also builds Saw, and both share one set of saw tables.
+ *
+ * The banks live in a WavetableSet shared by every voice of the processor
+ * (setWavetables()); the wrapper only holds per-voice copies of the set's
+ * oscillators, which carry phase and frequency but no tables. Nothing is
+ * built before the sample rate is known: the Sine is built when the set is
+ * installed (or by setSampleRate()), any other waveform by materialize(),
+ * which runs off the audio thread. When setWaveType() asks for
+ * a waveform that is not built yet, the wrapper keeps playing the current one
+ * and records the request (getPendingWaveType()) so the owner can build it in
+ * the background; the switch then happens on the next setWaveType() call.
+ *
+ * In layer mode all four waveforms play at once, each with its own level,
+ * octave/detune and hard sync (LayerSettings), instead of the active one.
+ * The wrapper keeps one phase accumulator for the note; every layer's phase
+ * is derived from it (its offset at the start of the current note cycle
+ * plus ratio × the note's phase), so hard sync is just dropping that offset
+ * at each cycle. All waveforms share one bank grid, so the bank of each
+ * layer is looked up once per frequency change, not per layer oscillator.
  */
 class OscillatorWrapper
 {
 public:
-    /** @brief Constructs the wrapper and initializes all oscillator instances. */
+    /** @brief Number of selectable waveforms. */
+    static constexpr int numWaveTypes = 4;
+
+    /**
+     * @brief Settings of one layer in layer mode (one layer per waveform).
+     */
+    struct LayerSettings
+    {
+        float level = 0.0f;       ///< Linear gain; 0 mutes the layer.
+        int octave = 0;           ///< Octaves from the note.
+        float detuneCents = 0.0f; ///< Fine offset from the note, in cents.
+        bool sync = false;        ///< Hard sync: the layer restarts at every cycle of the note.
+
+        bool operator==(const LayerSettings &other) const
+        {
+            return level == other.level && octave == other.octave &&
+                   detuneCents == other.detuneCents && sync == other.sync;
+        }
+        bool operator!=(const LayerSettings &other) const { return !(*this == other); }
+    };
+
+    /** @brief Constructs the wrapper; nothing is built until the sample rate is known. */
     OscillatorWrapper();
 
-    /** @brief Sets the current MIDI note and updates oscillator frequency. */
+    /** @brief Sets the current MIDI note (12-TET, A4 = 440 Hz) and updates oscillator frequency. */
     void setNote(int midiNote);
 
-    /** @brief Sets the system sample rate (Hz) and updates oscillators. */
+    /**
+     * @brief Sets the note frequency from a precomputed tuning entry.
+     * @param hz Frequency in Hz.
+     * @param phaseDelta hz / sample rate.
+     *
+     * Constant time: no pow(), and only the active oscillator is touched.
+     */
+    void setNoteFrequency(double hz, double phaseDelta);
+
+    /** @brief Unmodulated frequency of the current note, in Hz. */
+    double getFrequency() const { return frequency; }
+
+    /** @brief Phase increment per sample of the current note. */
+    double getPhaseDelta() const { return phaseDelta; }
+
+    /** @brief Phase of the active oscillator (0 if none), or of the note in layer mode. */
+    double getPhase() const { return layerMode ? layerPhase : activeOsc ? activeOsc->getPhase() : 0.0; }
+
+    /** @brief Sets the phase of the active oscillator, or of the note in layer mode. */
+    void setPhase(double phase);
+
+    /**
+     * @brief Reads the banks of a shared set from now on.
+     * @param tables Set built for the processor's sample rate.
+     *
+     * Replaces the built oscillators with copies from the new set (the Sine
+     * always) and adopts its sample rate, so getSine() returns a new object
+     * afterwards. Never call while the audio thread is rendering.
+     */
+    void setWavetables(std::shared_ptr<WavetableSet> tables);
+
+    /**
+     * @brief Sets the system sample rate (Hz) and updates oscillators.
+     *
+     * Keeps the installed set if it was built for this rate; otherwise the
+     * wrapper builds a private one (tools and tests that drive a voice on
+     * its own). Never call while the audio thread is rendering.
+     */
     void setSampleRate(double fs);
 
+    /**
+     * @brief Sets the pulse width of the Square waveform.
+     * @param width Fraction of the cycle; 0.5 = square.
+     *
+     * Real-time safe; kept and applied when Square becomes active.
+     */
+    void setPulseWidth(float width);
+
     /** @brief Sets the output amplitude (linear scaling). */
     void setAmplitude(float amp);
 
     /**
      * @brief Selects the active waveform.
      * @param waveIndex Index of the waveform: 0 = Sine, 1 = Saw, 2 = Square, 3 = Triangle.
+     *
+     * Real-time safe. If the waveform has not been materialized yet the current
+     * waveform keeps playing and the request is left pending.
      */
     void setWaveType(int waveIndex);
 
+    /**
+     * @brief Builds the oscillator for a waveform if it does not exist yet.
+     * @param waveIndex Index of the waveform to build.
+     *
+     * Generates the wavetable banks, so it must not run on the audio thread.
+     * Safe to call concurrently with the audio thread and with itself.
+     */
+    void materialize(int waveIndex);
+
+    /** @brief Returns true if the waveform's oscillator has been built. */
+    bool isMaterialized(int waveIndex) const;
+
+    /** @brief The Sine oscillator (built once the rate is known), for sources that read its tables; replaced by setWavetables(). */
+    std::shared_ptr<const WavetableOscillator> getSine() const
+    {
+        return std::static_pointer_cast<const WavetableOscillator>(oscillators[0]);
+    }
+
+    /**
+     * @brief Mixes all waveforms (layer mode) instead of playing the active one.
+     * @param enabled True for layer mode.
+     *
+     * Real-time safe. Layers whose waveform is not built yet stay silent and
+     * are reported by getPendingWaveType() until they are.
+     */
+    void setLayerMode(bool enabled);
+
+    /** @brief True if renderBlock() mixes the layers. */
+    bool isLayerMode() const { return layerMode; }
+
+    /**
+     * @brief Sets one layer.
+     * @param waveIndex Waveform of the layer (same indices as setWaveType()).
+     * @param settings Level, octave, detune and sync.
+     *
+     * Real-time safe; exp2 and the bank search only run when octave or
+     * detune change.
+     */
+    void setLayer(int waveIndex, const LayerSettings &settings);
+
+    /**
+     * @brief Returns a waveform that was asked for but is not built yet, or -1.
+     *
+     * Either the one requested by setWaveType() or, in layer mode, an
+     * audible layer.
+     */
+    int getPendingWaveType() const
+    {
+        const int wave = pendingWaveIndex.load(std::memory_order_acquire);
+        return wave != -1 ? wave : pendingLayerWave.load(std::memory_order_acquire);
+    }
+
+    /** @brief Enables or disables linear table interpolation on all oscillators. */
+    void setLinearInterpolation(bool shouldInterpolate);
+
     /** @brief Retrieves the next sample from the currently active oscillator. */
     float getNextSample();
 
+    /** @brief Renders numSamples from the active oscillator (or the layers) into out (overwrites). */
+    void renderBlock(float *out, int numSamples);
+
+    /** @brief renderBlock() with per-sample frequency multipliers (see OscillatorBase). */
+    void renderBlockModulated(float *out, const float *ratio, int numSamples);
+
 private:
-    std::array<std::unique_ptr<OscillatorBase>, 4> oscillators; /**< Internal oscillators: Sine, Saw, Square, Triangle. */
-    OscillatorBase *activeOsc = nullptr;                        /**< Pointer to currently active oscillator. */
+    /** @brief Samples rendered per layer pass; bounds the stack buffer. */
+    static constexpr int layerPieceSize = 256;
+
+    /** @brief One layer's settings and the state derived from them. */
+    struct Layer
+    {
+        LayerSettings settings;
+        double ratio = 1.0;       ///< Frequency multiplier from octave and detune.
+        double cycleOffset = 0.0; ///< Layer phase at the start of the note's current cycle.
+        size_t bank = 0;          ///< Bank for frequency × ratio.
+    };
+
+    /** @brief Recomputes every layer's bank for the current frequency. */
+    void updateLayerBanks();
+
+    /**
+     * @brief Renders the layers, in pieces of layerPieceSize.
+     * @param ratio Per-sample frequency multipliers, or nullptr.
+     */
+    void renderLayers(float *out, const float *ratio, int numSamples);
+
+    /** @brief One piece of renderLayers(): adds every audible layer into out. */
+    void renderLayerPiece(float *out, const float *ratio, int numSamples);
+
+    /** @brief Copies every built oscillator (and the Sine) from wavetables and republishes it (materializeMutex held). */
+    void rebuildMaterialized();
+
+    /** @brief Copies one oscillator from wavetables, applies the wrapper's settings and publishes it (materializeMutex held). */
+    void installOscillator(int waveIndex);
+
+    std::shared_ptr<WavetableSet> wavetables;                                      /**< Shared banks; nullptr until the sample rate is known. */
+    std::array<std::shared_ptr<OscillatorBase>, numWaveTypes> oscillators;        /**< This voice's copies, built on demand. */
+    std::array<std::atomic<OscillatorBase *>, numWaveTypes> readyOscillators{};    /**< Built oscillators, published to the audio thread. */
+    OscillatorBase *activeOsc = nullptr;                                           /**< Pointer to currently active oscillator. */
+    std::mutex materializeMutex;                                                   /**< Serializes materialize() calls (never taken by the audio thread). */
+
+    std::atomic<int> pendingWaveIndex{-1}; /**< Waveform waiting to be materialized. */
+    std::atomic<int> pendingLayerWave{-1}; /**< Audible layer waiting to be materialized. */
+
+    std::array<Layer, numWaveTypes> layers; /**< One layer per waveform (layer mode). */
+    bool layerMode = false;                 /**< Mix the layers instead of the active oscillator. */
+    double layerPhase = 0.0;                /**< Phase of the note in layer mode, the one accumulator all layers derive from. */
 
     int currentWaveIndex = 0;    /**< Currently selected waveform index. */
-    int midiNote = 69;           /**< Current MIDI note number. */
     double sampleRate = 44100.0; /**< Sample rate in Hz. */
-    double frequency = 440.0;    /**< Frequency corresponding to MIDI note. */
+    double frequency = 440.0;    /**< Note frequency, from setNote() or setNoteFrequency(). */
+    double phaseDelta = 440.0 / 44100.0; /**< frequency / sampleRate. */
     float amplitude = 1.0f;      /**< Output amplitude. */
+    bool linearInterpolation = true; /**< Interpolation mode applied to every oscillator. */
+    float pulseWidth = 0.5f;     /**< Square pulse width. */
 
-    /** @brief Updates frequency based on current MIDI note and sample rate. */
+    /** @brief Sets phaseDelta from frequency and sampleRate (active oscillator only). */
     void updateFrequency();
 };
@@ -0,0 +1,282 @@
+#include "UserWavetable.h"
+#include "DSP/InverseFFT.h"
+#include "Performance/Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr int frameOrder = 11; // log2(frameSize)
+    static_assert((1 << frameOrder) == UserWavetable::frameSize, "frameOrder must match frameSize");
+
+    /**
+     * @brief Header of a cache file, followed by the tables (level-major, native byte order).
+     *
+     * The cache is local to the machine, so the samples are stored as the CPU
+     * reads them and mapped without conversion. 64 bytes keeps the tables
+     * aligned for the kernels.
+     */
+    struct CacheHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t numFrames;
+        uint32_t frameSize;
+        uint32_t numLevels;
+        uint32_t minTableSize;
+        uint64_t hash;
+        uint8_t reserved[32];
+    };
+    static_assert(sizeof(CacheHeader) == 64, "CacheHeader must stay 64 bytes");
+
+    constexpr char cacheMagic[4] = {'T', 'E', 'C', 'W'};
+    constexpr uint32_t cacheVersion = 1;
+
+    int log2Of(int size)
+    {
+        int order = 0;
+        while ((1 << order) < size)
+            ++order;
+        return order;
+    }
+}
+
+UserWavetable::UserWavetable(int frames, uint64_t tableHash)
+    : numFrames(frames), hash(tableHash)
+{
+    size_t offset = 0;
+    for (int level = 0; level < numLevels; ++level)
+    {
+        levelOffsets[size_t(level)] = offset;
+        offset += size_t(numFrames) * size_t(getLevelSize(level));
+    }
+}
+
+size_t UserWavetable::samplesPerFrame()
+{
+    size_t total = 0;
+    for (int level = 0; level < numLevels; ++level)
+        total += size_t(getLevelSize(level));
+    return total;
+}
+
+int UserWavetable::getLevelFor(double phaseDelta)
+{
+    // Harmonic h of the note advances h · phaseDelta cycles per sample (must stay < 0.5)
+    for (int level = 0; level < numLevels - 1; ++level)
+        if (double(getLevelHarmonics(level)) * phaseDelta < 0.5)
+            return level;
+    return numLevels - 1;
+}
+
+bool UserWavetable::readWavFile(const juce::File &file, std::vector<float> &frames, juce::String *errorMessage)
+{
+    auto fail = [errorMessage](const juce::String &message)
+    {
+        if (errorMessage != nullptr)
+            *errorMessage = message;
+        return false;
+    };
+
+    auto stream = file.createInputStream();
+    if (stream == nullptr)
+        return fail("cannot open file");
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(stream.release(), true));
+    if (reader == nullptr)
+        return fail("not a WAV file");
+
+    const auto length = reader->lengthInSamples;
+    if (length < frameSize || length % frameSize != 0)
+        return fail("length is not a multiple of " + juce::String(frameSize) + " samples");
+    if (length / frameSize > maxFrames)
+        return fail("more than " + juce::String(maxFrames) + " frames");
+
+    const int numSamples = int(length);
+    const int numChannels = juce::jmax(1, int(reader->numChannels));
+    juce::AudioBuffer<float> buffer(numChannels, numSamples);
+    if (!reader->read(&buffer, 0, numSamples, 0, true, numChannels > 1))
+        return fail("cannot read samples");
+
+    // Mix down to mono
+    frames.assign(size_t(numSamples), 0.0f);
+    const float gain = 1.0f / float(numChannels);
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float *source = buffer.getReadPointer(channel);
+        for (int i = 0; i < numSamples; ++i)
+            frames[size_t(i)] += source[i] * gain;
+    }
+    return true;
+}
+
+uint64_t UserWavetable::computeHash(const std::vector<float> &frames)
+{
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](const void *bytes, size_t size)
+    {
+        auto *p = static_cast<const uint8_t *>(bytes);
+        for (size_t i = 0; i < size; ++i)
+            h = (h ^ p[i]) * 1099511628211ull;
+    };
+
+    // The format version is part of the key: changing the mip-maps invalidates old cache files
+    mix(&cacheVersion, sizeof(cacheVersion));
+    mix(frames.data(), frames.size() * sizeof(float));
+    return h != 0 ? h : 1; // 0 means "no table" in the plugin state
+}
+
+juce::File UserWavetable::getDefaultCacheDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("TECSynth")
+        .getChildFile("WavetableCache");
+}
+
+juce::File UserWavetable::getCacheFile(const juce::File &cacheDirectory, uint64_t hash)
+{
+    return cacheDirectory.getChildFile(juce::String::toHexString(juce::int64(hash)).paddedLeft('0', 16) + ".tecwt");
+}
+
+std::unique_ptr<UserWavetable> UserWavetable::openCached(const juce::File &cacheDirectory, uint64_t hash)
+{
+    if (cacheDirectory == juce::File())
+        return nullptr;
+
+    const auto file = getCacheFile(cacheDirectory, hash);
+    if (!file.existsAsFile())
+        return nullptr;
+
+    // The frame count comes from the header; mapCache() checks the rest
+    CacheHeader header{};
+    {
+        juce::FileInputStream in(file);
+        if (!in.openedOk() || in.read(&header, int(sizeof(header))) != int(sizeof(header)))
+            return nullptr;
+    }
+    if (header.numFrames == 0 || header.numFrames > uint32_t(maxFrames))
+        return nullptr;
+
+    std::unique_ptr<UserWavetable> table(new UserWavetable(int(header.numFrames), hash));
+    if (!table->mapCache(file))
+        return nullptr;
+    return table;
+}
+
+bool UserWavetable::mapCache(const juce::File &file)
+{
+    auto mapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    if (mapping->getData() == nullptr || mapping->getSize() != sizeof(CacheHeader) + getTableBytes())
+        return false;
+
+    CacheHeader header;
+    std::memcpy(&header, mapping->getData(), sizeof(header));
+    if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion ||
+        header.numFrames != uint32_t(numFrames) || header.frameSize != uint32_t(frameSize) ||
+        header.numLevels != uint32_t(numLevels) || header.minTableSize != uint32_t(minTableSize) ||
+        header.hash != hash)
+        return false;
+
+    data = reinterpret_cast<const float *>(static_cast<const char *>(mapping->getData()) + sizeof(CacheHeader));
+    mapped = std::move(mapping);
+    std::vector<float>().swap(samples);
+    return true;
+}
+
+bool UserWavetable::writeCache(const juce::File &cacheDirectory)
+{
+    if (cacheDirectory == juce::File() || !cacheDirectory.createDirectory())
+        return false;
+
+    const auto file = getCacheFile(cacheDirectory, hash);
+
+    CacheHeader header{};
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = cacheVersion;
+    header.numFrames = uint32_t(numFrames);
+    header.frameSize = uint32_t(frameSize);
+    header.numLevels = uint32_t(numLevels);
+    header.minTableSize = uint32_t(minTableSize);
+    header.hash = hash;
+
+    // Write to a temporary file and rename, so another instance never maps a partial file
+    juce::TemporaryFile temporary(file);
+    {
+        juce::FileOutputStream out(temporary.getFile());
+        if (!out.openedOk() || !out.write(&header, sizeof(header)) ||
+            !out.write(samples.data(), samples.size() * sizeof(float)))
+            return false;
+        out.flush();
+        if (out.getStatus().failed())
+            return false;
+    }
+    if (!temporary.overwriteTargetFileWithTemporary())
+        return false;
+
+    return mapCache(file);
+}
+
+/**
+ * @brief Band-limits every frame at every level through the FFT.
+ *
+ * One forward FFT per frame gives its harmonics; each level keeps the ones
+ * up to its limit and an inverse FFT at the level's size writes the table,
+ * so no level is resampled from another.
+ */
+std::unique_ptr<UserWavetable> UserWavetable::build(const std::vector<float> &frames, const juce::File &cacheDirectory)
+{
+    TEC_TRACE_SCOPE("UserWavetable::build");
+
+    const int frameCount = int(frames.size() / size_t(frameSize));
+    if (frameCount < 1 || frameCount > maxFrames)
+        return nullptr;
+
+    std::unique_ptr<UserWavetable> table(new UserWavetable(frameCount, computeHash(frames)));
+    table->samples.assign(size_t(frameCount) * samplesPerFrame(), 0.0f);
+
+    juce::dsp::FFT forward(frameOrder);
+    InverseFFT inverse(frameOrder);
+    std::vector<float> spectrum(size_t(2 * frameSize));
+    std::vector<float> re(size_t(frameSize / 2 + 1)), im(size_t(frameSize / 2 + 1));
+
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+        std::copy_n(frames.begin() + std::ptrdiff_t(frame) * frameSize, frameSize, spectrum.begin());
+        std::fill(spectrum.begin() + frameSize, spectrum.end(), 0.0f);
+        forward.performRealOnlyForwardTransform(spectrum.data(), true); // bins 0 … N/2, (re, im)
+
+        for (int level = 0; level < numLevels; ++level)
+        {
+            const int size = getLevelSize(level);
+            const int harmonics = getLevelHarmonics(level);
+
+            // No DC; harmonics up to the level's limit, scaled for the unnormalized inverse
+            const float scale = 1.0f / float(frameSize);
+            for (int k = 0; k <= size / 2; ++k)
+            {
+                const bool kept = k >= 1 && k <= harmonics;
+                re[size_t(k)] = kept ? spectrum[size_t(2 * k)] * scale : 0.0f;
+                im[size_t(k)] = kept ? spectrum[size_t(2 * k + 1)] * scale : 0.0f;
+            }
+            // The table's Nyquist bin is real
+            im[size_t(size / 2)] = 0.0f;
+
+            float *out = table->samples.data() + table->levelOffsets[size_t(level)] + size_t(frame) * size_t(size);
+            inverse.performReal(re.data(), im.data(), out, log2Of(size));
+        }
+    }
+
+    // One gain for the whole table, so morphing keeps the frames' relative levels
+    float peak = 0.0f;
+    for (float v : table->samples)
+        peak = std::max(peak, std::abs(v));
+    if (peak > 0.0f)
+        for (auto &v : table->samples)
+            v /= peak;
+
+    table->data = table->samples.data();
+    table->writeCache(cacheDirectory); // on failure the tables stay on the heap
+    return table;
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @class UserWavetable
+ * @brief Imported multi-frame wavetable with band-limited mip-maps of every frame.
+ *
+ * The source is a WAV file holding up to maxFrames single cycles of
+ * frameSize samples each, one after another (the usual wavetable layout).
+ * Each frame is stored at numLevels mip levels: level m keeps the harmonics
+ * up to getLevelHarmonics(m) (1024 at level 0, halving per level) and has
+ * getLevelSize(m) samples, at least four per cycle of its top harmonic. The
+ * DC offset is removed and the whole table is normalized to a peak of 1.
+ *
+ * Building the mip-maps costs one forward FFT per frame and one inverse FFT
+ * per frame and level, so it runs on a background thread. The result is
+ * written to a cache file named after a hash of the source frames and then
+ * memory-mapped: a table of 256 frames is about 6.5 MB, which the OS pages
+ * in on demand and shares between plugin instances, and reopening a project
+ * maps the cached file again instead of regenerating it. If the cache cannot
+ * be written, the tables stay on the heap.
+ *
+ * Immutable once built; every voice reads the same instance.
+ */
+class UserWavetable
+{
+public:
+    /** @brief Samples per frame in the source file. */
+    static constexpr int frameSize = 2048;
+
+    /** @brief Most frames per table. */
+    static constexpr int maxFrames = 256;
+
+    /** @brief Mip levels: 1024 harmonics down to 1. */
+    static constexpr int numLevels = 11;
+
+    /** @brief Smallest level table. */
+    static constexpr int minTableSize = 64;
+
+    /** @brief Highest harmonic kept at a mip level. */
+    static constexpr int getLevelHarmonics(int level) { return (frameSize / 2) >> level; }
+
+    /** @brief Samples per cycle at a mip level: four per cycle of the top harmonic, within [minTableSize, frameSize]. */
+    static constexpr int getLevelSize(int level)
+    {
+        return std::min(frameSize, std::max(minTableSize, 4 * getLevelHarmonics(level)));
+    }
+
+    /**
+     * @brief Reads the frames of a wavetable WAV file (channels mixed to mono).
+     * @param file WAV file; its length must be a whole number of frames, at most maxFrames.
+     * @param frames Receives numFrames · frameSize samples.
+     * @param errorMessage Optional; receives the reason on failure.
+     */
+    static bool readWavFile(const juce::File &file, std::vector<float> &frames, juce::String *errorMessage = nullptr);
+
+    /** @brief Cache key of a set of frames (64-bit FNV-1a of the samples). */
+    static uint64_t computeHash(const std::vector<float> &frames);
+
+    /** @brief Default cache directory, next to the user preset bank. */
+    static juce::File getDefaultCacheDirectory();
+
+    /**
+     * @brief Maps the cached mip-maps of a table, if the cache holds them.
+     * @return nullptr if there is no valid cache file for hash.
+     */
+    static std::unique_ptr<UserWavetable> openCached(const juce::File &cacheDirectory, uint64_t hash);
+
+    /**
+     * @brief Generates the mip-maps of a set of frames and caches them.
+     * @param frames numFrames · frameSize samples (see readWavFile()).
+     * @param cacheDirectory Where the cache file goes; an invalid File keeps the tables on the heap.
+     *
+     * Slow (FFTs for every frame and level): never on the audio thread.
+     */
+    static std::unique_ptr<UserWavetable> build(const std::vector<float> &frames, const juce::File &cacheDirectory);
+
+    /** @brief Number of frames. */
+    int getNumFrames() const { return numFrames; }
+
+    /** @brief Hash of the source frames (cache key). */
+    uint64_t getHash() const { return hash; }
+
+    /** @brief Lowest mip level whose harmonics all stay below Nyquist at this phase increment. */
+    static int getLevelFor(double phaseDelta);
+
+    /** @brief One frame at one mip level: getLevelSize(level) samples. */
+    const float *getTable(int level, int frame) const
+    {
+        return data + levelOffsets[size_t(level)] + size_t(frame) * size_t(getLevelSize(level));
+    }
+
+    /** @brief True if the tables are read from a memory-mapped cache file. */
+    bool isMapped() const { return mapped != nullptr; }
+
+    /** @brief Bytes of the tables (mapped or on the heap). */
+    size_t getTableBytes() const { return size_t(numFrames) * samplesPerFrame() * sizeof(float); }
+
+private:
+    UserWavetable(int numFrames, uint64_t hash);
+
+    /** @brief Samples of one frame over all levels. */
+    static size_t samplesPerFrame();
+
+    /** @brief Cache file of a hash. */
+    static juce::File getCacheFile(const juce::File &cacheDirectory, uint64_t hash);
+
+    /** @brief Writes samples to the cache file and maps it; false leaves the heap copy in use. */
+    bool writeCache(const juce::File &cacheDirectory);
+
+    /** @brief Maps a cache file and checks its header; false if it does not hold this table. */
+    bool mapCache(const juce::File &file);
+
+    int numFrames = 0;
+    uint64_t hash = 0;
+
+    /** @brief Offset of each level's first frame; frames of a level are contiguous. */
+    std::array<size_t, numLevels> levelOffsets{};
+
+    std::unique_ptr<juce::MemoryMappedFile> mapped;
+    std::vector<float> samples; ///< Heap tables while building, or when the cache is unavailable.
+    const float *data = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UserWavetable)
+};
@@ -0,0 +1,64 @@
+#include "UserWavetableOscillator.h"
+#include "DSP/KernelDispatch.h"
+#include <algorithm>
+
+void UserWavetableOscillator::renderBlock(float *out, int numSamples)
+{
+    for (int start = 0; start < numSamples; start += pieceSize)
+        renderPiece(out + start, nullptr, std::min(pieceSize, numSamples - start));
+}
+
+void UserWavetableOscillator::renderBlockModulated(float *out, const float *ratio, int numSamples)
+{
+    for (int start = 0; start < numSamples; start += pieceSize)
+        renderPiece(out + start, ratio + start, std::min(pieceSize, numSamples - start));
+}
+
+/**
+ * @brief Reads the two frames around the position and mixes them.
+ *
+ * The level comes from the piece's highest multiplier, so a bend up never
+ * aliases; a bend down plays a level with fewer harmonics than it could.
+ */
+void UserWavetableOscillator::renderPiece(float *out, const float *ratio, int numSamples)
+{
+    if (table == nullptr)
+    {
+        std::fill(out, out + numSamples, 0.0f);
+        return;
+    }
+
+    double highestDelta = phaseDelta;
+    if (ratio != nullptr)
+        highestDelta *= double(*std::max_element(ratio, ratio + numSamples));
+
+    const int level = UserWavetable::getLevelFor(highestDelta);
+    const int size = UserWavetable::getLevelSize(level);
+
+    const float framePosition = position * float(table->getNumFrames() - 1);
+    const int frame = std::min(int(framePosition), table->getNumFrames() - 1);
+    const float fraction = framePosition - float(frame);
+
+    const auto &kernels = KernelDispatch::get();
+    auto read = [&](int index, float gain, float *dest)
+    {
+        const float *samples = table->getTable(level, index);
+        return ratio == nullptr
+                   ? kernels.renderWavetable(samples, size, phase, phaseDelta, gain, linearInterpolation,
+                                             dest, numSamples)
+                   : kernels.renderWavetableModulated(samples, size, phase, phaseDelta, ratio, gain,
+                                                      linearInterpolation, dest, numSamples);
+    };
+
+    if (fraction <= 0.0f || frame + 1 >= table->getNumFrames())
+    {
+        phase = read(frame, amplitude, out);
+        return;
+    }
+
+    // Both frames from the same phase: the second read ends where the first does
+    const double endPhase = read(frame, amplitude * (1.0f - fraction), out);
+    read(frame + 1, amplitude * fraction, morphBuffer.data());
+    kernels.mixInto(out, morphBuffer.data(), numSamples);
+    phase = endPhase;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "UserWavetable.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+/**
+ * @class UserWavetableOscillator
+ * @brief Plays an imported UserWavetable, morphing between adjacent frames.
+ *
+ * The morph position (0–1) maps onto the frames: position p reads frames
+ * floor(p · (numFrames - 1)) and the next one, crossfaded by the fraction.
+ * Both frames are read with the wavetable kernel from the same phase, so
+ * a morph costs two table reads and a mix; a position that falls exactly on
+ * a frame costs one.
+ *
+ * The mip level is chosen per piece from the highest pitch in it (the note,
+ * or its largest bend/vibrato multiplier), so no harmonic reaches Nyquist.
+ *
+ * The table is not owned; the owner swaps it only while the audio thread
+ * is not rendering. Without a table the oscillator renders silence.
+ */
+class UserWavetableOscillator
+{
+public:
+    /** @brief Sets the table to play (nullptr = silence). */
+    void setTable(const UserWavetable *newTable) { table = newTable; }
+
+    /** @brief Sets the morph position, 0 (first frame) to 1 (last frame). */
+    void setPosition(float newPosition) { position = std::clamp(newPosition, 0.0f, 1.0f); }
+
+    /** @brief Sets the note's phase increment per sample (frequency / sample rate). */
+    void setPhaseDelta(double delta) { phaseDelta = delta; }
+
+    /** @brief Output gain (velocity). */
+    void setAmplitude(float amp) { amplitude = amp; }
+
+    /** @brief Linear interpolation or drop-sample reads (QualityGovernor). */
+    void setLinearInterpolation(bool shouldInterpolate) { linearInterpolation = shouldInterpolate; }
+
+    /** @brief Restarts the phase. */
+    void noteOn() { phase = 0.0; }
+
+    /** @brief Renders numSamples into out (overwrites). */
+    void renderBlock(float *out, int numSamples);
+
+    /** @brief renderBlock() with per-sample frequency multipliers (pitch bend, glide, vibrato). */
+    void renderBlockModulated(float *out, const float *ratio, int numSamples);
+
+    /** @brief Bytes of the crossfade buffer (memory accounting). */
+    size_t getScratchBytes() const { return sizeof(morphBuffer); }
+
+private:
+    /** @brief Samples per kernel call; bounds the crossfade buffer. */
+    static constexpr int pieceSize = 256;
+
+    /** @brief Renders up to pieceSize samples (ratio may be nullptr). */
+    void renderPiece(float *out, const float *ratio, int numSamples);
+
+    const UserWavetable *table = nullptr;
+    float position = 0.0f;
+    double phaseDelta = 440.0 / 44100.0;
+    double phase = 0.0;
+    float amplitude = 1.0f;
+    bool linearInterpolation = true;
+
+    /** @brief Second frame of the morph. */
+    std::array<float, pieceSize> morphBuffer{};
+};
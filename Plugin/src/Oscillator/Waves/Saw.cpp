@@ -1,4 +1,5 @@
 #include "Saw.h"
+#include "Performance/Trace.h"
 #include <cmath>
 #include <algorithm>
 
@@ -33,7 +34,8 @@ Saw::Saw(double sampleRate, float velocity)
  */
 void Saw::generateWavetableBanks(double fs, float velocity)
 {
-    waveTables.clear();
+    TEC_TRACE_SCOPE("Saw::generateWavetableBanks");
+
     std::vector<std::vector<float>> tables;
     tables.reserve(banks.size());
 
@@ -69,6 +71,7 @@ void Saw::generateWavetableBanks(double fs, float velocity)
         tables.push_back(waveform);
     }
 
-    waveTables = tables;
+    setTables(std::move(tables));
     bankFreqs = banks;
+    currentBank = findClosestBank();
 }
@@ -1,4 +1,5 @@
 #include "Sine.h"
+#include "Performance/Trace.h"
 #include <algorithm>
 #include <cmath>
 
@@ -35,7 +36,8 @@ Sine::Sine(double sampleRate, float velocity)
  */
 void Sine::generateWavetableBanks(double fs, float velocity)
 {
-    waveTables.clear();
+    TEC_TRACE_SCOPE("Sine::generateWavetableBanks");
+
     std::vector<std::vector<float>> tables;
     tables.reserve(banks.size());
 
@@ -57,6 +59,7 @@ void Sine::generateWavetableBanks(double fs, float velocity)
         tables.push_back(waveform);
     }
 
-    waveTables = tables;
+    setTables(std::move(tables));
     bankFreqs = banks;
+    currentBank = findClosestBank();
 }
@@ -1,43 +1,46 @@
 #pragma once
 #include "Oscillator.h"
+#include "Saw.h"
+#include <memory>
 
 /**
  * @class Square
- * @brief Implements a band-limited square wave oscillator using wavetable synthesis.
+ * @brief Band-limited square / pulse oscillator read from the Saw banks.
  *
- * The Square class generates multiple wavetable banks, each containing a
- * band-limited single-cycle square waveform. Each bank is optimized for a
- * particular frequency range, limiting the number of harmonics included
- * to prevent aliasing above the Nyquist frequency.
+ * The pulse is the difference of two phase-offset reads of the same
+ * band-limited saw: saw(φ) - saw(φ + width). At width 0.5 the even
+ * harmonics cancel and the result is a square wave; other widths give a
+ * pulse, so pulse-width modulation comes for free. The Square stores no
+ * tables of its own: it shares the Saw's banks (and their storage format),
+ * so only the saw family has to stay cache-resident.
  *
- * Inherits from WavetableOscillator, which provides phase management,
- * table interpolation, and playback.
+ * Each bank's gain normalizes its 50% cycle to the velocity; the
+ * peak-to-peak level then stays constant across widths.
  */
-class Square : public WavetableOscillator
+class Square : public PhaseDifferenceOscillator
 {
 public:
     /**
-     * @brief Constructs a square oscillator and generates its wavetable banks.
+     * @brief Constructs a square oscillator over existing saw banks.
+     * @param saw Saw whose tables are read; kept alive by this oscillator.
+     * @param velocity Output amplitude scaling factor (default = 1.0f).
+     */
+    explicit Square(std::shared_ptr<const Saw> saw, float velocity = 1.0f);
+
+    /**
+     * @brief Constructs a square oscillator with its own saw banks.
      * @param sampleRate The system sample rate in Hz.
      * @param velocity Output amplitude scaling factor (default = 1.0f).
-     *
-     * Initializes the oscillator with a predefined set of frequency banks and
-     * precomputes the band-limited waveforms for each one.
      */
     Square(double sampleRate, float velocity = 1.0f);
 
-private:
     /**
-     * @brief Generates the band-limited square wavetable banks.
-     * @param fs Sampling rate in Hz.
-     * @param velocity Amplitude scaling factor.
-     *
-     * For each frequency bank, constructs a single-cycle square waveform by
-     * summing odd harmonics of a sine series up to the Nyquist limit. Each
-     * waveform is normalized and scaled by the velocity parameter.
+     * @brief Sets the pulse width.
+     * @param width Fraction of the cycle, clamped to [0.01, 0.99]; 0.5 = square.
      */
-    void generateWavetableBanks(double fs, float velocity);
+    void setPulseWidth(float width);
 
-    /** @brief Center frequencies (in Hz) defining each wavetable bank. */
-    std::vector<double> banks;
+private:
+    /** @brief Saw providing the banks. */
+    std::shared_ptr<const Saw> saw;
 };
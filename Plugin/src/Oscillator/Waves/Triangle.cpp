@@ -1,4 +1,5 @@
 #include "Triangle.h"
+#include "Performance/Trace.h"
 #include <cmath>
 #include <algorithm>
 
@@ -7,40 +8,37 @@
  * @param sampleRate Sampling rate in Hz.
  * @param velocity Amplitude scaling factor.
  *
- * Populates the internal list of frequency banks and generates a series of
- * band-limited triangle waveforms for efficient playback.
+ * Generates the integrated-saw banks, then reads them at +1/4 and -1/4 cycle.
  */
 Triangle::Triangle(double sampleRate, float velocity)
-    : WavetableOscillator({}, {}), banks({20, 25, 30, 35, 40, 45, 50, 56, 63, 70, 79, 88, 99, 111, 125,
-                                          140, 157, 176, 198, 222, 249, 279, 313, 352, 395, 443, 497, 558,
-                                          627, 704, 790, 886, 992, 1111, 1244, 1393, 1560, 1747, 1955, 2187,
-                                          2450, 2740, 3070, 3440, 3860, 4330, 4860, 5450, 6120, 6870, 7720,
-                                          8680, 9760, 10960, 12320, 13840, 15530, 17440, 19550, 20000})
+    : banks({20, 25, 30, 35, 40, 45, 50, 56, 63, 70, 79, 88, 99, 111, 125,
+             140, 157, 176, 198, 222, 249, 279, 313, 352, 395, 443, 497, 558,
+             627, 704, 790, 886, 992, 1111, 1244, 1393, 1560, 1747, 1955, 2187,
+             2450, 2740, 3070, 3440, 3860, 4330, 4860, 5450, 6120, 6870, 7720,
+             8680, 9760, 10960, 12320, 13840, 15530, 17440, 19550, 20000})
 {
     name = "Triangle";
-    generateWavetableBanks(sampleRate, velocity);
+    generateWavetableBanks(sampleRate);
+    setSource(this, 0.25, 0.75, velocity);
 }
 
 /**
- * @brief Builds a series of band-limited triangle waveforms.
+ * @brief Builds the integrated band-limited saw for every bank.
  * @param fs Sampling rate in Hz.
- * @param velocity Amplitude scaling factor.
  *
- * Each waveform is constructed using a truncated Fourier series containing
- * only odd harmonics, following:
+ * Same harmonic count per bank as Saw::generateWavetableBanks(), with
+ * amplitude 1/k² and cosine phase:
  *
  * \f[
- * x(t) = \sum_{n=0}^{N} (-1)^n \frac{1}{(2n+1)^2} \sin(2 \pi (2n+1) t)
+ * I(t) = -\sum_{k=1}^{N} \frac{1}{k^2} \cos(2 \pi k t)
  * \f]
- *
- * The number of harmonics is limited by both a fixed maximum and the
- * Nyquist constraint. After generation, each waveform is normalized to
- * unity and scaled by the velocity factor.
  */
-void Triangle::generateWavetableBanks(double fs, float velocity)
+void Triangle::generateWavetableBanks(double fs)
 {
-    waveTables.clear();
-    waveTables.reserve(banks.size());
+    TEC_TRACE_SCOPE("Triangle::generateWavetableBanks");
+
+    std::vector<std::vector<float>> tables;
+    tables.reserve(banks.size());
 
     const int desiredNumberOfHarmonics = 128;
     double fNyquist = fs / 2.0;
@@ -54,24 +52,25 @@ void Triangle::generateWavetableBanks(double fs, float velocity)
         int maxHarmonics = static_cast<int>(0.9 * fNyquist / bankFreq);
         numHarmonics = std::min(numHarmonics, maxHarmonics);
 
-        // odd harmonics with alternating sign and 1/n^2 amplitude
-        for (int n = 0; n < numHarmonics; ++n)
+        // All harmonics, 1/k^2, cosine phase (integral of the saw series)
+        for (int k = 1; k <= numHarmonics; ++k)
         {
-            int k = 2 * n + 1;
-            float amplitude = std::pow(-1.0f, n) / (k * k);
+            float amplitude = -1.0f / float(k * k);
             for (int i = 0; i < Ns; ++i)
-                waveform[i] += amplitude * std::sin(2.0 * M_PI * k * i / Ns);
+                waveform[i] += amplitude * std::cos(2.0 * M_PI * k * i / Ns);
         }
 
         // normalize
         float maxVal = *std::max_element(waveform.begin(), waveform.end(),
                                          [](float a, float b)
                                          { return std::abs(a) < std::abs(b); });
-        for (auto &v : waveform)
-            v = velocity * v / maxVal;
+        if (maxVal != 0.0f)
+            for (auto &v : waveform)
+                v = v / std::abs(maxVal);
 
-        waveTables.push_back(waveform);
+        tables.push_back(waveform);
     }
 
+    setTables(std::move(tables));
     bankFreqs = banks;
 }
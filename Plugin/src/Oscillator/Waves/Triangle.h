@@ -3,40 +3,37 @@
 
 /**
  * @class Triangle
- * @brief Implements a band-limited triangle wave oscillator using wavetable synthesis.
+ * @brief Band-limited triangle oscillator read from integrated-saw banks.
  *
- * The Triangle class generates multiple precomputed wavetable banks containing
- * single-cycle, band-limited triangle waveforms. Each bank corresponds to a
- * different base frequency range and restricts its harmonic content to avoid
- * aliasing above the Nyquist frequency.
+ * The banks hold the integral of the band-limited saw (harmonics
+ * -cos(2πkφ)/k², same bank centers and harmonic limits as Saw). Reading one
+ * table a quarter cycle either side of the phase and subtracting cancels
+ * the even harmonics and leaves a triangle with odd harmonics of alternating
+ * sign and 1/k² amplitude:
  *
- * The class extends WavetableOscillator, which handles phase accumulation,
- * table interpolation, and signal output.
+ * \f[
+ * I(\phi + \tfrac{1}{4}) - I(\phi - \tfrac{1}{4}) = 2 \sum_{k\ odd} (-1)^{(k-1)/2} \frac{\sin(2\pi k \phi)}{k^2}
+ * \f]
  */
-class Triangle : public WavetableOscillator
+class Triangle : public PhaseDifferenceOscillator
 {
 public:
     /**
-     * @brief Constructs a triangle oscillator and generates its wavetable banks.
+     * @brief Constructs a triangle oscillator and generates its integrated-saw banks.
      * @param sampleRate Sampling rate in Hz.
      * @param velocity Output amplitude scaling factor (default = 1.0f).
-     *
-     * Initializes the frequency bank centers and builds the triangle waveforms
-     * by summing odd harmonics with amplitude and sign decay.
      */
     Triangle(double sampleRate, float velocity = 1.0f);
 
 private:
     /**
-     * @brief Generates the band-limited triangle wavetable banks.
+     * @brief Generates the integrated-saw banks.
      * @param fs Sampling rate in Hz.
-     * @param velocity Amplitude scaling factor.
      *
-     * Each wavetable is computed as a Fourier series with odd harmonics whose
-     * amplitudes decay as 1/n² and alternate in sign. The number of harmonics
-     * included depends on the bank’s fundamental frequency to maintain band-limiting.
+     * Each table is normalized to unity peak; the output level is set by
+     * the per-bank gains of PhaseDifferenceOscillator.
      */
-    void generateWavetableBanks(double fs, float velocity);
+    void generateWavetableBanks(double fs);
 
     /** @brief Center frequencies (in Hz) defining each wavetable bank. */
     std::vector<double> banks;
@@ -0,0 +1,92 @@
+#include "WavetableSet.h"
+#include "Waves/Sine.h"
+#include "Waves/Saw.h"
+#include "Waves/Square.h"
+#include "Waves/Triangle.h"
+
+WavetableSet::WavetableSet(double fs)
+    : sampleRate(fs)
+{
+}
+
+/**
+ * @brief Builds the prototype of a waveform if it does not exist yet.
+ *
+ * Tables are converted to WavetableOscillator::defaultTableFormat before
+ * the prototype is stored, so no copy ever holds the float banks. Square
+ * reads the Saw prototype's banks and generates nothing.
+ */
+const WavetableOscillator &WavetableSet::getPrototype(int waveIndex)
+{
+    constexpr int sawIndex = 1;
+    auto &prototype = prototypes[size_t(waveIndex)];
+    if (prototype)
+        return *prototype;
+
+    std::shared_ptr<WavetableOscillator> osc;
+    switch (waveIndex)
+    {
+    case 0:
+        osc = std::make_shared<Sine>(sampleRate, 1.0f);
+        break;
+    case 1:
+        osc = std::make_shared<Saw>(sampleRate, 1.0f);
+        break;
+    case 2:
+        getPrototype(sawIndex);
+        osc = std::make_shared<Square>(std::static_pointer_cast<const Saw>(prototypes[sawIndex]), 1.0f);
+        break;
+    default:
+        osc = std::make_shared<Triangle>(sampleRate, 1.0f);
+        break;
+    }
+
+    osc->setTableFormat(WavetableOscillator::defaultTableFormat);
+    prototype = std::move(osc);
+    readyPrototypes[size_t(waveIndex)].store(prototype.get(), std::memory_order_release);
+    return *prototype;
+}
+
+/** @brief Copies the prototype; the copy shares its banks (and, for Square, the Saw). */
+std::shared_ptr<WavetableOscillator> WavetableSet::createOscillator(int waveIndex)
+{
+    if (waveIndex < 0 || waveIndex >= numWaveTypes)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto &prototype = getPrototype(waveIndex);
+
+    switch (waveIndex)
+    {
+    case 0:
+        return std::make_shared<Sine>(static_cast<const Sine &>(prototype));
+    case 1:
+        return std::make_shared<Saw>(static_cast<const Saw &>(prototype));
+    case 2:
+        return std::make_shared<Square>(static_cast<const Square &>(prototype));
+    default:
+        return std::make_shared<Triangle>(static_cast<const Triangle &>(prototype));
+    }
+}
+
+bool WavetableSet::isBuilt(int waveIndex) const
+{
+    if (waveIndex < 0 || waveIndex >= numWaveTypes)
+        return false;
+
+    return readyPrototypes[size_t(waveIndex)].load(std::memory_order_acquire) != nullptr;
+}
+
+/** @brief Bytes per bank of a built waveform, counted once for all the voices sharing it; never blocks. */
+std::vector<size_t> WavetableSet::getBankBytes(int waveIndex, std::string &name) const
+{
+    if (waveIndex < 0 || waveIndex >= numWaveTypes)
+        return {};
+
+    const auto *prototype = readyPrototypes[size_t(waveIndex)].load(std::memory_order_acquire);
+    if (prototype == nullptr)
+        return {};
+
+    name = prototype->getName();
+    return prototype->getBankBytes();
+}
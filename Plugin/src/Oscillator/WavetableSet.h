@@ -0,0 +1,64 @@
+#pragma once
+#include "Oscillator.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class WavetableSet
+ * @brief The wavetable banks of every waveform at one sample rate, built once and shared.
+ *
+ * The processor owns one set and hands it to all its voices, so the banks
+ * exist once per plugin instance instead of once per voice, and every voice
+ * reads the same (cache-resident) tables. Each waveform is built on first
+ * request as an immutable prototype; voices get copies of it that carry
+ * their own phase and frequency and share the prototype's banks.
+ *
+ * The sample rate is fixed at construction: a new rate means a new set.
+ * Building generates tables, so it never runs on the audio thread.
+ */
+class WavetableSet
+{
+public:
+    /** @brief Number of waveforms (same indices as OscillatorWrapper::setWaveType()). */
+    static constexpr int numWaveTypes = 4;
+
+    /** @brief Empty set for a sample rate; nothing is generated yet. */
+    explicit WavetableSet(double sampleRate);
+
+    /** @brief Sample rate the banks are built for. */
+    double getSampleRate() const { return sampleRate; }
+
+    /**
+     * @brief New oscillator for a waveform, reading the shared banks.
+     * @param waveIndex 0 = Sine, 1 = Saw, 2 = Square, 3 = Triangle.
+     * @return A fresh copy of the prototype (nullptr for an invalid index).
+     *
+     * Builds the prototype first if needed (Square builds the Saw it reads).
+     * Safe to call from several threads; never from the audio thread.
+     */
+    std::shared_ptr<WavetableOscillator> createOscillator(int waveIndex);
+
+    /** @brief True if the waveform's banks have been built. */
+    bool isBuilt(int waveIndex) const;
+
+    /**
+     * @brief Bytes of each wavetable bank of a waveform (memory accounting).
+     * @param waveIndex Index of the waveform.
+     * @param name Receives the oscillator's name.
+     * @return One entry per bank; empty if the waveform is not built or has no tables of its own.
+     */
+    std::vector<size_t> getBankBytes(int waveIndex, std::string &name) const;
+
+private:
+    /** @brief Builds a prototype and converts it to the default table format (mutex held). */
+    const WavetableOscillator &getPrototype(int waveIndex);
+
+    const double sampleRate;                                                              /**< Sample rate of every bank in the set. */
+    std::mutex mutex;                                                                     /**< Serializes building. */
+    std::array<std::shared_ptr<const WavetableOscillator>, numWaveTypes> prototypes;      /**< Built on demand, never modified. */
+    std::array<std::atomic<const WavetableOscillator *>, numWaveTypes> readyPrototypes{}; /**< Built prototypes, readable without the mutex. */
+};
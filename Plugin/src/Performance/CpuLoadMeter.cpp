@@ -0,0 +1,105 @@
+#include "CpuLoadMeter.h"
+#include <algorithm>
+#include <cmath>
+
+CpuLoadMeter::CpuLoadMeter()
+{
+    clearStatistics();
+    prepare(44100.0);
+}
+
+void CpuLoadMeter::prepare(double sampleRate)
+{
+    const double ticksPerSecond = double(juce::Time::getHighResolutionTicksPerSecond());
+    ticksPerSample.store(ticksPerSecond / sampleRate, std::memory_order_relaxed);
+    clearStatistics();
+}
+
+void CpuLoadMeter::reset() noexcept
+{
+    resetRequested.store(true, std::memory_order_release);
+}
+
+void CpuLoadMeter::clearStatistics() noexcept
+{
+    for (auto &bin : histogram)
+        bin.store(0, std::memory_order_relaxed);
+
+    lastLoad.store(0.0f, std::memory_order_relaxed);
+    peakLoad.store(0.0f, std::memory_order_relaxed);
+    loadSum.store(0.0, std::memory_order_relaxed);
+    numXruns.store(0, std::memory_order_relaxed);
+    numBlocks.store(0, std::memory_order_release);
+}
+
+void CpuLoadMeter::addMeasurement(juce::int64 elapsedTicks, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    if (resetRequested.exchange(false, std::memory_order_acquire))
+        clearStatistics();
+
+    const double budgetTicks = ticksPerSample.load(std::memory_order_relaxed) * numSamples;
+    const float load = float(double(elapsedTicks) / budgetTicks);
+
+    // Single writer: plain load/store is enough for the running values
+    lastLoad.store(load, std::memory_order_relaxed);
+    if (load > peakLoad.load(std::memory_order_relaxed))
+        peakLoad.store(load, std::memory_order_relaxed);
+
+    loadSum.store(loadSum.load(std::memory_order_relaxed) + load, std::memory_order_relaxed);
+
+    if (load >= 1.0f)
+        numXruns.fetch_add(1, std::memory_order_relaxed);
+
+    const int bin = std::min(numBins - 1, int(load * binsPerUnitLoad));
+    histogram[size_t(bin)].fetch_add(1, std::memory_order_relaxed);
+
+    numBlocks.fetch_add(1, std::memory_order_release);
+}
+
+CpuLoadMeter::Snapshot CpuLoadMeter::getSnapshot() const noexcept
+{
+    Snapshot s;
+    s.numBlocks = numBlocks.load(std::memory_order_acquire);
+    s.numXruns = numXruns.load(std::memory_order_relaxed);
+    s.lastLoad = lastLoad.load(std::memory_order_relaxed);
+    s.peakLoad = peakLoad.load(std::memory_order_relaxed);
+
+    if (s.numBlocks == 0)
+        return s;
+
+    s.averageLoad = float(loadSum.load(std::memory_order_relaxed) / double(s.numBlocks));
+
+    // The histogram is read while the audio thread may still be adding to it,
+    // so percentiles are computed against the bins' own total.
+    std::array<uint32_t, numBins> counts;
+    uint64_t total = 0;
+    for (int i = 0; i < numBins; ++i)
+    {
+        counts[size_t(i)] = histogram[size_t(i)].load(std::memory_order_relaxed);
+        total += counts[size_t(i)];
+    }
+
+    if (total == 0)
+        return s;
+
+    auto percentile = [&](double fraction)
+    {
+        const uint64_t target = uint64_t(std::ceil(fraction * double(total)));
+        uint64_t cumulative = 0;
+        for (int i = 0; i < numBins; ++i)
+        {
+            cumulative += counts[size_t(i)];
+            if (cumulative >= target)
+                return float(i + 1) / float(binsPerUnitLoad); // upper edge of the bin
+        }
+        return float(numBins) / float(binsPerUnitLoad);
+    };
+
+    // A bin's upper edge can overshoot the real maximum; clamp to the peak
+    s.p50Load = std::min(percentile(0.50), s.peakLoad);
+    s.p99Load = std::min(percentile(0.99), s.peakLoad);
+    return s;
+}
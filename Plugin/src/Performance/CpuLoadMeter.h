@@ -0,0 +1,122 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class CpuLoadMeter
+ * @brief Measures how much of its real-time budget every processBlock call uses.
+ *
+ * The budget of a block is `numSamples / sampleRate` seconds. Each call is timed
+ * with the high-resolution tick counter and the resulting load ratio
+ * (elapsed / budget) is accumulated into a histogram of atomic counters.
+ *
+ * The audio thread is the only writer; any other thread (GUI timer, host
+ * scripting, offline tools) may read a Snapshot at any time. No locks and no
+ * allocations are involved on either side.
+ *
+ * A block whose load reaches 1.0 is counted as an xrun: it took longer than
+ * the audio it produced, so the host would have underrun had it been alone.
+ */
+class CpuLoadMeter
+{
+public:
+    /** @brief Histogram resolution: one bin per percent of the block budget. */
+    static constexpr int binsPerUnitLoad = 100;
+
+    /** @brief Number of bins. Loads of 200% or more land in the last bin. */
+    static constexpr int numBins = 2 * binsPerUnitLoad + 1;
+
+    /**
+     * @brief Statistics read from the meter at a given moment.
+     *
+     * All load values are ratios of the block budget (1.0 = 100%).
+     */
+    struct Snapshot
+    {
+        float lastLoad = 0.0f;    ///< Load of the most recent block.
+        float averageLoad = 0.0f; ///< Mean load since the last reset.
+        float peakLoad = 0.0f;    ///< Highest load since the last reset.
+        float p50Load = 0.0f;     ///< Median load (histogram resolution).
+        float p99Load = 0.0f;     ///< 99th percentile load (histogram resolution).
+        uint64_t numBlocks = 0;   ///< Blocks measured since the last reset.
+        uint64_t numXruns = 0;    ///< Blocks whose load reached 1.0.
+    };
+
+    /**
+     * @brief RAII helper timing one processBlock call.
+     *
+     * Construct at the top of processBlock, let it go out of scope at the end.
+     */
+    class ScopedMeasurement
+    {
+    public:
+        ScopedMeasurement(CpuLoadMeter &meterToUse, int numSamplesInBlock) noexcept
+            : meter(meterToUse),
+              numSamples(numSamplesInBlock),
+              startTicks(juce::Time::getHighResolutionTicks())
+        {
+        }
+
+        ~ScopedMeasurement()
+        {
+            meter.addMeasurement(juce::Time::getHighResolutionTicks() - startTicks, numSamples);
+        }
+
+    private:
+        CpuLoadMeter &meter;
+        int numSamples;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedMeasurement)
+    };
+
+    CpuLoadMeter();
+
+    /**
+     * @brief Sets the sample rate used to compute block budgets.
+     * @param sampleRate Host sample rate in Hz.
+     *
+     * Also clears all collected statistics. Call from prepareToPlay.
+     */
+    void prepare(double sampleRate);
+
+    /**
+     * @brief Records one block. Audio thread only.
+     * @param elapsedTicks Duration of the block in high-resolution ticks.
+     * @param numSamples Number of samples rendered in the block.
+     */
+    void addMeasurement(juce::int64 elapsedTicks, int numSamples) noexcept;
+
+    /**
+     * @brief Asks the audio thread to clear the statistics before its next block.
+     *
+     * Safe to call from any thread.
+     */
+    void reset() noexcept;
+
+    /** @brief Returns the current statistics. Safe to call from any thread. */
+    Snapshot getSnapshot() const noexcept;
+
+    /**
+     * @brief Returns the load ratio of the most recent block.
+     *
+     * Cheap accessor intended for code that reacts to load block by block.
+     */
+    float getLastLoad() const noexcept { return lastLoad.load(std::memory_order_relaxed); }
+
+private:
+    void clearStatistics() noexcept;
+
+    std::atomic<double> ticksPerSample{0.0}; ///< High-resolution ticks available per sample.
+
+    std::array<std::atomic<uint32_t>, numBins> histogram; ///< Load histogram (1% bins).
+    std::atomic<float> lastLoad{0.0f};
+    std::atomic<float> peakLoad{0.0f};
+    std::atomic<double> loadSum{0.0};
+    std::atomic<uint64_t> numBlocks{0};
+    std::atomic<uint64_t> numXruns{0};
+
+    std::atomic<bool> resetRequested{false};
+};
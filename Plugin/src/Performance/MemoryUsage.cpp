@@ -0,0 +1,86 @@
+#include "MemoryUsage.h"
+#include <algorithm>
+
+void MemoryUsage::addWave(const juce::String &name, const std::vector<size_t> &bytesPerBank)
+{
+    if (bytesPerBank.empty())
+        return;
+
+    auto it = std::find_if(waves.begin(), waves.end(), [&name](const Wave &w)
+                           { return w.name == name; });
+    if (it == waves.end())
+    {
+        waves.push_back({name, {}, 0, 0});
+        it = waves.end() - 1;
+    }
+
+    if (it->bankBytes.size() < bytesPerBank.size())
+        it->bankBytes.resize(bytesPerBank.size(), 0);
+
+    for (size_t b = 0; b < bytesPerBank.size(); ++b)
+    {
+        it->bankBytes[b] += bytesPerBank[b];
+        it->totalBytes += bytesPerBank[b];
+    }
+    ++it->numCopies;
+}
+
+void MemoryUsage::updateTotals()
+{
+    wavetableBytes = 0;
+    for (const auto &w : waves)
+        wavetableBytes += w.totalBytes;
+
+    totalBytes = wavetableBytes + getFilterBankBytes() + voiceBytes + scratchBytes +
+                 tuningBytes + userWavetableBytes + processorBytes;
+    peakTotalBytes = std::max(peakTotalBytes, totalBytes);
+}
+
+juce::String MemoryUsage::formatBytes(size_t bytes)
+{
+    if (bytes < 1024)
+        return juce::String((juce::int64)bytes) + " B";
+    if (bytes < 1024 * 1024)
+        return juce::String(double(bytes) / 1024.0, 1) + " KB";
+    return juce::String(double(bytes) / (1024.0 * 1024.0), 2) + " MB";
+}
+
+juce::String MemoryUsage::toSummaryString() const
+{
+    return "Memory " + formatBytes(totalBytes) +
+           "  peak " + formatBytes(peakTotalBytes) +
+           "  tables " + formatBytes(wavetableBytes) +
+           "  filter banks " + formatBytes(getFilterBankBytes()) +
+           "  voices " + formatBytes(voiceBytes) +
+           "  scratch " + formatBytes(scratchBytes) +
+           "  tuning " + formatBytes(tuningBytes) +
+           (mappedWavetableBytes > 0 ? "  mapped " + formatBytes(mappedWavetableBytes) : juce::String());
+}
+
+juce::String MemoryUsage::toDetailedString() const
+{
+    juce::String s;
+    s << "total            " << formatBytes(totalBytes) << " (peak " << formatBytes(peakTotalBytes) << ")\n";
+    s << "  wavetables     " << formatBytes(wavetableBytes) << "\n";
+
+    for (const auto &w : waves)
+    {
+        s << "    " << w.name.paddedRight(' ', 10) << " " << formatBytes(w.totalBytes)
+          << " in " << w.numCopies << " cop" << (w.numCopies == 1 ? "y" : "ies")
+          << ", " << (int)w.bankBytes.size() << " banks:";
+        for (size_t b = 0; b < w.bankBytes.size(); ++b)
+            s << (b % 10 == 0 ? "\n      " : " ") << formatBytes(w.bankBytes[b]);
+        s << "\n";
+    }
+
+    s << "  filter banks   " << formatBytes(getFilterBankBytes())
+      << " (lp " << formatBytes(lowpassBankBytes) << ", hp " << formatBytes(highpassBankBytes)
+      << ", bp " << formatBytes(bandpassBankBytes) << ")\n";
+    s << "  voices         " << formatBytes(voiceBytes) << "\n";
+    s << "  scratch        " << formatBytes(scratchBytes) << "\n";
+    s << "  tuning         " << formatBytes(tuningBytes) << "\n";
+    s << "  user wavetable " << formatBytes(userWavetableBytes) << "\n";
+    s << "  processor      " << formatBytes(processorBytes) << "\n";
+    s << "mapped (shared)  " << formatBytes(mappedWavetableBytes) << "\n";
+    return s;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct MemoryUsage
+ * @brief Bytes held by one plugin instance, broken down by subsystem.
+ *
+ * Filled by AudioPluginAudioProcessor::getMemoryUsage(), which walks the
+ * voices and asks each component for the heap and inline memory it owns.
+ * Wavetables are broken down per waveform and per bank and summed over every
+ * set that holds them; the voices share one WavetableSet, so numCopies is 1
+ * in the plugin and compacting tables shows up directly in these numbers.
+ *
+ * Counts are the bytes of the data (capacity for vectors), not allocator
+ * overhead, so they are comparable across platforms.
+ */
+struct MemoryUsage
+{
+    /** @brief Tables of one waveform, summed over every set that built them. */
+    struct Wave
+    {
+        juce::String name;
+        std::vector<size_t> bankBytes; ///< Per bank, all copies.
+        size_t totalBytes = 0;
+        int numCopies = 0; ///< Sets holding this waveform's tables.
+    };
+
+    std::vector<Wave> waves;
+
+    size_t wavetableBytes = 0;     ///< All waves, all banks, all copies.
+    size_t lowpassBankBytes = 0;   ///< RCFilter lpBank, all voices.
+    size_t highpassBankBytes = 0;  ///< RCFilter hpBank, all voices.
+    size_t bandpassBankBytes = 0;  ///< RCFilter bpBank, all voices.
+    size_t voiceBytes = 0;         ///< Voice objects, without their scratch buffers.
+    size_t scratchBytes = 0;       ///< Render chunks and the scope FIFO.
+    size_t tuningBytes = 0;        ///< Published tuning tables.
+    size_t userWavetableBytes = 0; ///< Imported wavetable kept on the heap (cache unavailable).
+    size_t processorBytes = 0;     ///< The processor object itself.
+
+    size_t totalBytes = 0;     ///< Sum of the above.
+    size_t peakTotalBytes = 0; ///< Highest total seen by this instance.
+
+    /**
+     * @brief Imported wavetable mapped from its cache file; not in totalBytes.
+     *
+     * The OS pages it in on demand and shares it between instances that map
+     * the same file, so it is not memory this instance owns.
+     */
+    size_t mappedWavetableBytes = 0;
+
+    /** @brief Adds one set's copy of a waveform (no-op if not built). */
+    void addWave(const juce::String &name, const std::vector<size_t> &bytesPerBank);
+
+    /** @brief Sum of the three filter banks. */
+    size_t getFilterBankBytes() const { return lowpassBankBytes + highpassBankBytes + bandpassBankBytes; }
+
+    /** @brief Computes wavetableBytes and totalBytes from the other fields. */
+    void updateTotals();
+
+    /** @brief One line: total, peak and the main subsystems. */
+    juce::String toSummaryString() const;
+
+    /** @brief Multi-line report including every waveform and bank (for the CLI tools). */
+    juce::String toDetailedString() const;
+
+    /** @brief "12.3 KB" style formatting. */
+    static juce::String formatBytes(size_t bytes);
+};
@@ -0,0 +1,124 @@
+#include "QualityGovernor.h"
+
+QualityGovernor::QualityGovernor()
+{
+    setConfig(Config{});
+}
+
+const std::array<QualityGovernor::Level, QualityGovernor::numLevels> &QualityGovernor::getLevels()
+{
+    static const std::array<Level, numLevels> levels{{
+        {"Full", 128, false, true},
+        {"Reduced", 6, true, true},
+        {"Low", 4, true, false},
+        {"Minimal", 2, true, false},
+    }};
+    return levels;
+}
+
+void QualityGovernor::setConfig(const Config &c)
+{
+    downshiftLoad.store(c.downshiftLoad);
+    upshiftLoad.store(juce::jmin(c.upshiftLoad, c.downshiftLoad));
+    downshiftHoldBlocks.store(juce::jmax(1, c.downshiftHoldBlocks));
+    upshiftHoldBlocks.store(juce::jmax(1, c.upshiftHoldBlocks));
+    smoothing.store(juce::jlimit(0.001f, 1.0f, c.smoothing));
+    maxLevel.store(juce::jlimit(0, numLevels - 1, c.maxLevel));
+}
+
+QualityGovernor::Config QualityGovernor::getConfig() const
+{
+    Config c;
+    c.downshiftLoad = downshiftLoad.load();
+    c.upshiftLoad = upshiftLoad.load();
+    c.downshiftHoldBlocks = downshiftHoldBlocks.load();
+    c.upshiftHoldBlocks = upshiftHoldBlocks.load();
+    c.smoothing = smoothing.load();
+    c.maxLevel = maxLevel.load();
+    return c;
+}
+
+void QualityGovernor::setEnabled(bool shouldBeEnabled) noexcept
+{
+    enabled.store(shouldBeEnabled, std::memory_order_relaxed);
+}
+
+void QualityGovernor::reset() noexcept
+{
+    smoothed = 0.0f;
+    blocksAbove = 0;
+    blocksBelow = 0;
+    level.store(0);
+    publishedLoad.store(0.0f);
+    numDownshifts.store(0);
+    numUpshifts.store(0);
+    blocksDegraded.store(0);
+}
+
+const QualityGovernor::Level &QualityGovernor::update(float blockLoad) noexcept
+{
+    const auto &levels = getLevels();
+
+    smoothed += smoothing.load(std::memory_order_relaxed) * (blockLoad - smoothed);
+    publishedLoad.store(smoothed, std::memory_order_relaxed);
+
+    int current = level.load(std::memory_order_relaxed);
+
+    if (!enabled.load(std::memory_order_relaxed))
+    {
+        blocksAbove = blocksBelow = 0;
+        if (current != 0)
+            level.store(0, std::memory_order_relaxed);
+        return levels[0];
+    }
+
+    const int lowest = maxLevel.load(std::memory_order_relaxed);
+
+    if (smoothed > downshiftLoad.load(std::memory_order_relaxed))
+    {
+        blocksBelow = 0;
+        if (++blocksAbove >= downshiftHoldBlocks.load(std::memory_order_relaxed) && current < lowest)
+        {
+            ++current;
+            blocksAbove = 0;
+            numDownshifts.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    else if (smoothed < upshiftLoad.load(std::memory_order_relaxed))
+    {
+        blocksAbove = 0;
+        if (++blocksBelow >= upshiftHoldBlocks.load(std::memory_order_relaxed) && current > 0)
+        {
+            --current;
+            blocksBelow = 0;
+            numUpshifts.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    else
+    {
+        // Inside the hysteresis band: hold the current level
+        blocksAbove = blocksBelow = 0;
+    }
+
+    // The configured floor may have been raised while degraded
+    current = juce::jmin(current, lowest);
+
+    level.store(current, std::memory_order_relaxed);
+    if (current > 0)
+        blocksDegraded.fetch_add(1, std::memory_order_relaxed);
+
+    return levels[size_t(current)];
+}
+
+QualityGovernor::Status QualityGovernor::getStatus() const noexcept
+{
+    Status s;
+    s.enabled = enabled.load(std::memory_order_relaxed);
+    s.level = level.load(std::memory_order_relaxed);
+    s.levelName = getLevels()[size_t(s.level)].name;
+    s.smoothedLoad = publishedLoad.load(std::memory_order_relaxed);
+    s.numDownshifts = numDownshifts.load(std::memory_order_relaxed);
+    s.numUpshifts = numUpshifts.load(std::memory_order_relaxed);
+    s.blocksDegraded = blocksDegraded.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class QualityGovernor
+ * @brief Steps engine cost down when processBlock runs out of headroom, and back up when it recovers.
+ *
+ * The governor is fed once per block with the load ratio measured by
+ * CpuLoadMeter (elapsed / real-time budget). It keeps a smoothed load and moves
+ * through a fixed list of quality levels:
+ *
+ * | Level   | Max voices | Release culling | Table interpolation |
+ * |---------|------------|-----------------|---------------------|
+ * | Full    | all        | no              | linear              |
+ * | Reduced | 6          | yes             | linear              |
+ * | Low     | 4          | yes             | drop-sample         |
+ * | Minimal | 2          | yes             | drop-sample         |
+ *
+ * Hysteresis: it steps down only after the smoothed load stays above
+ * Config::downshiftLoad for Config::downshiftHoldBlocks blocks in a row, and
+ * steps up only after it stays below Config::upshiftLoad for
+ * Config::upshiftHoldBlocks blocks in a row. Each step moves a single level.
+ *
+ * update() runs on the audio thread; configuration and status calls may come
+ * from any thread. Everything shared is atomic.
+ */
+class QualityGovernor
+{
+public:
+    /** @brief Engine settings applied at one quality level. */
+    struct Level
+    {
+        const char *name;         ///< Name shown in the GUI.
+        int maxVoices;            ///< Polyphony cap for new notes (clamped to the voice count).
+        bool cullReleasingVoices; ///< Fade voices in release out quickly.
+        bool linearInterpolation; ///< False = drop-sample wavetable reads.
+    };
+
+    static constexpr int numLevels = 4;
+
+    /** @brief Tunable thresholds. Loads are ratios of the block budget. */
+    struct Config
+    {
+        float downshiftLoad = 0.85f;  ///< Smoothed load above which cost is reduced.
+        float upshiftLoad = 0.50f;    ///< Smoothed load below which cost is restored.
+        int downshiftHoldBlocks = 8;  ///< Consecutive blocks above downshiftLoad before stepping down.
+        int upshiftHoldBlocks = 400;  ///< Consecutive blocks below upshiftLoad before stepping up.
+        float smoothing = 0.2f;       ///< One-pole smoothing coefficient for the block load (0–1].
+        int maxLevel = numLevels - 1; ///< Lowest quality the governor may reach.
+    };
+
+    /** @brief Governor state, for display and logging. */
+    struct Status
+    {
+        bool enabled = true;
+        int level = 0;                  ///< Current level index (0 = Full).
+        const char *levelName = "";     ///< Name of the current level.
+        float smoothedLoad = 0.0f;      ///< Load the decisions are based on.
+        uint32_t numDownshifts = 0;     ///< Steps down since the last reset.
+        uint32_t numUpshifts = 0;       ///< Steps up since the last reset.
+        uint64_t blocksDegraded = 0;    ///< Blocks processed below Full quality.
+    };
+
+    QualityGovernor();
+
+    /** @brief Returns the table of quality levels, best first. */
+    static const std::array<Level, numLevels> &getLevels();
+
+    /** @brief Replaces the thresholds. Safe to call while processing. */
+    void setConfig(const Config &newConfig);
+
+    /** @brief Returns the thresholds currently in use. */
+    Config getConfig() const;
+
+    /**
+     * @brief Enables or disables the governor.
+     *
+     * When disabled, update() always returns the Full level.
+     */
+    void setEnabled(bool shouldBeEnabled) noexcept;
+
+    /** @brief Returns to Full quality and clears the counters. Call from prepareToPlay. */
+    void reset() noexcept;
+
+    /**
+     * @brief Feeds one block's load and returns the level to render the next block with.
+     * @param blockLoad Load ratio of the last processed block.
+     *
+     * Audio thread only.
+     */
+    const Level &update(float blockLoad) noexcept;
+
+    /** @brief Returns the current state. Safe to call from any thread. */
+    Status getStatus() const noexcept;
+
+private:
+    std::atomic<float> downshiftLoad;
+    std::atomic<float> upshiftLoad;
+    std::atomic<int> downshiftHoldBlocks;
+    std::atomic<int> upshiftHoldBlocks;
+    std::atomic<float> smoothing;
+    std::atomic<int> maxLevel;
+    std::atomic<bool> enabled{true};
+
+    // Audio-thread state
+    float smoothed = 0.0f;
+    int blocksAbove = 0;
+    int blocksBelow = 0;
+
+    // Published state
+    std::atomic<int> level{0};
+    std::atomic<float> publishedLoad{0.0f};
+    std::atomic<uint32_t> numDownshifts{0};
+    std::atomic<uint32_t> numUpshifts{0};
+    std::atomic<uint64_t> blocksDegraded{0};
+};
@@ -0,0 +1,158 @@
+#include "Trace.h"
+
+#if TEC_ENABLE_TRACING
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char *name = nullptr;
+        juce::int64 startTicks = 0;
+        juce::int64 endTicks = 0;
+    };
+
+    /**
+     * Single-producer ring owned by one thread. The reader copies a window of
+     * events and then drops any slot the writer may have overwritten meanwhile.
+     */
+    struct ThreadRing
+    {
+        static constexpr size_t capacity = 1 << 16; // power of two
+        static constexpr size_t mask = capacity - 1;
+
+        explicit ThreadRing(int index) : threadIndex(index), events(capacity) {}
+
+        void push(const TraceEvent &e) noexcept
+        {
+            const uint64_t w = writeIndex.load(std::memory_order_relaxed);
+            events[size_t(w & mask)] = e;
+            writeIndex.store(w + 1, std::memory_order_release);
+        }
+
+        int threadIndex;
+        std::vector<TraceEvent> events;
+        std::atomic<uint64_t> writeIndex{0};
+    };
+
+    constexpr int maxThreads = 64;
+
+    std::array<std::unique_ptr<ThreadRing>, maxThreads> ringStorage; // owned until exit
+    std::array<std::atomic<ThreadRing *>, maxThreads> rings{};       // published to readers
+    std::atomic<int> numRings{0};
+
+    ThreadRing *getRingForThisThread() noexcept
+    {
+        thread_local ThreadRing *ring = nullptr;
+        thread_local bool exhausted = false;
+
+        if (ring == nullptr && !exhausted)
+        {
+            const int index = numRings.fetch_add(1, std::memory_order_acq_rel);
+            if (index >= maxThreads)
+            {
+                exhausted = true;
+                return nullptr;
+            }
+
+            ringStorage[size_t(index)] = std::make_unique<ThreadRing>(index);
+            ring = ringStorage[size_t(index)].get();
+            rings[size_t(index)].store(ring, std::memory_order_release);
+        }
+        return ring;
+    }
+}
+
+void TraceRecorder::record(const char *name, juce::int64 startTicks, juce::int64 endTicks) noexcept
+{
+    if (auto *ring = getRingForThisThread())
+        ring->push({name, startTicks, endTicks});
+}
+
+juce::String TraceRecorder::toChromeJson()
+{
+    const double microsecondsPerTick = 1.0e6 / double(juce::Time::getHighResolutionTicksPerSecond());
+
+    juce::MemoryOutputStream out;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    const int count = juce::jmin(numRings.load(std::memory_order_acquire), maxThreads);
+
+    for (int r = 0; r < count; ++r)
+    {
+        auto *ring = rings[size_t(r)].load(std::memory_order_acquire);
+        if (ring == nullptr)
+            continue; // registered but not yet constructed
+
+        const uint64_t end = ring->writeIndex.load(std::memory_order_acquire);
+        const uint64_t begin = end > ThreadRing::capacity ? end - ThreadRing::capacity : 0;
+
+        std::vector<TraceEvent> copy;
+        copy.reserve(size_t(end - begin));
+        for (uint64_t i = begin; i < end; ++i)
+            copy.push_back(ring->events[size_t(i & ThreadRing::mask)]);
+
+        // Anything older than (newEnd - capacity) may have been overwritten while copying
+        const uint64_t newEnd = ring->writeIndex.load(std::memory_order_acquire);
+        const uint64_t firstValid = newEnd > ThreadRing::capacity ? newEnd - ThreadRing::capacity : 0;
+
+        out << (first ? "" : ",")
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->threadIndex
+            << ",\"args\":{\"name\":\"thread " << ring->threadIndex << "\"}}";
+        first = false;
+
+        for (uint64_t i = juce::jmax(begin, firstValid); i < end; ++i)
+        {
+            const auto &e = copy[size_t(i - begin)];
+            if (e.name == nullptr)
+                continue;
+
+            out << ",{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->threadIndex
+                << ",\"ts\":" << juce::String(double(e.startTicks) * microsecondsPerTick, 3)
+                << ",\"dur\":" << juce::String(double(e.endTicks - e.startTicks) * microsecondsPerTick, 3)
+                << "}";
+        }
+    }
+
+    out << "]}";
+    return out.toString();
+}
+
+bool TraceRecorder::writeChromeJson(const juce::File &file)
+{
+    return file.replaceWithText(toChromeJson());
+}
+
+void TraceRecorder::clear()
+{
+    const int count = juce::jmin(numRings.load(std::memory_order_acquire), maxThreads);
+    for (int r = 0; r < count; ++r)
+        if (auto *ring = rings[size_t(r)].load(std::memory_order_acquire))
+        {
+            std::fill(ring->events.begin(), ring->events.end(), TraceEvent{});
+            ring->writeIndex.store(0, std::memory_order_release);
+        }
+}
+
+#else
+
+void TraceRecorder::record(const char *, juce::int64, juce::int64) noexcept {}
+
+juce::String TraceRecorder::toChromeJson()
+{
+    return "{\"traceEvents\":[]}";
+}
+
+bool TraceRecorder::writeChromeJson(const juce::File &)
+{
+    return false;
+}
+
+void TraceRecorder::clear() {}
+
+#endif
@@ -0,0 +1,102 @@
+#pragma once
+#include <JuceHeader.h>
+
+/**
+ * @file Trace.h
+ * @brief Compile-time switchable scoped trace markers for the DSP hot path.
+ *
+ * Usage:
+ * @code
+ * void SynthVoice::renderNextBlock(...)
+ * {
+ *     TEC_TRACE_SCOPE("SynthVoice::renderNextBlock");
+ *     ...
+ * }
+ * @endcode
+ *
+ * With TEC_ENABLE_TRACING=0 (the default) TEC_TRACE_SCOPE expands to nothing,
+ * so release builds carry no timing calls, no thread-local lookups and no
+ * buffers. With TEC_ENABLE_TRACING=1 each scope records one complete event
+ * (name, start, end) into a lock-free ring buffer owned by the calling thread.
+ *
+ * The rings are dumped on demand by TraceRecorder::writeChromeJson() in the
+ * Chrome trace event format, which loads directly into chrome://tracing and
+ * https://ui.perfetto.dev.
+ */
+
+#ifndef TEC_ENABLE_TRACING
+#define TEC_ENABLE_TRACING 0
+#endif
+
+/**
+ * @class TraceRecorder
+ * @brief Collects trace events from every thread and exports them as JSON.
+ *
+ * Each thread that emits an event gets its own single-producer ring buffer
+ * the first time it records (a one-off allocation, only in tracing builds).
+ * Writers never block; when a ring is full the oldest events are overwritten.
+ */
+class TraceRecorder
+{
+public:
+    /** @brief True when the build was configured with TEC_ENABLE_TRACING=1. */
+    static constexpr bool isEnabled() { return TEC_ENABLE_TRACING != 0; }
+
+    /**
+     * @brief Records one complete event for the calling thread.
+     * @param name Static string naming the scope (must outlive the recorder).
+     * @param startTicks Start time in high-resolution ticks.
+     * @param endTicks End time in high-resolution ticks.
+     */
+    static void record(const char *name, juce::int64 startTicks, juce::int64 endTicks) noexcept;
+
+    /**
+     * @brief Serializes every buffered event in Chrome trace event JSON.
+     * @return JSON text, or an empty trace when tracing is compiled out.
+     */
+    static juce::String toChromeJson();
+
+    /**
+     * @brief Writes the buffered events to a .json file.
+     * @param file Destination file (overwritten).
+     * @return True on success; false if writing failed or tracing is compiled out.
+     */
+    static bool writeChromeJson(const juce::File &file);
+
+    /** @brief Discards all buffered events. Call while no thread is recording. */
+    static void clear();
+};
+
+#if TEC_ENABLE_TRACING
+
+/**
+ * @class TraceScope
+ * @brief RAII marker recording the lifetime of a scope as one trace event.
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *scopeName) noexcept
+        : name(scopeName), startTicks(juce::Time::getHighResolutionTicks())
+    {
+    }
+
+    ~TraceScope()
+    {
+        TraceRecorder::record(name, startTicks, juce::Time::getHighResolutionTicks());
+    }
+
+private:
+    const char *name;
+    juce::int64 startTicks;
+
+    JUCE_DECLARE_NON_COPYABLE(TraceScope)
+};
+
+#define TEC_TRACE_SCOPE(name) TraceScope JUCE_JOIN_MACRO(tecTraceScope_, __LINE__)(name)
+
+#else
+
+#define TEC_TRACE_SCOPE(name)
+
+#endif
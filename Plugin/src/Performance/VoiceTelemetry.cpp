@@ -0,0 +1,158 @@
+#include "VoiceTelemetry.h"
+
+namespace
+{
+    const char *const stageNames[VoiceTelemetry::numStages] = {"idle", "attack", "decay", "sustain", "release"};
+
+    juce::String formatMilliseconds(double samples, double sampleRate)
+    {
+        return juce::String(samples * 1000.0 / sampleRate, 2) + " ms";
+    }
+}
+
+VoiceTelemetry::VoiceTelemetry()
+{
+    clearStatistics();
+}
+
+void VoiceTelemetry::prepare(double engineSampleRate)
+{
+    sampleRate.store(engineSampleRate, std::memory_order_relaxed);
+    clearStatistics();
+}
+
+void VoiceTelemetry::reset() noexcept
+{
+    resetRequested.store(true, std::memory_order_release);
+}
+
+void VoiceTelemetry::clearStatistics() noexcept
+{
+    for (auto &samples : stageSamples)
+        samples.store(0, std::memory_order_relaxed);
+
+    activeVoices.store(0, std::memory_order_relaxed);
+    voicesInRelease.store(0, std::memory_order_relaxed);
+    peakPolyphony.store(0, std::memory_order_relaxed);
+    activeVoiceSum.store(0, std::memory_order_relaxed);
+    numNotes.store(0, std::memory_order_relaxed);
+    numSteals.store(0, std::memory_order_relaxed);
+    numOnsets.store(0, std::memory_order_relaxed);
+    onsetSampleSum.store(0, std::memory_order_relaxed);
+    maxOnsetSamples.store(0, std::memory_order_relaxed);
+    oldestVoiceSamples.store(0, std::memory_order_relaxed);
+    longestVoiceSamples.store(0, std::memory_order_relaxed);
+    numBlocks.store(0, std::memory_order_release);
+}
+
+void VoiceTelemetry::beginBlock() noexcept
+{
+    if (resetRequested.exchange(false, std::memory_order_acquire))
+        clearStatistics();
+}
+
+// Single writer: plain load/store is enough for every counter
+void VoiceTelemetry::addNote(bool stolen) noexcept
+{
+    numNotes.store(numNotes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (stolen)
+        numSteals.store(numSteals.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void VoiceTelemetry::addStageSamples(Envelope::Stage stage, int numSamples) noexcept
+{
+    auto &samples = stageSamples[size_t(stage)];
+    samples.store(samples.load(std::memory_order_relaxed) + uint64_t(numSamples), std::memory_order_relaxed);
+}
+
+void VoiceTelemetry::addOnset(int samplesFromNoteOn) noexcept
+{
+    onsetSampleSum.store(onsetSampleSum.load(std::memory_order_relaxed) + uint64_t(samplesFromNoteOn),
+                         std::memory_order_relaxed);
+    if (samplesFromNoteOn > maxOnsetSamples.load(std::memory_order_relaxed))
+        maxOnsetSamples.store(samplesFromNoteOn, std::memory_order_relaxed);
+    numOnsets.store(numOnsets.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void VoiceTelemetry::endBlock(int active, int inRelease, juce::int64 oldestSamples) noexcept
+{
+    activeVoices.store(active, std::memory_order_relaxed);
+    voicesInRelease.store(inRelease, std::memory_order_relaxed);
+    if (active > peakPolyphony.load(std::memory_order_relaxed))
+        peakPolyphony.store(active, std::memory_order_relaxed);
+    activeVoiceSum.store(activeVoiceSum.load(std::memory_order_relaxed) + uint64_t(active), std::memory_order_relaxed);
+
+    oldestVoiceSamples.store(oldestSamples, std::memory_order_relaxed);
+    if (oldestSamples > longestVoiceSamples.load(std::memory_order_relaxed))
+        longestVoiceSamples.store(oldestSamples, std::memory_order_relaxed);
+
+    numBlocks.fetch_add(1, std::memory_order_release);
+}
+
+VoiceTelemetry::Snapshot VoiceTelemetry::getSnapshot() const noexcept
+{
+    Snapshot s;
+    s.numBlocks = numBlocks.load(std::memory_order_acquire);
+    s.sampleRate = sampleRate.load(std::memory_order_relaxed);
+    s.activeVoices = activeVoices.load(std::memory_order_relaxed);
+    s.voicesInRelease = voicesInRelease.load(std::memory_order_relaxed);
+    s.peakPolyphony = peakPolyphony.load(std::memory_order_relaxed);
+    s.numNotes = numNotes.load(std::memory_order_relaxed);
+    s.numSteals = numSteals.load(std::memory_order_relaxed);
+    s.numOnsets = numOnsets.load(std::memory_order_relaxed);
+    s.maxOnsetSamples = maxOnsetSamples.load(std::memory_order_relaxed);
+    s.oldestVoiceSeconds = double(oldestVoiceSamples.load(std::memory_order_relaxed)) / s.sampleRate;
+    s.longestVoiceSeconds = double(longestVoiceSamples.load(std::memory_order_relaxed)) / s.sampleRate;
+
+    for (int i = 0; i < numStages; ++i)
+        s.stageSeconds[size_t(i)] = double(stageSamples[size_t(i)].load(std::memory_order_relaxed)) / s.sampleRate;
+
+    if (s.numBlocks > 0)
+        s.averageActiveVoices = float(double(activeVoiceSum.load(std::memory_order_relaxed)) / double(s.numBlocks));
+    if (s.numOnsets > 0)
+        s.averageOnsetSamples = float(double(onsetSampleSum.load(std::memory_order_relaxed)) / double(s.numOnsets));
+    return s;
+}
+
+juce::String VoiceTelemetry::Snapshot::toSummaryString() const
+{
+    double totalSeconds = 0.0;
+    for (auto seconds : stageSeconds)
+        totalSeconds += seconds;
+
+    // Share of the rendered voice time spent in each stage
+    auto share = [&](Envelope::Stage stage)
+    {
+        const double seconds = stageSeconds[size_t(stage)];
+        return juce::String(juce::roundToInt(totalSeconds > 0.0 ? 100.0 * seconds / totalSeconds : 0.0));
+    };
+
+    return "Voices " + juce::String(activeVoices) + " (" + juce::String(voicesInRelease) + " rel)" +
+           "  avg " + juce::String(averageActiveVoices, 1) +
+           "  peak " + juce::String(peakPolyphony) +
+           "  steals " + juce::String((juce::int64)numSteals) + "/" + juce::String((juce::int64)numNotes) +
+           "  onset " + formatMilliseconds(averageOnsetSamples, sampleRate) +
+           " max " + formatMilliseconds(maxOnsetSamples, sampleRate) +
+           "  ADSR " + share(Envelope::Stage::Attack) + "/" + share(Envelope::Stage::Decay) + "/" +
+           share(Envelope::Stage::Sustain) + "/" + share(Envelope::Stage::Release) + "%" +
+           " idle " + share(Envelope::Stage::Idle) + "%" +
+           "  oldest " + juce::String(oldestVoiceSeconds, 1) + " s";
+}
+
+juce::String VoiceTelemetry::Snapshot::toDetailedString() const
+{
+    juce::String s;
+    s << "active voices    " << activeVoices << " (" << voicesInRelease << " in release), avg "
+      << juce::String(averageActiveVoices, 2) << ", peak " << peakPolyphony << "\n";
+    s << "notes            " << (juce::int64)numNotes << ", " << (juce::int64)numSteals << " stolen\n";
+    s << "onset            avg " << juce::String(averageOnsetSamples, 1) << " samples ("
+      << formatMilliseconds(averageOnsetSamples, sampleRate) << "), max " << maxOnsetSamples << " samples ("
+      << formatMilliseconds(maxOnsetSamples, sampleRate) << "), " << (juce::int64)numOnsets << " notes\n";
+    s << "voice time       ";
+    for (int i = 0; i < numStages; ++i)
+        s << (i > 0 ? ", " : "") << stageNames[i] << " " << juce::String(stageSeconds[size_t(i)], 2) << " s";
+    s << "\n";
+    s << "oldest voice     " << juce::String(oldestVoiceSeconds, 2) << " s (longest "
+      << juce::String(longestVoiceSeconds, 2) << " s)\n";
+    return s;
+}
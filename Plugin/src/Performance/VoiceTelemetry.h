@@ -0,0 +1,126 @@
+#pragma once
+#include <JuceHeader.h>
+#include "Envelope.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class VoiceTelemetry
+ * @brief Counts what the voices of one instance do: polyphony, steals, envelope stages, onset delay.
+ *
+ * Meant for sizing the polyphony of a patch and for spotting voices that stay
+ * allocated (and cost CPU) long after they stopped being useful.
+ *
+ * The audio thread is the only writer: the voices report note starts, the
+ * samples they render in each Envelope::Stage and the delay to their first
+ * audible sample; the processor closes every block with the voice counts.
+ * Any other thread (GUI timer, offline tools) may read a Snapshot at any
+ * time. No locks and no allocations, as in CpuLoadMeter.
+ *
+ * All sample counts are at the engine sample rate given to prepare().
+ */
+class VoiceTelemetry
+{
+public:
+    /** @brief Number of Envelope::Stage values. */
+    static constexpr int numStages = int(Envelope::Stage::Release) + 1;
+
+    /** @brief First output sample at or above this magnitude (-60 dBFS) counts as the note's onset. */
+    static constexpr float onsetThreshold = 0.001f;
+
+    /** @brief Statistics read from the telemetry at a given moment. */
+    struct Snapshot
+    {
+        int activeVoices = 0;             ///< Voices sounding at the end of the most recent block.
+        int voicesInRelease = 0;          ///< Of those, voices in the Release stage.
+        float averageActiveVoices = 0.0f; ///< Mean active voices per block since the last reset.
+        int peakPolyphony = 0;            ///< Most voices active at the end of a block.
+        uint64_t numNotes = 0;            ///< Notes started.
+        uint64_t numSteals = 0;           ///< Notes started on a voice that was still sounding.
+
+        /** @brief Voice-seconds rendered in each stage (index = Envelope::Stage). Idle: tails after the envelope ended. */
+        std::array<double, numStages> stageSeconds{};
+
+        uint64_t numOnsets = 0;          ///< Notes whose onset was measured.
+        float averageOnsetSamples = 0.0f; ///< Mean samples from note-on to the onset.
+        int maxOnsetSamples = 0;          ///< Longest note-on to onset delay.
+
+        double oldestVoiceSeconds = 0.0;  ///< Age of the oldest sounding note at the end of the last block.
+        double longestVoiceSeconds = 0.0; ///< Longest a note has sounded without its voice going Idle.
+
+        double sampleRate = 44100.0; ///< Engine rate the sample counts refer to.
+        uint64_t numBlocks = 0;      ///< Blocks counted since the last reset.
+
+        /** @brief One line for the GUI status strip. */
+        juce::String toSummaryString() const;
+
+        /** @brief Every counter, one per line (offline tools). */
+        juce::String toDetailedString() const;
+    };
+
+    VoiceTelemetry();
+
+    /**
+     * @brief Sets the engine sample rate and clears all statistics.
+     * @param engineSampleRate Rate the voices render at, in Hz.
+     */
+    void prepare(double engineSampleRate);
+
+    /** @brief Opens a block: applies a pending reset(). Audio thread, before the voices render. */
+    void beginBlock() noexcept;
+
+    /**
+     * @brief Records a note start. Audio thread.
+     * @param stolen True if the voice was still sounding another note.
+     */
+    void addNote(bool stolen) noexcept;
+
+    /** @brief Adds samples a voice rendered in the given stage. Audio thread. */
+    void addStageSamples(Envelope::Stage stage, int numSamples) noexcept;
+
+    /** @brief Records the delay from a note-on to its first audible sample. Audio thread. */
+    void addOnset(int samplesFromNoteOn) noexcept;
+
+    /**
+     * @brief Closes a block with the voice counts at its end. Audio thread.
+     * @param activeVoices Voices playing a note.
+     * @param voicesInRelease Voices whose envelope is in Release.
+     * @param oldestVoiceSamples Samples since the note-on of the oldest active voice.
+     */
+    void endBlock(int activeVoices, int voicesInRelease, juce::int64 oldestVoiceSamples) noexcept;
+
+    /**
+     * @brief Asks the audio thread to clear the statistics before its next block.
+     *
+     * Safe to call from any thread.
+     */
+    void reset() noexcept;
+
+    /** @brief Returns the current statistics. Safe to call from any thread. */
+    Snapshot getSnapshot() const noexcept;
+
+private:
+    void clearStatistics() noexcept;
+
+    std::atomic<double> sampleRate{44100.0};
+
+    std::atomic<int> activeVoices{0};
+    std::atomic<int> voicesInRelease{0};
+    std::atomic<int> peakPolyphony{0};
+    std::atomic<uint64_t> activeVoiceSum{0};
+    std::atomic<uint64_t> numBlocks{0};
+
+    std::atomic<uint64_t> numNotes{0};
+    std::atomic<uint64_t> numSteals{0};
+    std::array<std::atomic<uint64_t>, numStages> stageSamples;
+
+    std::atomic<uint64_t> numOnsets{0};
+    std::atomic<uint64_t> onsetSampleSum{0};
+    std::atomic<int> maxOnsetSamples{0};
+
+    std::atomic<juce::int64> oldestVoiceSamples{0};
+    std::atomic<juce::int64> longestVoiceSamples{0};
+
+    std::atomic<bool> resetRequested{false};
+};
@@ -1,5 +1,44 @@
 #include "PluginProcessor.h"
+#include "DSP/KernelDispatch.h"
 #include "GUI.h"
+#include "Performance/Trace.h"
+
+namespace
+{
+    // Parámetros de cada capa, en el orden de las formas de onda de WAVE
+    struct LayerParameterIDs
+    {
+        const char *name;
+        const char *level;
+        const char *octave;
+        const char *detune;
+        const char *sync;
+    };
+
+    const LayerParameterIDs layerParameterIDs[OscillatorWrapper::numWaveTypes] = {
+        {"Sine", "LAYER_SINE_LEVEL", "LAYER_SINE_OCTAVE", "LAYER_SINE_DETUNE", "LAYER_SINE_SYNC"},
+        {"Saw", "LAYER_SAW_LEVEL", "LAYER_SAW_OCTAVE", "LAYER_SAW_DETUNE", "LAYER_SAW_SYNC"},
+        {"Square", "LAYER_SQUARE_LEVEL", "LAYER_SQUARE_OCTAVE", "LAYER_SQUARE_DETUNE", "LAYER_SQUARE_SYNC"},
+        {"Triangle", "LAYER_TRIANGLE_LEVEL", "LAYER_TRIANGLE_OCTAVE", "LAYER_TRIANGLE_DETUNE", "LAYER_TRIANGLE_SYNC"},
+    };
+
+    // Parámetros de cada operador FM (índice 0 = operador 1)
+    struct OperatorParameterIDs
+    {
+        const char *ratio;
+        const char *level;
+        const char *feedback;
+    };
+
+    const OperatorParameterIDs operatorParameterIDs[FMOscillator::numOperators] = {
+        {"FM_OP1_RATIO", "FM_OP1_LEVEL", "FM_OP1_FEEDBACK"},
+        {"FM_OP2_RATIO", "FM_OP2_LEVEL", "FM_OP2_FEEDBACK"},
+        {"FM_OP3_RATIO", "FM_OP3_LEVEL", "FM_OP3_FEEDBACK"},
+        {"FM_OP4_RATIO", "FM_OP4_LEVEL", "FM_OP4_FEEDBACK"},
+        {"FM_OP5_RATIO", "FM_OP5_LEVEL", "FM_OP5_FEEDBACK"},
+        {"FM_OP6_RATIO", "FM_OP6_LEVEL", "FM_OP6_FEEDBACK"},
+    };
+}
 
 class SynthSound : public juce::SynthesiserSound
 {
@@ -21,32 +60,327 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
                          ),
       apvts(*this, nullptr, "PARAMETERS", createParameterLayout())
 {
+    // Elige los kernels DSP (SSE2/AVX2/AVX-512/NEON) antes de que arranque el hilo de audio
+    KernelDispatch::get();
+
     synth.clearVoices();
     for (int i = 0; i < 8; ++i) // 8 voces = polifonía estándar
-        synth.addVoice(new SynthVoice());
+        voiceList.push_back(synth.addVoice(new SynthVoice()));
+
+    // Todas las voces leen la misma tabla nota → frecuencia y reportan a la misma telemetría
+    for (auto *v : voiceList)
+    {
+        v->setTuning(&tuning);
+        v->setTelemetry(&voiceTelemetry);
+    }
 
     synth.clearSounds();
     synth.addSound(new SynthSound());
+
+    startTimer(50);
 }
 
-AudioPluginAudioProcessor::~AudioPluginAudioProcessor() {}
+AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
+{
+    stopTimer();
+    wavetableBuilder.removeAllJobs(true, 10000);
+}
 
 //==============================================================================
 // PREPARACIÓN DE AUDIO
 void AudioPluginAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    juce::ignoreUnused(samplesPerBlock);
-    synth.setCurrentPlaybackSampleRate(sampleRate);
+    hostSampleRate = sampleRate;
+    hostBlockSize = juce::jmax(1, samplesPerBlock);
+    cpuLoadMeter.prepare(sampleRate);
+    scopeFifo.prepare(sampleRate);
+    qualityGovernor.reset();
+
+    prepareEngine();
+
+    // Solo las formas de onda seleccionadas se construyen antes de sonar
+    materializeSelectedWaves();
+}
 
-    // Propagar sampleRate a voces si es necesario (las voces en su constructor pueden usar este valor)
-    for (int i = 0; i < synth.getNumVoices(); ++i)
+void AudioPluginAudioProcessor::prepareEngine()
+{
+    // ENGINE_RATE: 0 = la del host, 1 = 44.1 kHz, 2 = 48 kHz
+    static constexpr double fixedRates[] = {0.0, 44100.0, 48000.0};
+    engineRateChoice = juce::jlimit(0, 2, static_cast<int>(*apvts.getRawParameterValue("ENGINE_RATE")));
+    engineSampleRate = fixedRates[engineRateChoice] > 0.0 ? fixedRates[engineRateChoice] : hostSampleRate;
+    engineResampling = engineSampleRate != hostSampleRate;
+
+    // Recalcula los incrementos de fase de la afinación antes de que suenen las voces
+    tuning.setSampleRate(engineSampleRate);
+    voiceTelemetry.prepare(engineSampleRate);
+
+    // Propagar la frecuencia del motor a las voces
     {
-        if (auto *v = dynamic_cast<SynthVoice *>(synth.getVoice(i)))
+        const juce::ScopedLock sl(memoryLock); // los bancos del filtro se regeneran aquí
+        synth.setCurrentPlaybackSampleRate(engineSampleRate); // incluye el filtro compartido
+
+        // Un solo juego de wavetables por instancia, construido a la frecuencia del motor
+        if (wavetables == nullptr || wavetables->getSampleRate() != engineSampleRate)
+            wavetables = std::make_shared<WavetableSet>(engineSampleRate);
+
+        for (auto *v : voiceList)
+        {
+            v->setWavetables(wavetables);
+            v->prepare(engineSampleRate);
+        }
+
+        if (engineResampling)
+        {
+            resampler.prepare(engineSampleRate, hostSampleRate, hostBlockSize);
+            engineBuffer.setSize(1, resampler.getMaxInputSamples());
+            engineMidi.ensureSize(2048);
+        }
+        else
         {
-            // Si en el futuro hace falta pasar sampleRate explícitamente se haría aquí
-            v->prepare(sampleRate);
+            engineBuffer.setSize(0, 0);
         }
     }
+
+    setLatencySamples(engineResampling ? juce::roundToInt(resampler.getLatencyInOutputSamples()) : 0);
+}
+
+//==============================================================================
+// CONSTRUCCIÓN PEREZOSA DE OSCILADORES
+void AudioPluginAudioProcessor::materializeWave(int waveIndex)
+{
+    for (auto *v : voiceList)
+        v->materializeWave(waveIndex);
+
+    getMemoryUsage(); // actualiza el pico con las tablas nuevas
+}
+
+uint32_t AudioPluginAudioProcessor::getSelectedWaves() const
+{
+    uint32_t waves = 0;
+    const int selected = static_cast<int>(*apvts.getRawParameterValue("WAVE"));
+    if (juce::isPositiveAndBelow(selected, OscillatorWrapper::numWaveTypes))
+        waves |= 1u << selected;
+
+    // Solo el modo capas usa otras formas de onda (el FM lee el Sine, siempre construido;
+    // la aditiva no usa tablas y la wavetable importada se genera aparte)
+    if (static_cast<int>(*apvts.getRawParameterValue("OSC_MODE")) == 1)
+        for (int wave = 0; wave < OscillatorWrapper::numWaveTypes; ++wave)
+            if (*apvts.getRawParameterValue(layerParameterIDs[wave].level) > 0.0f)
+                waves |= 1u << wave;
+
+    return waves;
+}
+
+void AudioPluginAudioProcessor::materializeSelectedWaves()
+{
+    const uint32_t waves = getSelectedWaves();
+    for (int wave = 0; wave < OscillatorWrapper::numWaveTypes; ++wave)
+        if ((waves & (1u << wave)) != 0)
+            materializeWave(wave);
+}
+
+void AudioPluginAudioProcessor::requestSelectedWaves()
+{
+    const uint32_t waves = getSelectedWaves();
+    for (int wave = 0; wave < OscillatorWrapper::numWaveTypes; ++wave)
+        if ((waves & (1u << wave)) != 0)
+            requestWaveMaterialization(wave);
+}
+
+//==============================================================================
+// CONTABILIDAD DE MEMORIA
+MemoryUsage AudioPluginAudioProcessor::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    {
+        const juce::ScopedLock sl(memoryLock);
+        for (auto *v : voiceList)
+            v->addMemoryUsage(usage);
+
+        // Las tablas son compartidas: se cuentan una vez, no por voz
+        if (wavetables != nullptr)
+            for (int wave = 0; wave < WavetableSet::numWaveTypes; ++wave)
+            {
+                std::string name;
+                const auto bankBytes = wavetables->getBankBytes(wave, name);
+                usage.addWave(juce::String(name), bankBytes);
+            }
+
+        const auto &sharedFilter = synth.getSharedFilter().getFilter();
+        usage.lowpassBankBytes += sharedFilter.getLowpassBankBytes();
+        usage.highpassBankBytes += sharedFilter.getHighpassBankBytes();
+        usage.bandpassBankBytes += sharedFilter.getBandpassBankBytes();
+    }
+
+    usage.scratchBytes += scopeFifo.getMemoryBytes();
+    if (engineResampling)
+        usage.scratchBytes += resampler.getMemoryBytes() +
+                              size_t(engineBuffer.getNumSamples()) * sizeof(float);
+    usage.tuningBytes = tuning.getMemoryBytes();
+    {
+        // La wavetable mapeada la pagina el sistema y se comparte entre instancias: va aparte
+        const juce::ScopedLock sl(memoryLock);
+        if (userWavetable != nullptr && userWavetable->isMapped())
+            usage.mappedWavetableBytes = userWavetable->getTableBytes();
+        else if (userWavetable != nullptr)
+            usage.userWavetableBytes = userWavetable->getTableBytes();
+    }
+    usage.processorBytes = sizeof(AudioPluginAudioProcessor);
+
+    usage.peakTotalBytes = peakMemoryBytes.load(std::memory_order_relaxed);
+    usage.updateTotals();
+
+    auto peak = peakMemoryBytes.load(std::memory_order_relaxed);
+    while (peak < usage.totalBytes &&
+           !peakMemoryBytes.compare_exchange_weak(peak, usage.totalBytes, std::memory_order_relaxed))
+    {
+    }
+    return usage;
+}
+
+void AudioPluginAudioProcessor::requestWaveMaterialization(int waveIndex)
+{
+    if (waveIndex < 0 || waveIndex >= OscillatorWrapper::numWaveTypes)
+        return;
+
+    const uint32_t bit = 1u << waveIndex;
+    if ((wavesInFlight.fetch_or(bit) & bit) != 0)
+        return; // ya encolada
+
+    wavetableBuilder.addJob([this, waveIndex, bit]
+                            {
+                                materializeWave(waveIndex);
+                                wavesInFlight.fetch_and(~bit); });
+}
+
+//==============================================================================
+// WAVETABLE IMPORTADA
+bool AudioPluginAudioProcessor::loadWavetableFile(const juce::File &file, juce::String *errorMessage)
+{
+    // La lectura es rápida y da el error al momento; los mip-maps se generan en segundo plano
+    std::vector<float> frames;
+    if (!UserWavetable::readWavFile(file, frames, errorMessage))
+        return false;
+
+    const uint64_t hash = UserWavetable::computeHash(frames);
+    {
+        const juce::ScopedLock sl(wavetableLock);
+        userWavetableFile = file;
+        userWavetableHash = hash;
+    }
+    requestWavetableBuild(file, hash, std::move(frames));
+    return true;
+}
+
+AudioPluginAudioProcessor::WavetableStatus AudioPluginAudioProcessor::getWavetableStatus() const
+{
+    WavetableStatus status;
+    const juce::ScopedLock sl(wavetableLock);
+    if (userWavetableHash == 0)
+        return status;
+
+    status.name = userWavetableFile.getFileName();
+    status.loading = wavetableBuildsPending.load() > 0;
+    if (userWavetable != nullptr)
+    {
+        status.numFrames = userWavetable->getNumFrames();
+        status.mapped = userWavetable->isMapped();
+    }
+    return status;
+}
+
+void AudioPluginAudioProcessor::restoreWavetable(const juce::File &file, uint64_t hash)
+{
+    bool alreadyInstalled = false;
+    {
+        const juce::ScopedLock sl(wavetableLock);
+        userWavetableFile = file;
+        userWavetableHash = hash;
+        alreadyInstalled = userWavetable != nullptr && hash != 0 && userWavetable->getHash() == hash;
+    }
+
+    if (alreadyInstalled)
+    {
+        ++wavetableGeneration; // descarta cargas encoladas antes
+        return;
+    }
+
+    if (hash != 0)
+    {
+        requestWavetableBuild(file, hash, {});
+    }
+    else
+    {
+        ++wavetableGeneration;
+        installUserWavetable(nullptr);
+    }
+}
+
+void AudioPluginAudioProcessor::requestWavetableBuild(const juce::File &file, uint64_t hash, std::vector<float> frames)
+{
+    const int generation = ++wavetableGeneration;
+    ++wavetableBuildsPending;
+
+    wavetableBuilder.addJob([this, file, hash, generation, frames = std::move(frames)]
+                            {
+                                // Primero la caché: al reabrir un proyecto no hace falta ni el WAV
+                                const auto cacheDirectory = UserWavetable::getDefaultCacheDirectory();
+                                std::unique_ptr<const UserWavetable> table = UserWavetable::openCached(cacheDirectory, hash);
+                                if (table == nullptr)
+                                {
+                                    std::vector<float> fromFile;
+                                    if (frames.empty())
+                                        UserWavetable::readWavFile(file, fromFile);
+
+                                    const auto &source = frames.empty() ? fromFile : frames;
+                                    if (!source.empty())
+                                        table = UserWavetable::build(source, cacheDirectory);
+                                }
+
+                                // Una carga posterior ya pidió otra tabla: esta se descarta
+                                if (generation == wavetableGeneration.load())
+                                    installUserWavetable(std::move(table));
+                                --wavetableBuildsPending; });
+}
+
+void AudioPluginAudioProcessor::installUserWavetable(std::unique_ptr<const UserWavetable> table)
+{
+    {
+        // Mismo orden de locks que prepareEngine() (callback y luego memoria)
+        const juce::ScopedLock audioLock(getCallbackLock());
+        const juce::ScopedLock ml(memoryLock);
+        const juce::ScopedLock wl(wavetableLock);
+        userWavetable.swap(table);
+
+        // Si el WAV cambió desde que se guardó el estado, el hash pasa a ser el de sus frames nuevos
+        if (userWavetable != nullptr)
+            userWavetableHash = userWavetable->getHash();
+
+        for (auto *v : voiceList)
+            v->setUserWavetable(userWavetable.get());
+    }
+
+    getMemoryUsage(); // actualiza el pico con la tabla nueva
+    // La tabla anterior se libera aquí, sin bloquear el audio
+}
+
+void AudioPluginAudioProcessor::timerCallback()
+{
+    for (auto *v : voiceList)
+    {
+        const int waveIndex = v->getPendingWaveType();
+        if (waveIndex >= 0)
+            requestWaveMaterialization(waveIndex);
+    }
+
+    // Cambio de ENGINE_RATE: se vuelve a preparar el motor con el audio detenido
+    const int rateChoice = static_cast<int>(*apvts.getRawParameterValue("ENGINE_RATE"));
+    if (hostBlockSize > 0 && rateChoice != engineRateChoice)
+    {
+        suspendProcessing(true);
+        prepareEngine();
+        suspendProcessing(false);
+    }
 }
 
 //==============================================================================
@@ -61,6 +395,8 @@ void AudioPluginAudioProcessor::releaseResources()
 void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                              juce::MidiBuffer &midiMessages)
 {
+    TEC_TRACE_SCOPE("AudioPluginAudioProcessor::processBlock");
+    CpuLoadMeter::ScopedMeasurement loadMeasurement(cpuLoadMeter, buffer.getNumSamples());
     juce::ScopedNoDenormals noDenormals;
     buffer.clear();
 
@@ -68,8 +404,74 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     combinedMidi.addEvents(midiMessages, 0, buffer.getNumSamples(), 0);
     keyboardState.processNextMidiBuffer(combinedMidi, 0, buffer.getNumSamples(), true);
 
+    // Ajuste de calidad según la carga del bloque anterior (nunca en render offline)
+    qualityGovernor.setEnabled(*apvts.getRawParameterValue("GOVERNOR") > 0.5f && !isNonRealtime());
+    qualityLevel = &qualityGovernor.update(cpuLoadMeter.getLastLoad());
+    synth.setMaxActiveVoices(qualityLevel->maxVoices);
+    if (qualityLevel->cullReleasingVoices)
+        synth.cullReleasingVoices();
+
+    // Programa recién elegido: sus valores se leen del snapshot inmutable
+    activeProgram = programOverride.load(std::memory_order_acquire);
+
+    tuning.beginBlock(); // las tablas de afinación retiradas antes de este bloque ya se pueden liberar
     updateVoicesParameters(); // aplica cambios de GUI en tiempo real
-    synth.renderNextBlock(buffer, combinedMidi, 0, buffer.getNumSamples());
+    voiceTelemetry.beginBlock();
+    if (engineResampling)
+        renderResampled(buffer, combinedMidi);
+    else
+        synth.renderNextBlock(buffer, combinedMidi, 0, buffer.getNumSamples());
+    synth.reportVoiceActivity(voiceTelemetry);
+
+    // Copia acotada para el visualizador (las voces escriben igual en todos los canales)
+    scopeFifo.push(buffer.getReadPointer(0), buffer.getNumSamples());
+
+    // Con el APVTS ya sincronizado se vuelve a leer de los parámetros en vivo
+    if (activeProgram != nullptr && programInSync.load(std::memory_order_acquire))
+    {
+        auto *expected = activeProgram;
+        programOverride.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+    }
+    activeProgram = nullptr;
+}
+
+void AudioPluginAudioProcessor::renderResampled(juce::AudioBuffer<float> &buffer,
+                                                const juce::MidiBuffer &midi)
+{
+    TEC_TRACE_SCOPE("AudioPluginAudioProcessor::renderResampled");
+    const double step = engineSampleRate / hostSampleRate;
+    const int numSamples = buffer.getNumSamples();
+
+    // Tramos de como mucho hostBlockSize: engineBuffer está dimensionado para eso
+    for (int start = 0; start < numSamples; start += hostBlockSize)
+    {
+        const int numOut = juce::jmin(hostBlockSize, numSamples - start);
+        const int numIn = resampler.getInputSamplesNeeded(numOut);
+
+        // Eventos del tramo, llevados a la escala de tiempo del motor
+        engineMidi.clear();
+        for (const auto metadata : midi)
+        {
+            const int position = metadata.samplePosition;
+            if (position < start)
+                continue;
+            if (position >= start + numOut)
+                break;
+            engineMidi.addEvent(metadata.getMessage(),
+                                juce::jlimit(0, juce::jmax(0, numIn - 1), int((position - start) * step)));
+        }
+
+        // Con numIn == 0 el Synthesiser igual procesa los eventos
+        juce::AudioBuffer<float> engineView(engineBuffer.getArrayOfWritePointers(), 1, numIn);
+        engineView.clear();
+        synth.renderNextBlock(engineView, engineMidi, 0, numIn);
+
+        resampler.process(engineBuffer.getReadPointer(0), numIn, buffer.getWritePointer(0, start), numOut);
+    }
+
+    // El motor es mono: el resto de canales copia el primero
+    for (int ch = 1; ch < buffer.getNumChannels(); ++ch)
+        buffer.copyFrom(ch, 0, buffer, 0, 0, numSamples);
 }
 
 //==============================================================================
@@ -103,12 +505,49 @@ juce::AudioProcessorEditor *AudioPluginAudioProcessor::createEditor()
 
 //==============================================================================
 // MÉTODOS REQUERIDOS POR JUCE
-int AudioPluginAudioProcessor::getNumPrograms() { return 1; }
-int AudioPluginAudioProcessor::getCurrentProgram() { return 0; }
-void AudioPluginAudioProcessor::setCurrentProgram(int) {}
-const juce::String AudioPluginAudioProcessor::getProgramName(int) { return {}; }
+int AudioPluginAudioProcessor::getNumPrograms() { return presetLibrary.getNumPresets(); }
+int AudioPluginAudioProcessor::getCurrentProgram() { return currentProgram; }
+
+void AudioPluginAudioProcessor::setCurrentProgram(int index)
+{
+    auto *preset = presetLibrary.getPreset(index);
+    if (preset == nullptr)
+        return;
+
+    currentProgram = index;
+
+    // El hilo de audio toma el snapshot entero en el próximo bloque; mientras el
+    // APVTS se actualiza parámetro por parámetro, sigue leyendo del snapshot.
+    programInSync.store(false, std::memory_order_release);
+    programOverride.store(preset, std::memory_order_release);
+    preset->applyTo(apvts);
+    programInSync.store(true, std::memory_order_release);
+
+    // Si la forma de onda del preset no existe todavía, se construye en segundo plano
+    requestWaveMaterialization(static_cast<int>(preset->getValue("WAVE", 0.0f)));
+}
+
+const juce::String AudioPluginAudioProcessor::getProgramName(int index)
+{
+    auto *preset = presetLibrary.getPreset(index);
+    return preset != nullptr ? preset->name : juce::String();
+}
+
+// Los presets son inmutables
 void AudioPluginAudioProcessor::changeProgramName(int, const juce::String &) {}
 
+// Guarda el estado actual como preset del usuario (se escribe en el banco del usuario)
+bool AudioPluginAudioProcessor::saveCurrentAsPreset(const juce::String &name)
+{
+    const int index = presetLibrary.saveUserPreset(ParameterSnapshot::capture(apvts, name));
+    if (index < 0)
+        return false;
+
+    currentProgram = index;
+    updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+    return true;
+}
+
 const juce::String AudioPluginAudioProcessor::getName() const { return JucePlugin_Name; }
 bool AudioPluginAudioProcessor::acceptsMidi() const
 {
@@ -138,14 +577,92 @@ double AudioPluginAudioProcessor::getTailLengthSeconds() const { return 0.0; }
 
 //==============================================================================
 // STATE MGMT
+// Formato binario: ParameterSnapshot (ver ParameterSnapshot.h) + uint16 programa actual
+// + uint32 bytes + texto Scala UTF-8 de la afinación (0 bytes = 12-TET)
+// + uint32 bytes + ruta UTF-8 de la wavetable importada + uint64 hash de sus frames (0 = ninguna)
 void AudioPluginAudioProcessor::getStateInformation(juce::MemoryBlock &destData)
 {
-    juce::ignoreUnused(destData);
+    const auto snapshot = ParameterSnapshot::capture(apvts);
+    const auto scala = tuning.get().scalaText.toStdString();
+
+    std::string wavetablePath;
+    uint64_t wavetableHash = 0;
+    {
+        const juce::ScopedLock sl(wavetableLock);
+        if (userWavetableHash != 0)
+            wavetablePath = userWavetableFile.getFullPathName().toStdString();
+        wavetableHash = userWavetableHash;
+    }
+
+    destData.setSize(0);
+    destData.ensureSize(snapshot.getSerializedSize() + 2 + 4 + scala.size() + 4 + wavetablePath.size() + 8);
+
+    juce::MemoryOutputStream out(destData, false);
+    snapshot.writeTo(out);
+    out.writeShort(short(currentProgram));
+    out.writeInt(int(scala.size()));
+    out.write(scala.data(), scala.size());
+    out.writeInt(int(wavetablePath.size()));
+    out.write(wavetablePath.data(), wavetablePath.size());
+    out.writeInt64(juce::int64(wavetableHash));
 }
 
 void AudioPluginAudioProcessor::setStateInformation(const void *data, int sizeInBytes)
 {
-    juce::ignoreUnused(data, sizeInBytes);
+    if (data == nullptr || sizeInBytes <= 0)
+        return;
+
+    ParameterSnapshot snapshot;
+    size_t used = 0;
+    if (!ParameterSnapshot::readFrom(data, size_t(sizeInBytes), snapshot, &used))
+        return;
+
+    snapshot.applyTo(apvts);
+
+    if (size_t(sizeInBytes) >= used + 2)
+    {
+        auto *bytes = static_cast<const uint8_t *>(data) + used;
+        const int program = juce::ByteOrder::littleEndianShort(bytes);
+        if (juce::isPositiveAndBelow(program, presetLibrary.getNumPresets()))
+            currentProgram = program;
+        used += 2;
+    }
+
+    // Afinación: estados anteriores no la incluyen y vuelven a 12-TET
+    bool tuningLoaded = false;
+    if (size_t(sizeInBytes) >= used + 4)
+    {
+        auto *bytes = static_cast<const uint8_t *>(data) + used;
+        const auto textBytes = size_t(juce::ByteOrder::littleEndianInt(bytes));
+        if (textBytes > 0 && size_t(sizeInBytes) >= used + 4 + textBytes)
+        {
+            const auto text = juce::String::fromUTF8(reinterpret_cast<const char *>(bytes + 4), int(textBytes));
+            tuningLoaded = tuning.loadScalaText(text);
+        }
+        used += 4 + textBytes;
+    }
+    if (!tuningLoaded)
+        tuning.resetToEqualTemperament();
+
+    // Wavetable importada: se mapea de la caché por su hash (el WAV solo hace falta si no está)
+    juce::File wavetableFile;
+    uint64_t wavetableHash = 0;
+    if (size_t(sizeInBytes) >= used + 4)
+    {
+        auto *bytes = static_cast<const uint8_t *>(data) + used;
+        const auto pathBytes = size_t(juce::ByteOrder::littleEndianInt(bytes));
+        if (size_t(sizeInBytes) >= used + 4 + pathBytes + 8)
+        {
+            const auto path = juce::String::fromUTF8(reinterpret_cast<const char *>(bytes + 4), int(pathBytes));
+            wavetableHash = uint64_t(juce::ByteOrder::littleEndianInt64(bytes + 4 + pathBytes));
+            if (wavetableHash != 0 && juce::File::isAbsolutePath(path))
+                wavetableFile = juce::File(path);
+        }
+    }
+    restoreWavetable(wavetableFile, wavetableHash);
+
+    // Como al cambiar WAVE: el host no espera a que se generen las tablas
+    requestSelectedWaves();
 }
 
 //==============================================================================
@@ -169,6 +686,96 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::c
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "VELOCITY", "Velocity", 0.0f, 1.0f, 1.0f));
 
+    // Ancho de pulso de la onda cuadrada (0.5 = cuadrada)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "PULSE_WIDTH", "Pulse Width",
+        juce::NormalisableRange<float>(0.05f, 0.95f, 0.001f), 0.5f));
+
+    // Fuente de la voz: una forma de onda, las cuatro en capas (nivel, octava, desafinación
+    // y sync cada una), FM de seis operadores, aditiva o una wavetable importada
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "OSC_MODE", "Oscillator Mode",
+        juce::StringArray{"Single", "Layer", "FM", "Additive", "Wavetable"}, 0));
+
+    for (int wave = 0; wave < OscillatorWrapper::numWaveTypes; ++wave)
+    {
+        const auto &ids = layerParameterIDs[wave];
+        const juce::String name = juce::String("Layer ") + ids.name;
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            ids.level, name + " Level",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), wave == 0 ? 1.0f : 0.0f));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            ids.octave, name + " Octave",
+            juce::NormalisableRange<float>(-2.0f, 2.0f, 1.0f), 0.0f));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            ids.detune, name + " Detune",
+            juce::NormalisableRange<float>(-50.0f, 50.0f, 0.1f), 0.0f));
+
+        params.push_back(std::make_unique<juce::AudioParameterBool>(
+            ids.sync, name + " Sync", false));
+    }
+
+    // FM: algoritmo, y razón/nivel/feedback por operador (por defecto, operador 2 sobre el 1)
+    juce::StringArray algorithmNames;
+    for (int algorithm = 0; algorithm < FMOscillator::numAlgorithms; ++algorithm)
+        algorithmNames.add(FMOscillator::getAlgorithmName(algorithm));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "FM_ALGORITHM", "FM Algorithm", algorithmNames, 0));
+
+    for (int k = 0; k < FMOscillator::numOperators; ++k)
+    {
+        const auto &ids = operatorParameterIDs[k];
+        const juce::String name = "FM Op " + juce::String(k + 1);
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            ids.ratio, name + " Ratio",
+            juce::NormalisableRange<float>(0.5f, 16.0f, 0.01f, 0.4f), 1.0f));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            ids.level, name + " Level",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), k == 0 ? 1.0f : k == 1 ? 0.3f : 0.0f));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            ids.feedback, name + " Feedback",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), 0.0f));
+    }
+
+    // Envelope de los moduladores: attack y release son los del ADSR
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "FM_MOD_DECAY", "FM Mod Decay", juce::NormalisableRange<float>(0.001f, 5.0f, 0.001f), 0.5f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "FM_MOD_SUSTAIN", "FM Mod Sustain", juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), 0.5f));
+
+    // Aditiva: cantidad de parciales, inclinación del espectro (1/k^tilt), nivel de los
+    // parciales pares, y envelope de cada parcial (decay más corto hacia arriba)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "ADD_PARTIALS", "Additive Partials",
+        juce::NormalisableRange<float>(1.0f, float(AdditiveOscillator::maxPartials), 1.0f, 0.4f), 64.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "ADD_TILT", "Additive Tilt", juce::NormalisableRange<float>(0.0f, 3.0f, 0.01f), 1.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "ADD_EVEN", "Additive Even Level", juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), 1.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "ADD_DECAY", "Additive Decay", juce::NormalisableRange<float>(0.01f, 10.0f, 0.001f, 0.4f), 2.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "ADD_DAMPING", "Additive Damping", juce::NormalisableRange<float>(0.0f, 2.0f, 0.01f), 0.5f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "ADD_SUSTAIN", "Additive Sustain", juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), 0.3f));
+
+    // Wavetable importada: posición del morph entre el primer y el último frame
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "WAVE_POSITION", "Wave Position", juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), 0.0f));
+
     // ADSR parameters (attack, decay in seconds; sustain 0..1; release seconds)
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "ATTACK", "Attack", juce::NormalisableRange<float>(0.001f, 5.0f, 0.001f), 0.01f));
@@ -189,43 +796,171 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::c
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "FILTER_CUTOFF", "Filter Cutoff",
         juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.5f), 1000.0f));
+
+    // Parafónico: un solo filtro sobre la mezcla de voces en vez de uno por voz
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "FILTER_MODE", "Filter Mode",
+        juce::StringArray{"Per Voice", "Paraphonic"}, 0));
+
+    // Modulación de altura (todo apagado por defecto salvo el rango del bend)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "BEND_RANGE", "Pitch Bend Range",
+        juce::NormalisableRange<float>(0.0f, 24.0f, 1.0f), 2.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "GLIDE", "Glide",
+        juce::NormalisableRange<float>(0.0f, 2.0f, 0.001f, 0.4f), 0.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "VIBRATO_RATE", "Vibrato Rate",
+        juce::NormalisableRange<float>(0.1f, 12.0f, 0.01f), 5.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "VIBRATO_DEPTH", "Vibrato Depth",
+        juce::NormalisableRange<float>(0.0f, 2.0f, 0.01f), 0.0f));
+
+    // Rendimiento: governor de calidad adaptativo
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "GOVERNOR", "Quality Governor", true));
+
+    // Rendimiento: replay de un período asentado en notas sostenidas
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "SUSTAIN_CACHE", "Sustain Cache", false));
+
+    // Frecuencia interna del motor; fija = remuestreo al host con latencia reportada
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "ENGINE_RATE", "Engine Rate",
+        juce::StringArray{"Host", "44.1 kHz", "48 kHz"}, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable(false)));
     return {params.begin(), params.end()};
 }
 
 //==============================================================================
 // PROPAGACIÓN DE PARÁMETROS A LAS VOCES
-void AudioPluginAudioProcessor::updateVoicesParameters()
+float AudioPluginAudioProcessor::getParameterValue(const char *parameterID) const
 {
-    // Leer parámetros de oscilador
-    int waveIndex = static_cast<int>(*apvts.getRawParameterValue("WAVE"));
-    float velocity = *apvts.getRawParameterValue("VELOCITY");
+    const float live = apvts.getRawParameterValue(parameterID)->load();
+    if (activeProgram == nullptr)
+        return live;
 
-    // Leer parámetros ADSR
-    float attack = *apvts.getRawParameterValue("ATTACK");
-    float decay = *apvts.getRawParameterValue("DECAY");
-    float sustain = *apvts.getRawParameterValue("SUSTAIN");
-    float release = *apvts.getRawParameterValue("RELEASE");
+    // Lo que el preset no guarda vuelve a su valor por defecto, igual que en applyTo()
+    const auto *parameter = apvts.getParameter(parameterID);
+    return activeProgram->getValue(parameterID, parameter != nullptr ? ParameterSnapshot::getMissingValue(*parameter, live) : live);
+}
 
-    // Leer parámetros del filtro
-    int filterTypeIndex = static_cast<int>(*apvts.getRawParameterValue("FILTER_TYPE"));
-    juce::String filterTypeStr = filterTypeIndex == 0 ? "lowpass" : filterTypeIndex == 1 ? "highpass"
-                                                                                         : "bandpass";
-    float filterCutoff = *apvts.getRawParameterValue("FILTER_CUTOFF");
+void AudioPluginAudioProcessor::updateVoicesParameters()
+{
+    TEC_TRACE_SCOPE("AudioPluginAudioProcessor::updateVoicesParameters");
 
-    // Propagar parámetros a todas las voces activas
-    for (int i = 0; i < synth.getNumVoices(); ++i)
+    // Leer parámetros de oscilador
+    int waveIndex = static_cast<int>(getParameterValue("WAVE"));
+    float velocity = getParameterValue("VELOCITY");
+    float pulseWidth = getParameterValue("PULSE_WIDTH");
+
+    // Leer parámetros del modo capas (OSC_MODE: 0 = Single, 1 = Layer, 2 = FM, 3 = Additive, 4 = Wavetable)
+    int oscMode = static_cast<int>(getParameterValue("OSC_MODE"));
+    bool layerMode = oscMode == 1;
+    std::array<OscillatorWrapper::LayerSettings, OscillatorWrapper::numWaveTypes> layers;
+    for (int wave = 0; wave < OscillatorWrapper::numWaveTypes; ++wave)
     {
-        if (auto voice = dynamic_cast<SynthVoice *>(synth.getVoice(i)))
-        {
-            // Oscillator
-            voice->setWaveType(waveIndex);
-            voice->setAmplitude(velocity);
+        const auto &ids = layerParameterIDs[wave];
+        auto &layer = layers[size_t(wave)];
+        layer.level = getParameterValue(ids.level);
+        layer.octave = juce::roundToInt(getParameterValue(ids.octave));
+        layer.detuneCents = getParameterValue(ids.detune);
+        layer.sync = getParameterValue(ids.sync) > 0.5f;
+    }
 
-            // ADSR
-            voice->setEnvelopeParameters(attack, decay, sustain, release);
+    // Leer parámetros FM
+    bool fmMode = oscMode == 2;
+    int fmAlgorithm = static_cast<int>(getParameterValue("FM_ALGORITHM"));
+    std::array<FMOscillator::OperatorSettings, FMOscillator::numOperators> operators;
+    for (int k = 0; k < FMOscillator::numOperators; ++k)
+    {
+        const auto &ids = operatorParameterIDs[k];
+        auto &settings = operators[size_t(k)];
+        settings.ratio = getParameterValue(ids.ratio);
+        settings.level = getParameterValue(ids.level);
+        settings.feedback = getParameterValue(ids.feedback);
+    }
+    float fmModDecay = getParameterValue("FM_MOD_DECAY");
+    float fmModSustain = getParameterValue("FM_MOD_SUSTAIN");
+
+    // Leer parámetros de la fuente aditiva
+    bool additiveMode = oscMode == 3;
+    AdditiveOscillator::Settings additive;
+    additive.partials = juce::roundToInt(getParameterValue("ADD_PARTIALS"));
+    additive.tilt = getParameterValue("ADD_TILT");
+    additive.evenLevel = getParameterValue("ADD_EVEN");
+    additive.decay = getParameterValue("ADD_DECAY");
+    additive.damping = getParameterValue("ADD_DAMPING");
+    additive.sustain = getParameterValue("ADD_SUSTAIN");
+
+    // Wavetable importada
+    bool userWavetableMode = oscMode == 4;
+    float wavePosition = getParameterValue("WAVE_POSITION");
 
-            // Filtro
-            voice->setFilterParameters(filterCutoff, filterTypeStr);
-        }
+    // Leer parámetros ADSR
+    float attack = getParameterValue("ATTACK");
+    float decay = getParameterValue("DECAY");
+    float sustain = getParameterValue("SUSTAIN");
+    float release = getParameterValue("RELEASE");
+
+    // Leer parámetros del filtro (el índice sigue el orden de FILTER_TYPE)
+    int filterTypeIndex = static_cast<int>(getParameterValue("FILTER_TYPE"));
+    RCFilterType filterType = filterTypeIndex == 0 ? RCFilterType::Lowpass : filterTypeIndex == 1 ? RCFilterType::Highpass
+                                                                                                  : RCFilterType::Bandpass;
+    float filterCutoff = getParameterValue("FILTER_CUTOFF");
+    bool paraphonic = getParameterValue("FILTER_MODE") > 0.5f;
+    bool sustainCache = getParameterValue("SUSTAIN_CACHE") > 0.5f;
+
+    synth.setParaphonicFilter(paraphonic);
+    synth.setSharedFilterParameters(filterType, filterCutoff);
+
+    // Modulación de altura: bend, glide y vibrato
+    float bendRange = getParameterValue("BEND_RANGE");
+    float glide = getParameterValue("GLIDE");
+    float vibratoRate = getParameterValue("VIBRATO_RATE");
+    float vibratoDepth = getParameterValue("VIBRATO_DEPTH");
+
+    // Propagar parámetros a todas las voces (sin el lock ni el dynamic_cast del Synthesiser)
+    for (auto *voice : voiceList)
+    {
+        // Oscillator
+        voice->setWaveType(waveIndex);
+        voice->setAmplitude(velocity);
+        voice->setPulseWidth(pulseWidth);
+        voice->setLayers(layerMode, layers);
+        voice->setFM(fmMode, fmAlgorithm, operators, fmModDecay, fmModSustain);
+        voice->setAdditive(additiveMode, additive);
+        voice->setUserWavetableMode(userWavetableMode, wavePosition);
+
+        // ADSR
+        voice->setEnvelopeParameters(attack, decay, sustain, release);
+
+        // Filtro
+        voice->setFilterParameters(filterCutoff, filterType);
+        voice->setFilterEnabled(!paraphonic);
+
+        // Altura
+        voice->setPitchModulation(bendRange, glide, vibratoRate, vibratoDepth);
+
+        // Caché de sustain
+        voice->setSustainCacheEnabled(sustainCache);
+
+        // Calidad (QualityGovernor)
+        voice->setLinearInterpolation(qualityLevel->linearInterpolation);
     }
+}
+
+//==============================================================================
+// AFINACIÓN
+bool AudioPluginAudioProcessor::loadTuningFile(const juce::File &file, juce::String *errorMessage)
+{
+    return tuning.loadScala(file, errorMessage);
+}
+
+void AudioPluginAudioProcessor::resetTuning()
+{
+    tuning.resetToEqualTemperament();
 }
\ No newline at end of file
@@ -2,8 +2,19 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "SynthVoice.h"
+#include "SynthEngine.h"
+#include "DSP/PolyphaseResampler.h"
+#include "Performance/CpuLoadMeter.h"
+#include "Performance/MemoryUsage.h"
+#include "Performance/QualityGovernor.h"
+#include "Performance/VoiceTelemetry.h"
+#include "State/ParameterSnapshot.h"
+#include "State/PresetLibrary.h"
+#include "Tuning/TuningTable.h"
+#include "Visualizer/ScopeFifo.h"
 
-class AudioPluginAudioProcessor final : public juce::AudioProcessor
+class AudioPluginAudioProcessor final : public juce::AudioProcessor,
+                                        private juce::Timer
 {
 public:
     AudioPluginAudioProcessor();
@@ -32,26 +43,282 @@ public:
     const juce::String getProgramName(int index) override;
     void changeProgramName(int index, const juce::String &newName) override;
 
+    /**
+     * @brief Saves the current parameters as a new user preset and selects it.
+     * @param name Preset name.
+     * @return True if the user bank was written (PresetLibrary::saveUserPreset()).
+     *
+     * Message thread only.
+     */
+    bool saveCurrentAsPreset(const juce::String &name);
+
     void getStateInformation(juce::MemoryBlock &destData) override;
     void setStateInformation(const void *data, int sizeInBytes) override;
 
     /** @brief Aplica parámetros actuales del APVTS a todas las voces. */
     void updateVoicesParameters();
 
+    /**
+     * @brief Builds a waveform's oscillator in every voice (generates its tables).
+     * @param waveIndex Waveform index (0 = Sine, 1 = Saw, 2 = Square, 3 = Triangle).
+     *
+     * Never call from the audio thread. Waveforms selected while playing are
+     * built automatically on a background thread.
+     */
+    void materializeWave(int waveIndex);
+
     /** Exposición pública del APVTS para attachments en la GUI */
     juce::AudioProcessorValueTreeState apvts;
 
     // Exponer el estado del teclado a la GUI
     juce::MidiKeyboardState &getKeyboardState() { return keyboardState; }
 
+    /**
+     * @brief Returns the per-block CPU load statistics of processBlock.
+     *
+     * Safe to call from any thread (GUI timer, host, offline tools).
+     */
+    CpuLoadMeter::Snapshot getCpuLoadSnapshot() const { return cpuLoadMeter.getSnapshot(); }
+
+    /** @brief Clears the CPU load statistics (peak, percentiles, xruns). */
+    void resetCpuLoadStatistics() { cpuLoadMeter.reset(); }
+
+    /**
+     * @brief Gives access to the adaptive quality governor (thresholds, enable).
+     *
+     * The governor is switched on/off by the GOVERNOR parameter; its thresholds
+     * can be tuned through QualityGovernor::setConfig().
+     */
+    QualityGovernor &getQualityGovernor() { return qualityGovernor; }
+
+    /** @brief Returns the governor's current level and counters. */
+    QualityGovernor::Status getQualityGovernorStatus() const { return qualityGovernor.getStatus(); }
+
+    /**
+     * @brief Returns the voice activity counters: polyphony, steals, envelope
+     *        stage times and note-on to onset delay.
+     *
+     * Safe to call from any thread (GUI timer, host, offline tools).
+     */
+    VoiceTelemetry::Snapshot getVoiceTelemetrySnapshot() const { return voiceTelemetry.getSnapshot(); }
+
+    /** @brief Clears the voice activity counters. */
+    void resetVoiceTelemetry() { voiceTelemetry.reset(); }
+
+    /**
+     * @brief Output samples for the scope / spectrum display.
+     *
+     * Written by processBlock, read by the GUI's AnalyzerComponent.
+     */
+    ScopeFifo &getScopeFifo() { return scopeFifo; }
+
+    /**
+     * @brief Replaces the note → frequency table with a Scala (.scl) scale.
+     * @param file Scale file.
+     * @param errorMessage Optional; receives the parse error on failure.
+     * @return True if the tuning was loaded. Notes already sounding keep their pitch.
+     *
+     * Message thread only. The scale is stored with the plugin state.
+     */
+    bool loadTuningFile(const juce::File &file, juce::String *errorMessage = nullptr);
+
+    /** @brief Returns to 12-TET (A4 = 440 Hz). */
+    void resetTuning();
+
+    /** @brief Current tuning (description, frequencies). */
+    const TuningTable &getTuning() const { return tuning; }
+
+    /**
+     * @brief Imports a multi-frame wavetable for OSC_MODE "Wavetable".
+     * @param file WAV file, 2048 samples per frame, up to 256 frames.
+     * @param errorMessage Optional; receives the read error on failure.
+     * @return True if the file was read. Its mip-maps are then mapped from the
+     *         cache, or generated and cached, on a background thread, and the
+     *         voices switch to the table when it is ready.
+     *
+     * Message thread only. The file path and the hash of its frames are
+     * stored with the plugin state; restoring maps the cached mip-maps
+     * without reading the WAV again.
+     */
+    bool loadWavetableFile(const juce::File &file, juce::String *errorMessage = nullptr);
+
+    /** @brief Imported wavetable, as shown by the GUI. */
+    struct WavetableStatus
+    {
+        juce::String name;    ///< File name, empty if none was imported.
+        int numFrames = 0;    ///< Frames of the table playing; 0 if the file and its cache are missing.
+        bool mapped = false;  ///< Tables read from the memory-mapped cache.
+        bool loading = false; ///< Mip-maps being mapped or generated.
+    };
+
+    /** @brief Current imported wavetable. Message thread. */
+    WavetableStatus getWavetableStatus() const;
+
+    /**
+     * @brief True while a built-in waveform is queued for building in the background.
+     *
+     * Restoring a state queues the waveforms it selects; a tool that renders
+     * without a message loop waits for this to clear before its first block.
+     */
+    bool hasPendingWaveBuilds() const { return wavesInFlight.load() != 0; }
+
+    /**
+     * @brief Bytes held by this instance per subsystem, and the peak total so far.
+     *
+     * Covers wavetables (per waveform and bank, all voices), filter banks,
+     * voice objects, scratch buffers and tuning tables. Walks the voices, so
+     * call it from the message thread or a tool, never from processBlock.
+     * The peak is also sampled after prepareToPlay and after each waveform
+     * is built, not only when this is called.
+     */
+    MemoryUsage getMemoryUsage() const;
+
+    /**
+     * @brief Rate the voices run at.
+     *
+     * Equals the host rate unless ENGINE_RATE selects a fixed rate (44.1 or
+     * 48 kHz); then the engine output is resampled to the host rate and the
+     * converter delay is reported through getLatencySamples().
+     */
+    double getEngineSampleRate() const { return engineSampleRate; }
+
 private:
+    /**
+     * @brief Revisa si alguna voz pidió una forma de onda sin construir y
+     *        encola su construcción en segundo plano.
+     */
+    void timerCallback() override;
+
+    /** @brief Encola la construcción de una forma de onda en wavetableBuilder. */
+    void requestWaveMaterialization(int waveIndex);
+
+    /** @brief Formas de onda que suenan con los parámetros actuales: WAVE y, en modo capas, las capas audibles (bit por índice). */
+    uint32_t getSelectedWaves() const;
+
+    /** @brief Construye las formas de onda seleccionadas (prepareToPlay, antes de sonar). */
+    void materializeSelectedWaves();
+
+    /** @brief Encola las formas de onda seleccionadas en wavetableBuilder (restauración de estado). */
+    void requestSelectedWaves();
+
+    /** @brief Vuelve a la wavetable de un estado guardado (hash 0 = ninguna). */
+    void restoreWavetable(const juce::File &file, uint64_t hash);
+
+    /**
+     * @brief Encola la carga de una wavetable importada en wavetableBuilder.
+     *
+     * Mapea los mip-maps de la caché si están; si no, los genera desde frames
+     * (o, vacío, desde el WAV) y los guarda en la caché.
+     */
+    void requestWavetableBuild(const juce::File &file, uint64_t hash, std::vector<float> frames);
+
+    /** @brief Pasa una wavetable a las voces con el audio detenido (callback lock) y libera la anterior. */
+    void installUserWavetable(std::unique_ptr<const UserWavetable> table);
+
+    /**
+     * @brief Lee un parámetro para el motor (hilo de audio).
+     *
+     * Durante un cambio de programa devuelve el valor del snapshot del preset,
+     * de modo que todos los parámetros cambian juntos en el mismo bloque.
+     */
+    float getParameterValue(const char *parameterID) const;
+
+    /**
+     * @brief Prepara voces, afinación y resampler a la frecuencia del motor.
+     *
+     * La frecuencia sale de ENGINE_RATE; llamar con el audio detenido
+     * (prepareToPlay, o timerCallback con suspendProcessing).
+     */
+    void prepareEngine();
+
+    /** @brief Renderiza a engineSampleRate y remuestrea a la frecuencia del host. */
+    void renderResampled(juce::AudioBuffer<float> &buffer, const juce::MidiBuffer &midi);
+
     /** @brief Construye el layout de parámetros del APVTS. */
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    juce::Synthesiser synth;
+    /** @brief Sintetizador con límite de polifonía ajustable en tiempo real. */
+    SynthEngine synth;
 
     // NUEVO: estado del teclado virtual
     juce::MidiKeyboardState keyboardState;
 
+    /** @brief Tiempo de cada processBlock relativo a su presupuesto en tiempo real. */
+    CpuLoadMeter cpuLoadMeter;
+
+    /** @brief Polifonía, robos, tiempo por etapa del envelope y retardo hasta el sonido. */
+    VoiceTelemetry voiceTelemetry;
+
+    /** @brief Salida hacia el osciloscopio/analizador de la GUI (SPSC, sin locks). */
+    ScopeFifo scopeFifo;
+
+    /** @brief Baja/sube el costo del motor según la carga medida. */
+    QualityGovernor qualityGovernor;
+
+    /** @brief Nivel de calidad con el que se renderiza el bloque actual. */
+    const QualityGovernor::Level *qualityLevel = &QualityGovernor::getLevels()[0];
+
+    /** @brief Presets de fábrica + banco del usuario, parseados al construir. */
+    PresetLibrary presetLibrary;
+    int currentProgram = 0;
+
+    /** @brief Preset publicado por setCurrentProgram para el hilo de audio. */
+    std::atomic<const ParameterSnapshot *> programOverride{nullptr};
+
+    /** @brief True cuando el APVTS ya refleja el preset de programOverride. */
+    std::atomic<bool> programInSync{true};
+
+    /** @brief Snapshot usado en el bloque actual (solo hilo de audio). */
+    const ParameterSnapshot *activeProgram = nullptr;
+
+    /** @brief Tabla nota → frecuencia/incremento de fase compartida por las voces. */
+    TuningTable tuning;
+
+    /** @brief Frecuencia y tamaño de bloque recibidos en prepareToPlay (0 = sin preparar). */
+    double hostSampleRate = 44100.0;
+    int hostBlockSize = 0;
+
+    /** @brief Frecuencia del motor; distinta de hostSampleRate solo con ENGINE_RATE fijo. */
+    double engineSampleRate = 44100.0;
+    bool engineResampling = false;
+    int engineRateChoice = 0;
+
+    /** @brief Convierte la salida del motor a la frecuencia del host. */
+    PolyphaseResampler resampler;
+
+    /** @brief Bloque mono a la frecuencia del motor y sus eventos MIDI. */
+    juce::AudioBuffer<float> engineBuffer;
+    juce::MidiBuffer engineMidi;
+
+    /** @brief Voces creadas en el constructor (acceso sin el lock del Synthesiser). */
+    std::vector<SynthVoice *> voiceList;
+
+    /** @brief Wavetables compartidas por todas las voces; se crean en prepareEngine() al conocer la frecuencia. */
+    std::shared_ptr<WavetableSet> wavetables;
+
+    /** @brief Mayor total de getMemoryUsage() visto por esta instancia. */
+    mutable std::atomic<size_t> peakMemoryBytes{0};
+
+    /** @brief Evita leer los bancos del filtro mientras prepareToPlay los regenera. */
+    mutable juce::CriticalSection memoryLock;
+
+    /** @brief Wavetable importada que leen todas las voces (nullptr = ninguna). */
+    std::unique_ptr<const UserWavetable> userWavetable;
+
+    /** @brief Archivo y hash de la última wavetable pedida (se guardan en el estado). */
+    juce::File userWavetableFile;
+    uint64_t userWavetableHash = 0;
+    mutable juce::CriticalSection wavetableLock;
+
+    /** @brief Solo la carga más reciente se instala; las anteriores se descartan. */
+    std::atomic<int> wavetableGeneration{0};
+    std::atomic<int> wavetableBuildsPending{0};
+
+    /** @brief Formas de onda con construcción encolada (bit por índice). */
+    std::atomic<uint32_t> wavesInFlight{0};
+
+    /** @brief Hilo que genera las wavetables fuera del hilo de audio. Debe destruirse antes que synth. */
+    juce::ThreadPool wavetableBuilder{1};
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessor)
 };
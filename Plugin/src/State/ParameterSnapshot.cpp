@@ -0,0 +1,112 @@
+#include "ParameterSnapshot.h"
+#include <algorithm>
+#include <cstring>
+
+ParameterSnapshot::ParameterSnapshot(const juce::String &presetName,
+                                     std::initializer_list<std::pair<const char *, float>> values)
+    : name(presetName)
+{
+    entries.reserve(values.size());
+    for (const auto &v : values)
+        entries.push_back({hashParameterID(v.first), v.second});
+}
+
+ParameterSnapshot ParameterSnapshot::capture(const juce::AudioProcessorValueTreeState &apvts,
+                                             const juce::String &presetName)
+{
+    ParameterSnapshot s;
+    s.name = presetName;
+
+    for (auto *p : apvts.processor.getParameters())
+        if (auto *ranged = dynamic_cast<juce::RangedAudioParameter *>(p))
+            s.entries.push_back({hashParameterID(ranged->paramID.toRawUTF8()),
+                                 ranged->convertFrom0to1(ranged->getValue())});
+
+    return s;
+}
+
+void ParameterSnapshot::applyTo(juce::AudioProcessorValueTreeState &apvts) const
+{
+    for (auto *p : apvts.processor.getParameters())
+    {
+        auto *ranged = dynamic_cast<juce::RangedAudioParameter *>(p);
+        if (ranged == nullptr)
+            continue;
+
+        const uint32_t h = hashParameterID(ranged->paramID.toRawUTF8());
+        const auto stored = std::find_if(entries.begin(), entries.end(), [h](const Entry &e)
+                                         { return e.idHash == h; });
+
+        if (stored != entries.end())
+            ranged->setValueNotifyingHost(ranged->convertTo0to1(stored->value));
+        else if (ranged->isAutomatable())
+            ranged->setValueNotifyingHost(ranged->getDefaultValue());
+    }
+}
+
+float ParameterSnapshot::getMissingValue(const juce::RangedAudioParameter &parameter, float currentValue) noexcept
+{
+    return parameter.isAutomatable() ? parameter.convertFrom0to1(parameter.getDefaultValue()) : currentValue;
+}
+
+float ParameterSnapshot::getValue(const char *parameterID, float fallback) const noexcept
+{
+    const uint32_t h = hashParameterID(parameterID);
+    for (const auto &e : entries)
+        if (e.idHash == h)
+            return e.value;
+    return fallback;
+}
+
+size_t ParameterSnapshot::getSerializedSize() const noexcept
+{
+    return 8 + entries.size() * 8;
+}
+
+void ParameterSnapshot::writeTo(juce::OutputStream &out) const
+{
+    out.writeInt(int(magic));
+    out.writeShort(short(currentVersion));
+    out.writeShort(short(entries.size()));
+
+    for (const auto &e : entries)
+    {
+        out.writeInt(int(e.idHash));
+        out.writeFloat(e.value);
+    }
+}
+
+bool ParameterSnapshot::readFrom(const void *data, size_t size, ParameterSnapshot &result,
+                                 size_t *bytesRead)
+{
+    auto *bytes = static_cast<const uint8_t *>(data);
+
+    if (data == nullptr || size < 8 || juce::ByteOrder::littleEndianInt(bytes) != magic)
+        return false;
+
+    const uint16_t version = juce::ByteOrder::littleEndianShort(bytes + 4);
+    const uint16_t numEntries = juce::ByteOrder::littleEndianShort(bytes + 6);
+
+    // Versions only ever append fields, so newer data is rejected rather than misread
+    if (version == 0 || version > currentVersion)
+        return false;
+
+    const size_t needed = 8 + size_t(numEntries) * 8;
+    if (size < needed)
+        return false;
+
+    result.entries.resize(numEntries);
+    for (size_t i = 0; i < numEntries; ++i)
+    {
+        const uint8_t *p = bytes + 8 + i * 8;
+        const uint32_t rawValue = juce::ByteOrder::littleEndianInt(p + 4);
+
+        result.entries[i].idHash = juce::ByteOrder::littleEndianInt(p);
+        std::memcpy(&result.entries[i].value, &rawValue, sizeof(float));
+    }
+
+    if (bytesRead != nullptr)
+        *bytesRead = needed;
+
+    return true;
+}
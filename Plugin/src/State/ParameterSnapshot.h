@@ -0,0 +1,113 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+/**
+ * @class ParameterSnapshot
+ * @brief Immutable set of parameter values, used for plugin state and presets.
+ *
+ * Each entry pairs the 32-bit FNV-1a hash of a parameter ID with its plain
+ * (denormalised) value. Hashing keeps the binary form small and makes it
+ * robust to parameters being added or reordered: unknown hashes are ignored
+ * and missing ones go back to their default (getMissingValue()), so a
+ * partial preset or an old state always gives the same sound.
+ *
+ * Binary layout (little endian):
+ * @code
+ * uint32  magic      'TECS'
+ * uint16  version    (currentVersion)
+ * uint16  numEntries
+ * numEntries × { uint32 idHash; float32 plainValue; }
+ * @endcode
+ */
+class ParameterSnapshot
+{
+public:
+    /** @brief One parameter value. */
+    struct Entry
+    {
+        uint32_t idHash;
+        float value;
+    };
+
+    static constexpr uint32_t magic = 0x53434554; // "TECS"
+    static constexpr uint16_t currentVersion = 1;
+
+    ParameterSnapshot() = default;
+
+    /**
+     * @brief Builds a snapshot from (parameter ID, plain value) pairs.
+     * @param presetName Display name.
+     * @param values Parameter IDs and values.
+     */
+    ParameterSnapshot(const juce::String &presetName,
+                      std::initializer_list<std::pair<const char *, float>> values);
+
+    /** @brief 32-bit FNV-1a hash of a parameter ID. */
+    static constexpr uint32_t hashParameterID(const char *id)
+    {
+        uint32_t h = 2166136261u;
+        while (*id != 0)
+        {
+            h ^= uint32_t(uint8_t(*id++));
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    /**
+     * @brief Captures the current value of every parameter of the tree.
+     * @param apvts Parameter tree to read.
+     * @param presetName Name stored in the snapshot.
+     */
+    static ParameterSnapshot capture(const juce::AudioProcessorValueTreeState &apvts,
+                                     const juce::String &presetName = {});
+
+    /**
+     * @brief Sets every parameter of the tree to the stored value, or to getMissingValue().
+     *
+     * Notifies the host. Message thread only.
+     */
+    void applyTo(juce::AudioProcessorValueTreeState &apvts) const;
+
+    /**
+     * @brief Plain value of a parameter the snapshot does not store.
+     * @param parameter Parameter of the tree.
+     * @param currentValue Its current plain value.
+     * @return The parameter's default, or currentValue for settings the host
+     *         cannot automate (ENGINE_RATE), which are not part of a sound.
+     *
+     * Does not allocate; safe on the audio thread.
+     */
+    static float getMissingValue(const juce::RangedAudioParameter &parameter, float currentValue) noexcept;
+
+    /**
+     * @brief Looks up a value by parameter ID.
+     * @return The stored value, or fallback if the parameter is not in the snapshot.
+     *
+     * Does not allocate; safe on the audio thread.
+     */
+    float getValue(const char *parameterID, float fallback) const noexcept;
+
+    /** @brief Appends the binary form of the snapshot to a stream. */
+    void writeTo(juce::OutputStream &out) const;
+
+    /** @brief Number of bytes writeTo() produces. */
+    size_t getSerializedSize() const noexcept;
+
+    /**
+     * @brief Parses a snapshot from memory.
+     * @param data Start of the binary form.
+     * @param size Bytes available.
+     * @param bytesRead Receives the number of bytes consumed on success (optional).
+     * @return True if a valid snapshot was parsed into result.
+     */
+    static bool readFrom(const void *data, size_t size, ParameterSnapshot &result,
+                         size_t *bytesRead = nullptr);
+
+    juce::String name;          ///< Display name (presets only).
+    std::vector<Entry> entries; ///< Parameter values.
+};
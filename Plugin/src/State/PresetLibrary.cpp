@@ -0,0 +1,121 @@
+#include "PresetLibrary.h"
+
+PresetLibrary::PresetLibrary()
+{
+    addFactoryPresets();
+    loadBank(getDefaultBankFile());
+}
+
+void PresetLibrary::addFactoryPresets()
+{
+    // WAVE: 0 = Sine, 1 = Saw, 2 = Square, 3 = Triangle
+    // FILTER_TYPE: 0 = Lowpass, 1 = Highpass, 2 = Bandpass
+    const ParameterSnapshot factory[] = {
+        {"Init", {{"WAVE", 0.0f}, {"VELOCITY", 1.0f}, {"ATTACK", 0.01f}, {"DECAY", 0.10f}, {"SUSTAIN", 0.80f}, {"RELEASE", 0.20f}, {"FILTER_TYPE", 0.0f}, {"FILTER_CUTOFF", 1000.0f}}},
+        {"Soft Pad", {{"WAVE", 3.0f}, {"VELOCITY", 0.8f}, {"ATTACK", 0.80f}, {"DECAY", 1.00f}, {"SUSTAIN", 0.70f}, {"RELEASE", 1.50f}, {"FILTER_TYPE", 0.0f}, {"FILTER_CUTOFF", 2500.0f}}},
+        {"Pluck Bass", {{"WAVE", 1.0f}, {"VELOCITY", 1.0f}, {"ATTACK", 0.002f}, {"DECAY", 0.25f}, {"SUSTAIN", 0.0f}, {"RELEASE", 0.15f}, {"FILTER_TYPE", 0.0f}, {"FILTER_CUTOFF", 800.0f}}},
+        {"Bright Lead", {{"WAVE", 1.0f}, {"VELOCITY", 0.9f}, {"ATTACK", 0.005f}, {"DECAY", 0.20f}, {"SUSTAIN", 0.80f}, {"RELEASE", 0.25f}, {"FILTER_TYPE", 1.0f}, {"FILTER_CUTOFF", 200.0f}}},
+        {"Hollow Square", {{"WAVE", 2.0f}, {"VELOCITY", 0.8f}, {"ATTACK", 0.02f}, {"DECAY", 0.30f}, {"SUSTAIN", 0.60f}, {"RELEASE", 0.40f}, {"FILTER_TYPE", 2.0f}, {"FILTER_CUTOFF", 1200.0f}}},
+        {"Organ", {{"WAVE", 0.0f}, {"VELOCITY", 0.9f}, {"ATTACK", 0.005f}, {"DECAY", 0.05f}, {"SUSTAIN", 1.00f}, {"RELEASE", 0.05f}, {"FILTER_TYPE", 0.0f}, {"FILTER_CUTOFF", 8000.0f}}},
+    };
+
+    for (const auto &preset : factory)
+        presets.push_back(std::make_unique<const ParameterSnapshot>(preset));
+    numFactoryPresets = presets.size();
+}
+
+juce::File PresetLibrary::getDefaultBankFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("TECSynth")
+        .getChildFile("Presets.tecbank");
+}
+
+int PresetLibrary::loadBank(const juce::File &bankFile)
+{
+    if (!bankFile.existsAsFile())
+        return 0;
+
+    juce::MemoryMappedFile mapped(bankFile, juce::MemoryMappedFile::readOnly);
+    auto *bytes = static_cast<const uint8_t *>(mapped.getData());
+    const size_t size = mapped.getSize();
+
+    if (bytes == nullptr || size < 8 || juce::ByteOrder::littleEndianInt(bytes) != bankMagic)
+        return 0;
+
+    const uint16_t version = juce::ByteOrder::littleEndianShort(bytes + 4);
+    const uint16_t numPresets = juce::ByteOrder::littleEndianShort(bytes + 6);
+    if (version == 0 || version > bankVersion)
+        return 0;
+
+    // Parse everything first so a truncated bank adds nothing
+    std::vector<std::unique_ptr<const ParameterSnapshot>> parsed;
+    parsed.reserve(numPresets);
+
+    size_t offset = 8;
+    for (int i = 0; i < numPresets; ++i)
+    {
+        if (offset + 2 > size)
+            return 0;
+
+        const size_t nameBytes = juce::ByteOrder::littleEndianShort(bytes + offset);
+        offset += 2;
+        if (offset + nameBytes > size)
+            return 0;
+
+        auto snapshot = std::make_unique<ParameterSnapshot>();
+        snapshot->name = juce::String::fromUTF8(reinterpret_cast<const char *>(bytes + offset), int(nameBytes));
+        offset += nameBytes;
+
+        size_t used = 0;
+        if (!ParameterSnapshot::readFrom(bytes + offset, size - offset, *snapshot, &used))
+            return 0;
+        offset += used;
+
+        parsed.push_back(std::move(snapshot));
+    }
+
+    for (auto &p : parsed)
+        presets.push_back(std::move(p));
+
+    return int(parsed.size());
+}
+
+bool PresetLibrary::saveBank(const juce::File &bankFile,
+                             const std::vector<const ParameterSnapshot *> &presetsToSave)
+{
+    juce::MemoryOutputStream out;
+    out.writeInt(int(bankMagic));
+    out.writeShort(short(bankVersion));
+    out.writeShort(short(presetsToSave.size()));
+
+    for (const auto *preset : presetsToSave)
+    {
+        const size_t nameBytes = preset->name.getNumBytesAsUTF8();
+        out.writeShort(short(nameBytes));
+        out.write(preset->name.toRawUTF8(), nameBytes);
+        preset->writeTo(out);
+    }
+
+    bankFile.getParentDirectory().createDirectory();
+    return bankFile.replaceWithData(out.getData(), out.getDataSize());
+}
+
+int PresetLibrary::saveUserPreset(const ParameterSnapshot &preset)
+{
+    std::vector<const ParameterSnapshot *> userPresets;
+    for (size_t i = numFactoryPresets; i < presets.size(); ++i)
+        userPresets.push_back(presets[i].get());
+    userPresets.push_back(&preset);
+
+    if (!saveBank(getDefaultBankFile(), userPresets))
+        return -1;
+
+    presets.push_back(std::make_unique<const ParameterSnapshot>(preset));
+    return getNumPresets() - 1;
+}
+
+const ParameterSnapshot *PresetLibrary::getPreset(int index) const noexcept
+{
+    return juce::isPositiveAndBelow(index, getNumPresets()) ? presets[size_t(index)].get() : nullptr;
+}
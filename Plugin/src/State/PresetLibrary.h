@@ -0,0 +1,82 @@
+#pragma once
+#include <JuceHeader.h>
+#include "ParameterSnapshot.h"
+#include <memory>
+#include <vector>
+
+/**
+ * @class PresetLibrary
+ * @brief List of presets, parsed once into immutable ParameterSnapshots.
+ *
+ * The library starts with the factory presets compiled into the plugin and can
+ * append the presets of a bank file, or a preset saved by the user (which is
+ * written to the user bank). Bank files are memory-mapped and parsed in one
+ * pass when loaded; after that, switching presets never touches the disk or
+ * allocates, it only hands out pointers to existing snapshots.
+ *
+ * Factory presets only store the parameters that define them; the others
+ * take their default when the preset is applied (ParameterSnapshot::applyTo()).
+ *
+ * Presets are never removed, so pointers returned by getPreset() stay valid
+ * for the lifetime of the library (the audio thread may hold one).
+ *
+ * Bank layout (little endian):
+ * @code
+ * uint32  magic     'TECB'
+ * uint16  version   (bankVersion)
+ * uint16  numPresets
+ * numPresets × { uint16 nameBytes; char name[nameBytes] (UTF-8); ParameterSnapshot }
+ * @endcode
+ */
+class PresetLibrary
+{
+public:
+    static constexpr uint32_t bankMagic = 0x42434554; // "TECB"
+    static constexpr uint16_t bankVersion = 1;
+
+    /** @brief Creates the library with the factory presets. */
+    PresetLibrary();
+
+    /** @brief Location of the user bank loaded at startup. */
+    static juce::File getDefaultBankFile();
+
+    /**
+     * @brief Appends the presets stored in a bank file.
+     * @param bankFile File written by saveBank().
+     * @return Number of presets added (0 if the file is missing or invalid).
+     *
+     * Message thread only.
+     */
+    int loadBank(const juce::File &bankFile);
+
+    /**
+     * @brief Writes presets to a bank file.
+     * @param bankFile Destination (overwritten).
+     * @param presetsToSave Presets to store, in order.
+     * @return True on success.
+     */
+    static bool saveBank(const juce::File &bankFile,
+                         const std::vector<const ParameterSnapshot *> &presetsToSave);
+
+    /**
+     * @brief Appends a preset and rewrites the user bank with every non-factory preset.
+     * @param preset Preset to add (typically ParameterSnapshot::capture()).
+     * @return Index of the new preset, or -1 if the bank could not be written
+     *         (the library is then unchanged).
+     *
+     * Message thread only.
+     */
+    int saveUserPreset(const ParameterSnapshot &preset);
+
+    /** @brief Number of presets (factory + loaded banks). */
+    int getNumPresets() const noexcept { return int(presets.size()); }
+
+    /** @brief Returns a preset, or nullptr if the index is out of range. */
+    const ParameterSnapshot *getPreset(int index) const noexcept;
+
+private:
+    void addFactoryPresets();
+
+    std::vector<std::unique_ptr<const ParameterSnapshot>> presets;
+    size_t numFactoryPresets = 0;
+};
@@ -0,0 +1,120 @@
+#include "SynthEngine.h"
+#include "SynthVoice.h"
+
+SynthVoice *SynthEngine::addVoice(SynthVoice *newVoice)
+{
+    juce::Synthesiser::addVoice(newVoice);
+    synthVoices.push_back(newVoice);
+    return newVoice;
+}
+
+void SynthEngine::clearVoices()
+{
+    synthVoices.clear();
+    juce::Synthesiser::clearVoices();
+}
+
+void SynthEngine::setMaxActiveVoices(int newMax) noexcept
+{
+    maxActiveVoices = juce::jlimit(1, juce::jmax(1, getNumVoices()), newMax);
+}
+
+int SynthEngine::getNumActiveVoices() const noexcept
+{
+    int count = 0;
+    for (auto *voice : voices)
+        if (voice->isVoiceActive())
+            ++count;
+    return count;
+}
+
+void SynthEngine::cullReleasingVoices() noexcept
+{
+    for (auto *voice : synthVoices)
+        if (voice->isPlayingButReleased())
+            voice->cullRelease();
+}
+
+void SynthEngine::reportVoiceActivity(VoiceTelemetry &telemetry) const noexcept
+{
+    int active = 0;
+    int inRelease = 0;
+    juce::int64 oldest = 0;
+
+    for (const auto *voice : synthVoices)
+    {
+        if (!voice->isVoiceActive())
+            continue;
+
+        ++active;
+        if (voice->getEnvelopeStage() == Envelope::Stage::Release)
+            ++inRelease;
+        oldest = juce::jmax(oldest, voice->getNoteAgeSamples());
+    }
+
+    telemetry.endBlock(active, inRelease, oldest);
+}
+
+void SynthEngine::setCurrentPlaybackSampleRate(double sampleRate)
+{
+    juce::Synthesiser::setCurrentPlaybackSampleRate(sampleRate);
+    sharedFilter.setSampleRate(sampleRate);
+    sharedFilter.reset();
+}
+
+void SynthEngine::setParaphonicFilter(bool enabled) noexcept
+{
+    if (enabled && !paraphonicFilter)
+        sharedFilter.reset();
+    paraphonicFilter = enabled;
+}
+
+void SynthEngine::setSharedFilterParameters(RCFilterType type, float cutoff) noexcept
+{
+    sharedFilter.setParameters(type, cutoff);
+}
+
+void SynthEngine::renderVoices(juce::AudioBuffer<float> &outputAudio, int startSample, int numSamples)
+{
+    juce::Synthesiser::renderVoices(outputAudio, startSample, numSamples);
+
+    if (!paraphonicFilter || outputAudio.getNumChannels() == 0)
+        return;
+
+    auto *mix = outputAudio.getWritePointer(0, startSample);
+    sharedFilter.processBlock(mix, numSamples);
+    for (int channel = 1; channel < outputAudio.getNumChannels(); ++channel)
+        juce::FloatVectorOperations::copy(outputAudio.getWritePointer(channel, startSample), mix, numSamples);
+}
+
+juce::SynthesiserVoice *SynthEngine::findFreeVoice(juce::SynthesiserSound *soundToPlay,
+                                                   int midiChannel,
+                                                   int midiNoteNumber,
+                                                   bool stealIfNoneAvailable) const
+{
+    if (getNumActiveVoices() < maxActiveVoices)
+        return juce::Synthesiser::findFreeVoice(soundToPlay, midiChannel, midiNoteNumber, stealIfNoneAvailable);
+
+    return stealIfNoneAvailable ? findVoiceToStealWithinCap(soundToPlay) : nullptr;
+}
+
+juce::SynthesiserVoice *SynthEngine::findVoiceToStealWithinCap(juce::SynthesiserSound *soundToPlay) const
+{
+    juce::SynthesiserVoice *oldestReleased = nullptr;
+    juce::SynthesiserVoice *oldest = nullptr;
+
+    for (auto *voice : voices)
+    {
+        if (!voice->isVoiceActive() || !voice->canPlaySound(soundToPlay))
+            continue;
+
+        if (oldest == nullptr || voice->wasStartedBefore(*oldest))
+            oldest = voice;
+
+        if (voice->isPlayingButReleased() &&
+            (oldestReleased == nullptr || voice->wasStartedBefore(*oldestReleased)))
+            oldestReleased = voice;
+    }
+
+    return oldestReleased != nullptr ? oldestReleased : oldest;
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include <JuceHeader.h>
+#include "Filter/VoiceFilter.h"
+#include "Performance/VoiceTelemetry.h"
+#include <vector>
+
+class SynthVoice;
+
+/**
+ * @class SynthEngine
+ * @brief juce::Synthesiser with a runtime polyphony cap and release-voice culling.
+ *
+ * The number of voice objects is fixed at construction (allocated once), but
+ * the number of voices allowed to sound at the same time can be lowered on the
+ * audio thread. When a note-on arrives and the cap is reached, a voice is
+ * stolen, preferring the oldest one already in release.
+ *
+ * Used by the processor to apply the QualityGovernor levels.
+ *
+ * In paraphonic filter mode the voices skip their own filters and the engine
+ * runs one shared filter on the voice mix instead. The filter is linear and
+ * its settings are global, so the result equals per-voice filtering except
+ * that notes no longer start from a reset filter state.
+ *
+ * Voices are added as SynthVoice through addVoice() below, which hides the
+ * juce::Synthesiser one and keeps the typed pointers, so the per-block walks
+ * need no dynamic_cast.
+ */
+class SynthEngine : public juce::Synthesiser
+{
+public:
+    SynthEngine() = default;
+
+    /**
+     * @brief Adds a voice (the engine owns it) and keeps its typed pointer.
+     * @return The voice, for the caller's own list.
+     */
+    SynthVoice *addVoice(SynthVoice *newVoice);
+
+    /** @brief Deletes every voice. */
+    void clearVoices();
+
+    /**
+     * @brief Sets how many voices may sound at once.
+     * @param newMax Polyphony cap; clamped to [1, getNumVoices()].
+     */
+    void setMaxActiveVoices(int newMax) noexcept;
+
+    /** @brief Returns the current polyphony cap. */
+    int getMaxActiveVoices() const noexcept { return maxActiveVoices; }
+
+    /** @brief Counts voices currently producing sound (including release tails). */
+    int getNumActiveVoices() const noexcept;
+
+    /**
+     * @brief Fades out every voice whose key has been released.
+     *
+     * Voices still held are left untouched.
+     */
+    void cullReleasingVoices() noexcept;
+
+    /**
+     * @brief Closes a telemetry block with the voice counts after rendering.
+     *
+     * Active voices, voices whose envelope is in Release and the age of the
+     * oldest active note. Audio thread.
+     */
+    void reportVoiceActivity(VoiceTelemetry &telemetry) const noexcept;
+
+    /**
+     * @brief Sets the sample rate, including the shared filter's banks.
+     *
+     * Regenerates filter banks (allocates): call from prepare, not from the
+     * audio thread.
+     */
+    void setCurrentPlaybackSampleRate(double sampleRate) override;
+
+    /**
+     * @brief Turns the paraphonic (shared) filter on or off.
+     *
+     * The voices' own filters must be disabled by the caller
+     * (SynthVoice::setFilterEnabled). Turning it on resets the shared filter.
+     */
+    void setParaphonicFilter(bool enabled) noexcept;
+
+    /** @brief Returns true if the voice mix goes through the shared filter. */
+    bool isParaphonicFilter() const noexcept { return paraphonicFilter; }
+
+    /** @brief Sets type and cutoff of the shared filter. */
+    void setSharedFilterParameters(RCFilterType type, float cutoff) noexcept;
+
+    /** @brief Shared filter (memory accounting). */
+    const VoiceFilter &getSharedFilter() const noexcept { return sharedFilter; }
+
+protected:
+    /**
+     * @brief Finds a voice for a new note, honouring the polyphony cap.
+     *
+     * Below the cap this behaves like juce::Synthesiser::findFreeVoice. At the
+     * cap it steals (if allowed) the oldest releasing voice, or else the oldest
+     * sounding voice.
+     */
+    juce::SynthesiserVoice *findFreeVoice(juce::SynthesiserSound *soundToPlay,
+                                          int midiChannel,
+                                          int midiNoteNumber,
+                                          bool stealIfNoneAvailable) const override;
+
+    /**
+     * @brief Renders the voices, then the shared filter in paraphonic mode.
+     *
+     * Voices write the same signal to every channel, so channel 0 is filtered
+     * and copied to the others. The region must start cleared, as
+     * processBlock leaves it.
+     */
+    void renderVoices(juce::AudioBuffer<float> &outputAudio, int startSample, int numSamples) override;
+
+private:
+    /** @brief Picks the voice to steal when the cap is reached. */
+    juce::SynthesiserVoice *findVoiceToStealWithinCap(juce::SynthesiserSound *soundToPlay) const;
+
+    std::vector<SynthVoice *> synthVoices; ///< Same voices as juce::Synthesiser::voices, typed.
+
+    int maxActiveVoices = 128;
+
+    bool paraphonicFilter = false;
+    VoiceFilter sharedFilter;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SynthEngine)
+};
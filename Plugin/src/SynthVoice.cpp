@@ -1,12 +1,16 @@
 #include "SynthVoice.h"
 #include "Filter/RCFilter.h"
+#include "Performance/Trace.h"
+#include "DSP/KernelDispatch.h"
 
 // Constructor
 SynthVoice::SynthVoice()
 {
-    oscillator.setSampleRate(44100.0); // default, luego se ajusta en prepareToPlay
+    // Las wavetables dependen del sample rate: no se construyen hasta prepare()
     env.setSampleRate(44100.0);
     voiceFilter.setSampleRate(44100.0); // inicializa el filtro con sample rate
+    fm.setSampleRate(44100.0);
+    additive.setSampleRate(44100.0);
 }
 
 // Verifica si puede reproducir un sonido
@@ -17,18 +21,76 @@ bool SynthVoice::canPlaySound(juce::SynthesiserSound *sound)
 
 // Nota activada
 void SynthVoice::startNote(int midiNoteNumber, float velocity,
-                           juce::SynthesiserSound * /*sound*/, int /*currentPitchWheelPosition*/)
+                           juce::SynthesiserSound * /*sound*/, int currentPitchWheelPosition)
 {
+    // Nota nueva: la caché de sustain se descarta (todo el estado se reinicia)
+    sustainLoop.reset();
+
+    // Una voz que todavía suena (o está en release) es una voz robada
+    const bool stolen = env.isActive();
+
     currentVelocity = velocity;
+    pitchWheelPosition = currentPitchWheelPosition;
 
-    oscillator.setNote(midiNoteNumber);
-    oscillator.setAmplitude(currentVelocity);
+    // Altura que la voz estaba sonando (punto de partida del glide)
+    const double previousFrequency = noteFrequency * currentRatio;
+
+    // Primero la forma de onda, para que la frecuencia vaya al oscilador activo
     oscillator.setWaveType(currentWaveIndex);
+    oscillator.setAmplitude(currentVelocity);
+
+    // Frecuencia precalculada en la tabla de afinación (sin pow en el note-on)
+    if (tuning != nullptr && midiNoteNumber >= 0 && midiNoteNumber < TuningTable::numNotes)
+    {
+        const auto &table = tuning->get();
+        oscillator.setNoteFrequency(table.frequency[size_t(midiNoteNumber)],
+                                    table.phaseDelta[size_t(midiNoteNumber)]);
+    }
+    else
+    {
+        oscillator.setNote(midiNoteNumber);
+    }
+    noteFrequency = oscillator.getFrequency();
+    notePhaseDelta = oscillator.getPhaseDelta();
+
+    // Fuente FM: misma altura, operadores desde fase 0
+    fm.setPhaseDelta(notePhaseDelta);
+    fm.setAmplitude(currentVelocity);
+    fm.noteOn();
+
+    // Fuente aditiva: misma altura, envelopes de los parciales desde el inicio
+    additive.setPhaseDelta(notePhaseDelta);
+    additive.setAmplitude(currentVelocity);
+    additive.noteOn();
+
+    // Wavetable importada: misma altura, fase 0
+    userWavetable.setPhaseDelta(notePhaseDelta);
+    userWavetable.setAmplitude(currentVelocity);
+    userWavetable.noteOn();
+
+    // Glide por voz: lineal en semitonos desde la altura anterior
+    glideOffset = 0.0f;
+    glideStep = 0.0f;
+    if (glideTime > 0.0f && previousFrequency > 0.0 && noteFrequency > 0.0)
+    {
+        glideOffset = float(12.0 * std::log2(previousFrequency / noteFrequency));
+        glideStep = glideOffset / float(glideTime * sampleRate);
+    }
+
+    // El vibrato arranca en fase 0; la razón parte del bend y el glide actuales
+    vibratoPhase = 0.0;
+    const float bend = float(pitchWheelPosition - 8192) / 8192.0f * bendRange;
+    currentRatio = std::exp2((bend + glideOffset) * (1.0f / 12.0f));
 
     // Reset de envelope y filtro para la nueva voz (requerido para polifonía)
     env.enterAttack();
     voiceFilter.reset();
 
+    noteAgeSamples = 0;
+    awaitingOnset = true;
+    if (telemetry != nullptr)
+        telemetry->addNote(stolen);
+
     isNoteActive = true;
 }
 
@@ -37,13 +99,24 @@ void SynthVoice::stopNote(float /*velocity*/, bool /*allowTailOff*/)
 {
     // Para polifonía nunca apagamos la voz inmediatamente
     // Iniciamos la fase de Release del envelope
+    leaveSustainCache();
     env.enterRelease();
+    fm.noteOff();
 }
 
 // Actualiza parámetros de ADSR
 void SynthVoice::setEnvelopeParameters(float a, float d, float s, float r)
 {
+    // En sustain solo el nivel cambia la salida
+    if (s != sustainLevel)
+        leaveSustainCache();
+    sustainLevel = s;
     env.setParameters(a, d, s, r);
+
+    // El envelope de los moduladores FM sigue al de amplitud en attack y release
+    attackTime = a;
+    releaseTime = r;
+    fm.setModulatorEnvelope(attackTime, fmModulatorDecay, fmModulatorSustain, releaseTime);
 }
 
 // Actualiza parámetros de filtro
@@ -57,11 +130,269 @@ void SynthVoice::setFilterParameters(float cutoff, const juce::String &type)
     else if (type == "bandpass")
         filterType = RCFilterType::Bandpass;
 
-    voiceFilter.setParameters(filterType, cutoff);
+    setFilterParameters(cutoff, filterType);
+}
+
+void SynthVoice::setFilterParameters(float cutoff, RCFilterType type)
+{
+    if (cutoff != filterCutoff || type != filterType)
+        leaveSustainCache();
+    filterCutoff = cutoff;
+    filterType = type;
+    voiceFilter.setParameters(type, cutoff);
+}
+
+// Modo parafónico: el filtro de la voz se salta (el motor filtra la mezcla)
+void SynthVoice::setFilterEnabled(bool shouldFilter)
+{
+    if (shouldFilter != filterEnabled)
+        leaveSustainCache();
+
+    // Al volver al filtro por voz no se arrastra un estado viejo
+    if (shouldFilter && !filterEnabled)
+        voiceFilter.reset();
+    filterEnabled = shouldFilter;
+}
+
+// Bend, glide y vibrato (parámetros del processor)
+void SynthVoice::setPitchModulation(float bendRangeSemitones, float glideSeconds,
+                                    float vibratoRateHz, float vibratoDepthSemitones)
+{
+    // Con la rueda centrada y sin vibrato el resto no cambia la altura sostenida
+    if (vibratoDepthSemitones != vibratoDepth)
+        leaveSustainCache();
+
+    bendRange = bendRangeSemitones;
+    glideTime = glideSeconds;
+    vibratoRate = vibratoRateHz;
+    vibratoDepth = vibratoDepthSemitones;
 }
 
-// Pitch wheel (no usado)
-void SynthVoice::pitchWheelMoved(int /*newPitchWheelValue*/) {}
+void SynthVoice::setPulseWidth(float width)
+{
+    if (width != pulseWidth)
+        leaveSustainCache();
+    pulseWidth = width;
+    oscillator.setPulseWidth(width);
+}
+
+// Modo capas: todas las formas de onda a la vez sobre la fase de la nota
+void SynthVoice::setLayers(bool shouldLayer,
+                           const std::array<OscillatorWrapper::LayerSettings, OscillatorWrapper::numWaveTypes> &settings)
+{
+    if (shouldLayer == layerMode && settings == layerSettings)
+        return;
+
+    leaveSustainCache();
+    layerMode = shouldLayer;
+    layerSettings = settings;
+
+    for (int wave = 0; wave < OscillatorWrapper::numWaveTypes; ++wave)
+        oscillator.setLayer(wave, layerSettings[size_t(wave)]);
+    oscillator.setLayerMode(layerMode);
+}
+
+// Fuente FM: algoritmo, operadores y envelope de los moduladores
+void SynthVoice::setFM(bool shouldUseFM, int algorithm,
+                       const std::array<FMOscillator::OperatorSettings, FMOscillator::numOperators> &operators,
+                       float modulatorDecay, float modulatorSustain)
+{
+    if (shouldUseFM == fmMode && algorithm == fmAlgorithm && operators == fmOperators &&
+        modulatorDecay == fmModulatorDecay && modulatorSustain == fmModulatorSustain)
+        return;
+
+    leaveSustainCache();
+    fmMode = shouldUseFM;
+    fmAlgorithm = algorithm;
+    fmOperators = operators;
+    fmModulatorDecay = modulatorDecay;
+    fmModulatorSustain = modulatorSustain;
+
+    fm.setAlgorithm(fmAlgorithm);
+    for (int k = 0; k < FMOscillator::numOperators; ++k)
+        fm.setOperator(k, fmOperators[size_t(k)]);
+    fm.setModulatorEnvelope(attackTime, fmModulatorDecay, fmModulatorSustain, releaseTime);
+}
+
+// Fuente aditiva: espectro y envelopes de los parciales
+void SynthVoice::setAdditive(bool shouldUseAdditive, const AdditiveOscillator::Settings &settings)
+{
+    if (shouldUseAdditive == additiveMode && settings == additiveSettings)
+        return;
+
+    leaveSustainCache();
+    additiveMode = shouldUseAdditive;
+    additiveSettings = settings;
+    additive.setSettings(additiveSettings);
+}
+
+// Wavetable importada: modo y posición del morph
+void SynthVoice::setUserWavetableMode(bool shouldUseWavetable, float position)
+{
+    if (shouldUseWavetable == userWavetableMode && position == wavePosition)
+        return;
+
+    leaveSustainCache();
+    userWavetableMode = shouldUseWavetable;
+    wavePosition = position;
+    userWavetable.setPosition(wavePosition);
+}
+
+// Tabla compartida (la posee el processor; se cambia con el audio detenido)
+void SynthVoice::setUserWavetable(const UserWavetable *table)
+{
+    leaveSustainCache();
+    userWavetable.setTable(table);
+}
+
+bool SynthVoice::isPitchModulated() const
+{
+    return pitchWheelPosition != 8192 || glideOffset != 0.0f || vibratoDepth > 0.0f || currentRatio != 1.0f;
+}
+
+// Razón de frecuencia por muestra: exp2/sin solo en los puntos de control,
+// interpolación lineal entre ellos
+void SynthVoice::computePitchRatios(float *ratio, int numSamples)
+{
+    const float bend = float(pitchWheelPosition - 8192) / 8192.0f * bendRange;
+    const double vibratoDelta = vibratoRate / sampleRate;
+
+    for (int i = 0; i < numSamples; i += pitchControlInterval)
+    {
+        const int n = std::min(pitchControlInterval, numSamples - i);
+
+        if (glideOffset != 0.0f)
+        {
+            const float next = glideOffset - glideStep * float(n);
+            glideOffset = next * glideOffset <= 0.0f ? 0.0f : next; // llegó a la nota
+        }
+
+        float vibrato = 0.0f;
+        if (vibratoDepth > 0.0f)
+        {
+            vibratoPhase += vibratoDelta * n;
+            vibratoPhase -= std::floor(vibratoPhase);
+            vibrato = vibratoDepth * std::sin(juce::MathConstants<float>::twoPi * float(vibratoPhase));
+        }
+
+        // Sin modulación exp2(0) == 1 exacto, y la voz vuelve al render sin modular
+        const float target = std::exp2((bend + glideOffset + vibrato) * (1.0f / 12.0f));
+        const float step = (target - currentRatio) / float(n);
+        for (int k = 0; k < n; ++k)
+            ratio[i + k] = currentRatio + step * float(k + 1);
+        currentRatio = target;
+    }
+}
+
+// Caché de sustain (parámetro SUSTAIN_CACHE)
+void SynthVoice::setSustainCacheEnabled(bool shouldCache)
+{
+    if (!shouldCache)
+        leaveSustainCache();
+    sustainCacheEnabled = shouldCache;
+}
+
+// Elige el largo del loop y desafina lo mínimo para que sea exactamente periódico
+void SynthVoice::beginSustainCapture()
+{
+    int cycles = 0;
+    const int length = SustainLoop::findLength(notePhaseDelta, cycles);
+
+    // Se rinde tras un segundo sin asentarse (p. ej. un filtro muy lento)
+    sustainLoop.beginCapture(length, int(sampleRate));
+    if (length == 0)
+        return;
+
+    const double loopDelta = double(cycles) / double(length);
+    oscillator.setNoteFrequency(noteFrequency * (loopDelta / notePhaseDelta), loopDelta);
+}
+
+// Estado al final del tramo que asentó el loop, con su posición en el loop
+void SynthVoice::snapshotSustainLoop()
+{
+    loopSnapshotPhase = oscillator.getPhase();
+    loopSnapshotFilter = voiceFilter.getState();
+    loopSnapshotPosition = sustainLoop.getPosition();
+}
+
+// Sale de la caché: reconstruye fase y filtro en la posición actual del loop
+void SynthVoice::leaveSustainCache()
+{
+    const auto state = sustainLoop.getState();
+
+    if (state == SustainLoop::State::Settled)
+    {
+        // Desde la instantánea se avanza hasta la posición actual (menos de un loop)
+        oscillator.setPhase(loopSnapshotPhase);
+        voiceFilter.setState(loopSnapshotFilter);
+
+        const int length = sustainLoop.getLength();
+        int ahead = (sustainLoop.getPosition() - loopSnapshotPosition + length) % length;
+        while (ahead > 0)
+        {
+            const int n = std::min(ahead, renderChunkSize);
+            oscillator.renderBlock(renderBuffer.data(), n);
+            applyEnvelopeAndFilter(renderBuffer.data(), n, nullptr); // ya contadas en el replay
+            ahead -= n;
+        }
+    }
+
+    if (state == SustainLoop::State::Capturing || state == SustainLoop::State::Settled)
+        oscillator.setNoteFrequency(noteFrequency, notePhaseDelta);
+
+    sustainLoop.reset();
+}
+
+// Tabla de afinación compartida (la posee el processor)
+void SynthVoice::setTuning(const TuningTable *table)
+{
+    tuning = table;
+}
+
+// Telemetría de voces (la posee el processor)
+void SynthVoice::setTelemetry(VoiceTelemetry *newTelemetry)
+{
+    telemetry = newTelemetry;
+}
+
+// Calidad de interpolación (QualityGovernor)
+void SynthVoice::setLinearInterpolation(bool shouldInterpolate)
+{
+    if (shouldInterpolate != linearInterpolation)
+        leaveSustainCache();
+    linearInterpolation = shouldInterpolate;
+    oscillator.setLinearInterpolation(shouldInterpolate);
+    userWavetable.setLinearInterpolation(shouldInterpolate);
+}
+
+// Fade-out rápido de una voz en release (QualityGovernor)
+void SynthVoice::cullRelease()
+{
+    leaveSustainCache();
+    env.enterFastRelease();
+}
+
+// Contabilidad de memoria (GUI / herramientas, nunca el hilo de audio)
+void SynthVoice::addMemoryUsage(MemoryUsage &usage) const
+{
+    const size_t scratch = sizeof(renderBuffer) + sizeof(pitchRatio) + fm.getScratchBytes() + userWavetable.getScratchBytes();
+    usage.voiceBytes += sizeof(SynthVoice) - scratch;
+    usage.scratchBytes += scratch;
+    usage.voiceBytes += additive.getMemoryBytes();
+
+    const auto &filter = voiceFilter.getFilter();
+    usage.lowpassBankBytes += filter.getLowpassBankBytes();
+    usage.highpassBankBytes += filter.getHighpassBankBytes();
+    usage.bandpassBankBytes += filter.getBandpassBankBytes();
+}
+
+// Pitch wheel: se aplica por muestra en renderNextBlock
+void SynthVoice::pitchWheelMoved(int newPitchWheelValue)
+{
+    if (newPitchWheelValue != pitchWheelPosition)
+        leaveSustainCache();
+    pitchWheelPosition = newPitchWheelValue;
+}
 
 // Controladores (no usados)
 void SynthVoice::controllerMoved(int /*controllerNumber*/, int /*newControllerValue*/) {}
@@ -70,6 +401,8 @@ void SynthVoice::controllerMoved(int /*controllerNumber*/, int /*newControllerVa
 void SynthVoice::renderNextBlock(juce::AudioBuffer<float> &outputBuffer,
                                  int startSample, int numSamples)
 {
+    TEC_TRACE_SCOPE("SynthVoice::renderNextBlock");
+
     // Si el envelope ya terminó, esta voz debe apagarse
     if (!env.isActive())
     {
@@ -80,37 +413,189 @@ void SynthVoice::renderNextBlock(juce::AudioBuffer<float> &outputBuffer,
     oscillator.setWaveType(currentWaveIndex);
     oscillator.setAmplitude(currentVelocity);
 
-    for (int sample = 0; sample < numSamples; ++sample)
+    // Se procesa por tramos del tamaño del buffer interno, etapa por etapa
+    // (oscilador → envelope → filtro), y luego se mezcla en la salida.
+    // Cada etapa es un kernel de bloque elegido por KernelDispatch según la CPU.
+    const auto &kernels = KernelDispatch::get();
+
+    // Caché de sustain: con todo estático la salida es periódica
+    // (no en modo capas, FM, aditivo ni wavetable: una capa desafinada no repite con el
+    // período de la nota, los envelopes de los moduladores FM y de los parciales pueden
+    // seguir en decay, y la captura solo reajusta la frecuencia del oscilador de forma de onda)
+    if (sustainCacheEnabled && sustainLoop.getState() == SustainLoop::State::Idle &&
+        env.getStage() == Envelope::Stage::Sustain && !isPitchModulated() && !layerMode && !fmMode &&
+        !additiveMode && !userWavetableMode && oscillator.getPendingWaveType() == -1)
+        beginSustainCapture();
+
+    while (numSamples > 0)
     {
-        float oscValue = oscillator.getNextSample();
-        float envValue = env.processSample();
-        float finalValue = oscValue * envValue;
+        // Loop asentado: se copia en vez de calcular las etapas
+        if (sustainLoop.getState() == SustainLoop::State::Settled)
+        {
+            TEC_TRACE_SCOPE("SustainLoop");
+            for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
+                sustainLoop.mixInto(outputBuffer.getWritePointer(channel, startSample), numSamples);
+            sustainLoop.advance(numSamples);
+            if (telemetry != nullptr)
+                telemetry->addStageSamples(Envelope::Stage::Sustain, numSamples);
+            noteAgeSamples += numSamples;
+            return;
+        }
+
+        const int chunkSize = std::min(numSamples, renderChunkSize);
+        float *chunk = renderBuffer.data();
+
+        {
+            TEC_TRACE_SCOPE("Oscillator");
+            if (isPitchModulated())
+            {
+                computePitchRatios(pitchRatio.data(), chunkSize);
+                if (fmMode)
+                    fm.renderBlockModulated(chunk, pitchRatio.data(), chunkSize);
+                else if (additiveMode)
+                    additive.renderBlockModulated(chunk, pitchRatio.data(), chunkSize);
+                else if (userWavetableMode)
+                    userWavetable.renderBlockModulated(chunk, pitchRatio.data(), chunkSize);
+                else
+                    oscillator.renderBlockModulated(chunk, pitchRatio.data(), chunkSize);
+            }
+            else if (fmMode)
+            {
+                fm.renderBlock(chunk, chunkSize);
+            }
+            else if (additiveMode)
+            {
+                additive.renderBlock(chunk, chunkSize);
+            }
+            else if (userWavetableMode)
+            {
+                userWavetable.renderBlock(chunk, chunkSize);
+            }
+            else
+            {
+                oscillator.renderBlock(chunk, chunkSize);
+            }
+        }
+
+        {
+            TEC_TRACE_SCOPE("Envelope+RCFilter");
+            applyEnvelopeAndFilter(chunk, chunkSize, telemetry);
+        }
 
-        // Aplicar filtro al sample generado
-        finalValue = voiceFilter.processSample(finalValue);
+        if (awaitingOnset)
+            detectOnset(chunk, chunkSize);
+
+        if (sustainLoop.getState() == SustainLoop::State::Capturing)
+        {
+            const auto state = sustainLoop.capture(chunk, chunkSize);
+            if (state == SustainLoop::State::Settled)
+                snapshotSustainLoop();
+            else if (state == SustainLoop::State::Failed)
+                oscillator.setNoteFrequency(noteFrequency, notePhaseDelta); // vuelve a la altura exacta
+        }
 
         for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
-            outputBuffer.addSample(channel, startSample + sample, finalValue);
+            kernels.mixInto(outputBuffer.getWritePointer(channel, startSample), chunk, chunkSize);
+
+        startSample += chunkSize;
+        numSamples -= chunkSize;
+        noteAgeSamples += chunkSize;
+    }
+}
+
+// Envelope y filtro en una pasada por segmento (kernel fusionado según el tipo)
+void SynthVoice::applyEnvelopeAndFilter(float *buffer, int numSamples, VoiceTelemetry *stageTelemetry)
+{
+    // Cada segmento pertenece a una sola etapa; el envelope avanza después de aplicarlo
+    auto countStage = [this, stageTelemetry](int n)
+    {
+        if (stageTelemetry != nullptr)
+            stageTelemetry->addStageSamples(env.getStage(), n);
+    };
+
+    if (filterEnabled)
+    {
+        env.processSegments(buffer, numSamples, [&](float *segment, int n, float start, float step)
+                            {
+                                countStage(n);
+                                voiceFilter.processRampedBlock(segment, n, start, step);
+                            });
+    }
+    else
+    {
+        const auto &kernels = KernelDispatch::get();
+        env.processSegments(buffer, numSamples, [&](float *segment, int n, float start, float step)
+                            {
+                                countStage(n);
+                                kernels.multiplyByRamp(segment, n, start, step);
+                            });
+    }
+}
+
+// Primera muestra audible de la nota (umbral de VoiceTelemetry)
+void SynthVoice::detectOnset(const float *chunk, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (std::abs(chunk[i]) >= VoiceTelemetry::onsetThreshold)
+        {
+            if (telemetry != nullptr)
+                telemetry->addOnset(int(juce::jmin(noteAgeSamples + i, juce::int64(std::numeric_limits<int>::max()))));
+            awaitingOnset = false;
+            return;
+        }
     }
 }
 
 // Cambia el tipo de onda desde GUI
 void SynthVoice::setWaveType(int waveIndex)
 {
+    if (waveIndex != currentWaveIndex)
+        leaveSustainCache();
     currentWaveIndex = waveIndex;
     oscillator.setWaveType(currentWaveIndex);
 }
 
+// Tablas compartidas con las demás voces (antes de prepare)
+void SynthVoice::setWavetables(std::shared_ptr<WavetableSet> tables)
+{
+    oscillator.setWavetables(std::move(tables));
+}
+
+// Construye (fuera del hilo de audio) el oscilador de una forma de onda
+void SynthVoice::materializeWave(int waveIndex)
+{
+    oscillator.materialize(waveIndex);
+}
+
+// Forma de onda pedida que todavía no está construida (-1 si ninguna)
+int SynthVoice::getPendingWaveType() const
+{
+    return oscillator.getPendingWaveType();
+}
+
 // Cambia amplitud desde GUI o AudioProcessor
 void SynthVoice::setAmplitude(float amp)
 {
+    if (amp != currentVelocity)
+        leaveSustainCache();
     currentVelocity = amp;
     oscillator.setAmplitude(currentVelocity);
+    fm.setAmplitude(currentVelocity);
+    additive.setAmplitude(currentVelocity);
+    userWavetable.setAmplitude(currentVelocity);
 }
 
-void SynthVoice::prepare(double sampleRate)
+void SynthVoice::prepare(double newSampleRate)
 {
+    sampleRate = newSampleRate;
+    sustainLoop.reset();
     oscillator.setSampleRate(sampleRate);
     env.setSampleRate(sampleRate);
     voiceFilter.setSampleRate(sampleRate);
+
+    // El Sine se construye con el primer sample rate y cambia con él: el FM lee las tablas nuevas
+    fm.setSource(oscillator.getSine());
+    fm.setSampleRate(sampleRate);
+    additive.setSampleRate(sampleRate);
 }
\ No newline at end of file
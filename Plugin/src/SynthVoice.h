@@ -1,9 +1,17 @@
 #pragma once
 #include <JuceHeader.h>
 #include "Oscillator/OscillatorWrapper.h"
+#include "Oscillator/FMOscillator.h"
+#include "Oscillator/AdditiveOscillator.h"
+#include "Oscillator/UserWavetableOscillator.h"
 #include "Oscillator/Oscillator.h"
 #include "Filter/VoiceFilter.h"
+#include "DSP/SustainLoop.h"
 #include "Envelope.h"
+#include "Tuning/TuningTable.h"
+#include "Performance/MemoryUsage.h"
+#include "Performance/VoiceTelemetry.h"
+#include <array>
 
 /**
  * @class SynthVoice
@@ -38,6 +46,15 @@ public:
      */
     void prepare(double sampleRate);
 
+    /**
+     * @brief Reads the wavetable banks of a set shared with the other voices.
+     * @param tables Set built by the processor for its sample rate.
+     *
+     * Call before prepare() with the same rate, so prepare() does not build
+     * a private set. Generates no tables; never from the audio thread.
+     */
+    void setWavetables(std::shared_ptr<WavetableSet> tables);
+
     /**
      * @brief Determines whether this voice can play a given sound.
      * @param sound Pointer to a juce::SynthesiserSound object.
@@ -54,6 +71,8 @@ public:
      *
      * Updates the oscillator’s frequency, amplitude, and waveform type
      * according to the current parameters, and marks the note as active.
+     * Constant time: the frequency comes from the TuningTable and only the
+     * active oscillator and filter state are touched.
      */
     void startNote(int midiNoteNumber, float velocity,
                    juce::SynthesiserSound *sound, int currentPitchWheelPosition) override;
@@ -66,8 +85,10 @@ public:
     void stopNote(float velocity, bool allowTailOff) override;
 
     /**
-     * @brief Handles pitch wheel movement (not implemented).
-     * @param newPitchWheelValue New pitch wheel value.
+     * @brief Bends the voice's pitch by up to ± the bend range.
+     * @param newPitchWheelValue New pitch wheel value (0–16383, centre 8192).
+     *
+     * Applied per sample in renderNextBlock(), smoothed over one control interval.
      */
     void pitchWheelMoved(int newPitchWheelValue) override;
 
@@ -86,6 +107,9 @@ public:
      *
      * If the note is active, this method generates samples from the oscillator
      * and mixes them into each channel of the output buffer.
+     *
+     * The block is processed in chunks of renderChunkSize samples, one stage at
+     * a time (oscillator, envelope, filter) over an internal scratch buffer.
      */
     void renderNextBlock(juce::AudioBuffer<float> &outputBuffer, int startSample, int numSamples) override;
 
@@ -95,6 +119,21 @@ public:
      */
     void setWaveType(int waveIndex);
 
+    /**
+     * @brief Builds the oscillator for a waveform so it can be selected without delay.
+     * @param waveIndex Waveform index.
+     *
+     * Generates wavetables: call from prepare or a background thread, never
+     * from the audio thread.
+     */
+    void materializeWave(int waveIndex);
+
+    /**
+     * @brief Returns the waveform the voice was asked to play but has not built yet.
+     * @return Waveform index, or -1 if nothing is pending.
+     */
+    int getPendingWaveType() const;
+
     /**
      * @brief Sets the amplitude (volume) of the voice.
      * @param amp New amplitude value (normalized 0.0–1.0).
@@ -116,16 +155,257 @@ public:
      */
     void setFilterParameters(float cutoff, const juce::String &type);
 
+    /**
+     * @brief Updates filter parameters without string parsing.
+     * @param cutoff Cutoff frequency in Hz.
+     * @param type Filter type.
+     */
+    void setFilterParameters(float cutoff, RCFilterType type);
+
+    /**
+     * @brief Enables or disables the per-voice filter.
+     * @param shouldFilter False when the engine filters the mix (paraphonic mode).
+     */
+    void setFilterEnabled(bool shouldFilter);
+
+    /**
+     * @brief Updates the pitch modulation settings.
+     * @param bendRangeSemitones Pitch wheel range, in semitones each way.
+     * @param glideSeconds Portamento time from the voice's previous pitch (0 = off).
+     * @param vibratoRateHz Vibrato LFO rate.
+     * @param vibratoDepthSemitones Vibrato depth, peak (0 = off).
+     *
+     * Glide is per voice: a new note slides from the pitch this voice was
+     * last playing, in glideSeconds, linearly in semitones.
+     */
+    void setPitchModulation(float bendRangeSemitones, float glideSeconds,
+                            float vibratoRateHz, float vibratoDepthSemitones);
+
+    /**
+     * @brief Sets the pulse width of the Square waveform.
+     * @param width Fraction of the cycle; 0.5 = square.
+     */
+    void setPulseWidth(float width);
+
+    /**
+     * @brief Switches layer mode and sets its four layers (Sine, Saw, Square, Triangle).
+     * @param layerMode True to mix the layers instead of the selected waveform.
+     * @param settings One entry per waveform, same order as setWaveType().
+     */
+    void setLayers(bool layerMode,
+                   const std::array<OscillatorWrapper::LayerSettings, OscillatorWrapper::numWaveTypes> &settings);
+
+    /**
+     * @brief Switches the voice to the FM source and sets it.
+     * @param fmMode True to render with FMOscillator instead of the wavetable oscillator.
+     * @param algorithm FM algorithm index (see FMOscillator::getAlgorithmName()).
+     * @param operators Ratio, level and feedback of each operator.
+     * @param modulatorDecay Decay of the modulation depth, in seconds.
+     * @param modulatorSustain Modulation depth held while the note is down, 0–1.
+     *
+     * The modulator envelope takes its attack and release from setEnvelopeParameters().
+     */
+    void setFM(bool fmMode, int algorithm,
+               const std::array<FMOscillator::OperatorSettings, FMOscillator::numOperators> &operators,
+               float modulatorDecay, float modulatorSustain);
+
+    /**
+     * @brief Switches the voice to the additive source and sets its spectrum.
+     * @param additiveMode True to render with AdditiveOscillator instead of the wavetable oscillator.
+     * @param settings Partial count, tilt, even level and partial envelopes.
+     */
+    void setAdditive(bool additiveMode, const AdditiveOscillator::Settings &settings);
+
+    /**
+     * @brief Switches the voice to the imported wavetable and sets the morph position.
+     * @param wavetableMode True to render with UserWavetableOscillator instead of the wavetable oscillator.
+     * @param position Morph position across the table's frames, 0–1.
+     */
+    void setUserWavetableMode(bool wavetableMode, float position);
+
+    /**
+     * @brief Sets the imported wavetable the voice plays in wavetable mode.
+     * @param table Owned by the processor; nullptr renders silence.
+     *
+     * Only while the audio thread is not rendering (the processor holds the callback lock).
+     */
+    void setUserWavetable(const UserWavetable *table);
+
+    /**
+     * @brief Sets the note → frequency table used by startNote().
+     * @param table Owned by the processor; nullptr falls back to 12-TET.
+     */
+    void setTuning(const TuningTable *table);
+
+    /**
+     * @brief Sets the telemetry this voice reports to.
+     * @param newTelemetry Owned by the processor; nullptr disables reporting.
+     *
+     * The voice reports note starts (and steals), the samples it renders in
+     * each envelope stage and the delay from note-on to its first sample
+     * above VoiceTelemetry::onsetThreshold.
+     */
+    void setTelemetry(VoiceTelemetry *newTelemetry);
+
+    /** @brief Current envelope stage. */
+    Envelope::Stage getEnvelopeStage() const { return env.getStage(); }
+
+    /** @brief Samples rendered since the current note started. */
+    juce::int64 getNoteAgeSamples() const { return noteAgeSamples; }
+
+    /**
+     * @brief Enables or disables linear wavetable interpolation.
+     * @param shouldInterpolate False selects cheaper drop-sample reads.
+     */
+    void setLinearInterpolation(bool shouldInterpolate);
+
+    /**
+     * @brief Enables the sustain cache.
+     * @param shouldCache True to replay a captured period while the voice sustains.
+     *
+     * In Sustain with no pitch modulation the voice detunes by at most
+     * SustainLoop::maxDetune so that a whole number of cycles fits a loop,
+     * renders until two consecutive loops match, and then replays the loop
+     * without running the oscillator, envelope or filter. Any change that
+     * affects the sound (note-off, parameters, pitch wheel) first rebuilds
+     * the real state at the current loop position, so the output continues
+     * without a jump.
+     */
+    void setSustainCacheEnabled(bool shouldCache);
+
+    /** @brief True while the voice replays its sustain loop. */
+    bool isReplayingSustain() const { return sustainLoop.getState() == SustainLoop::State::Settled; }
+
+    /**
+     * @brief Fades the voice out over a few milliseconds.
+     *
+     * Used by SynthEngine to cull voices in release when CPU headroom is low.
+     * No effect on idle voices or voices already being culled.
+     */
+    void cullRelease();
+
+    /**
+     * @brief Adds this voice's memory to a report: object, scratch, filter banks.
+     * @param usage Report being filled by the processor.
+     *
+     * The wavetables belong to the shared WavetableSet and are counted by
+     * its owner. Not for the audio thread; safe while it runs.
+     */
+    void addMemoryUsage(MemoryUsage &usage) const;
+
 private:
+    /** @brief Samples processed per stage pass; keeps the scratch buffer in L1. */
+    static constexpr int renderChunkSize = 256;
+
+    /** @brief Samples between pitch control points; the ratio is interpolated in between. */
+    static constexpr int pitchControlInterval = 16;
+
+    /** @brief True while bend, glide or vibrato move the pitch away from the note. */
+    bool isPitchModulated() const;
+
+    /**
+     * @brief Fills ratio with per-sample frequency multipliers for the next samples.
+     *
+     * exp2 and sin run once per control interval; each sample gets a linear
+     * step between control points.
+     */
+    void computePitchRatios(float *ratio, int numSamples);
+
+    /**
+     * @brief Applies the envelope and, if enabled, the voice filter.
+     *
+     * Each envelope segment goes through one fused ramp + filter kernel
+     * (specialized per filter type and for constant vs. ramp segments), so
+     * the block is read and written once.
+     *
+     * @param stageTelemetry Receives the samples of each envelope stage;
+     *        nullptr when re-rendering samples already counted.
+     */
+    void applyEnvelopeAndFilter(float *buffer, int numSamples, VoiceTelemetry *stageTelemetry);
+
+    /** @brief Reports the onset if this chunk holds the note's first audible sample. */
+    void detectOnset(const float *chunk, int numSamples);
+
+    /** @brief Picks the loop length and detunes the oscillator to it. */
+    void beginSustainCapture();
+
+    /** @brief Saves the state at the end of the chunk that settled the loop. */
+    void snapshotSustainLoop();
+
+    /**
+     * @brief Stops capturing or replaying and restores the real voice state.
+     *
+     * Called before a setting changes, so the state is rebuilt with the
+     * settings the loop was recorded with.
+     */
+    void leaveSustainCache();
+
+    /** @brief Scratch buffer holding one chunk while it goes through the stages. */
+    std::array<float, renderChunkSize> renderBuffer{};
+
+    /** @brief Per-sample frequency multipliers of the current chunk. */
+    std::array<float, renderChunkSize> pitchRatio{};
+
     /** @brief Main oscillator used for waveform generation. */
     OscillatorWrapper oscillator;
 
+    /** @brief FM source, reads the oscillator's Sine tables (used in FM mode). */
+    FMOscillator fm;
+
+    /** @brief Additive source (used in additive mode). */
+    AdditiveOscillator additive;
+
+    /** @brief Imported wavetable source (used in wavetable mode). */
+    UserWavetableOscillator userWavetable;
+
     /** @brief Envelope ADSR. */
     Envelope env;
 
     /** @brief Per-voice filter. */
     VoiceFilter voiceFilter;
 
+    /** @brief False in paraphonic mode: the engine filters the mix. */
+    bool filterEnabled = true;
+
+    // Ajustes actuales (un cambio invalida la caché de sustain)
+    float filterCutoff = 1000.0f;
+    RCFilterType filterType = RCFilterType::Lowpass;
+    float sustainLevel = 0.8f;
+    float pulseWidth = 0.5f;
+    bool linearInterpolation = true;
+    bool layerMode = false;
+    std::array<OscillatorWrapper::LayerSettings, OscillatorWrapper::numWaveTypes> layerSettings{};
+    bool fmMode = false;
+    int fmAlgorithm = 0;
+    std::array<FMOscillator::OperatorSettings, FMOscillator::numOperators> fmOperators{};
+    float attackTime = 0.01f;
+    float releaseTime = 0.2f;
+    float fmModulatorDecay = 0.5f;
+    float fmModulatorSustain = 0.5f;
+    bool additiveMode = false;
+    AdditiveOscillator::Settings additiveSettings{};
+    bool userWavetableMode = false;
+    float wavePosition = 0.0f;
+
+    /** @brief Captured period replayed during Sustain. */
+    SustainLoop sustainLoop;
+    bool sustainCacheEnabled = false;
+
+    // Estado de la voz en una posición conocida del loop (para salir sin saltos)
+    double loopSnapshotPhase = 0.0;
+    RCFilterState loopSnapshotFilter;
+    int loopSnapshotPosition = 0;
+    double notePhaseDelta = 0.0; ///< Phase increment of the note before the loop detune.
+
+    /** @brief Note → frequency table (not owned). */
+    const TuningTable *tuning = nullptr;
+
+    /** @brief Activity counters (not owned). */
+    VoiceTelemetry *telemetry = nullptr;
+
+    juce::int64 noteAgeSamples = 0; ///< Samples rendered since startNote().
+    bool awaitingOnset = false;     ///< The note has not reached the onset threshold yet.
+
     /** @brief Current waveform index. */
     int currentWaveIndex = 0;
 
@@ -134,4 +414,19 @@ private:
 
     /** @brief Indicates whether a note is currently active. */
     bool isNoteActive = false;
+
+    // Pitch modulation settings (from the processor)
+    float bendRange = 2.0f;     ///< Semitones each way.
+    float glideTime = 0.0f;     ///< Seconds; 0 disables glide.
+    float vibratoRate = 5.0f;   ///< Hz.
+    float vibratoDepth = 0.0f;  ///< Semitones; 0 disables vibrato.
+
+    // Pitch modulation state
+    double sampleRate = 44100.0;
+    double noteFrequency = 0.0;  ///< Unmodulated frequency of the current note (0 before the first note).
+    int pitchWheelPosition = 8192;
+    float glideOffset = 0.0f;    ///< Remaining glide, semitones.
+    float glideStep = 0.0f;      ///< Glide change per sample, semitones.
+    double vibratoPhase = 0.0;   ///< [0, 1).
+    float currentRatio = 1.0f;   ///< Multiplier at the last control point.
 };
@@ -0,0 +1,175 @@
+#include "TuningTable.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    /** @brief Parses one Scala pitch line: cents if it has a '.', otherwise a ratio "a/b" or "a". */
+    bool parsePitch(const juce::String &line, double &ratio)
+    {
+        const auto token = line.trim().upToFirstOccurrenceOf(" ", false, false)
+                               .upToFirstOccurrenceOf("\t", false, false);
+        if (token.isEmpty())
+            return false;
+
+        if (token.containsChar('.'))
+        {
+            ratio = std::pow(2.0, token.getDoubleValue() / 1200.0);
+            return true;
+        }
+
+        if (!token.containsOnly("0123456789/"))
+            return false;
+
+        const auto numerator = token.upToFirstOccurrenceOf("/", false, false).getLargeIntValue();
+        const auto denominator = token.containsChar('/')
+                                     ? token.fromFirstOccurrenceOf("/", false, false).getLargeIntValue()
+                                     : juce::int64(1);
+        if (numerator <= 0 || denominator <= 0)
+            return false;
+
+        ratio = double(numerator) / double(denominator);
+        return true;
+    }
+}
+
+TuningTable::TuningTable()
+{
+    resetToEqualTemperament();
+}
+
+void TuningTable::publish(std::unique_ptr<Table> table)
+{
+    for (int n = 0; n < numNotes; ++n)
+        table->phaseDelta[size_t(n)] = table->frequency[size_t(n)] / table->sampleRate;
+
+    // Tables retired before the block that is running now have no readers left
+    const auto block = blocksStarted.load();
+    retired.erase(std::remove_if(retired.begin(), retired.end(),
+                                 [block](const RetiredTable &r) { return r.block < block; }),
+                  retired.end());
+
+    current.store(table.get());
+    if (active != nullptr)
+        retired.push_back({blocksStarted.load(), std::move(active)});
+    active = std::move(table);
+}
+
+void TuningTable::setSampleRate(double sampleRate)
+{
+    const juce::ScopedLock sl(writeLock);
+
+    if (active->sampleRate == sampleRate)
+        return;
+
+    auto table = std::make_unique<Table>(*active);
+    table->sampleRate = sampleRate;
+    publish(std::move(table));
+}
+
+void TuningTable::resetToEqualTemperament()
+{
+    const juce::ScopedLock sl(writeLock);
+
+    // Restoring a state without a scale must not publish a new table every time
+    if (active != nullptr && active->scalaText.isEmpty())
+        return;
+
+    auto table = std::make_unique<Table>();
+    table->sampleRate = active != nullptr ? active->sampleRate : 44100.0;
+    table->description = "12-TET";
+    for (int n = 0; n < numNotes; ++n)
+        table->frequency[size_t(n)] = 440.0 * std::pow(2.0, (n - 69) / 12.0);
+
+    publish(std::move(table));
+}
+
+size_t TuningTable::getMemoryBytes() const
+{
+    const juce::ScopedLock sl(writeLock);
+
+    auto tableBytes = [](const Table &t)
+    { return sizeof(Table) + t.description.getNumBytesAsUTF8() + t.scalaText.getNumBytesAsUTF8(); };
+
+    size_t bytes = tableBytes(*active) + retired.capacity() * sizeof(RetiredTable);
+    for (const auto &r : retired)
+        bytes += tableBytes(*r.table);
+    return bytes;
+}
+
+bool TuningTable::loadScala(const juce::File &file, juce::String *errorMessage)
+{
+    if (!file.existsAsFile())
+    {
+        if (errorMessage != nullptr)
+            *errorMessage = "File not found: " + file.getFullPathName();
+        return false;
+    }
+
+    return loadScalaText(file.loadFileAsString(), errorMessage);
+}
+
+bool TuningTable::loadScalaText(const juce::String &text, juce::String *errorMessage)
+{
+    auto fail = [errorMessage](const juce::String &reason)
+    {
+        if (errorMessage != nullptr)
+            *errorMessage = reason;
+        return false;
+    };
+
+    // Comments ('!') can appear anywhere; the first other line is the
+    // description (possibly empty), the second the number of notes
+    juce::StringArray lines;
+    for (const auto &line : juce::StringArray::fromLines(text))
+        if (!line.trimStart().startsWithChar('!'))
+            lines.add(line);
+
+    if (lines.size() < 2)
+        return fail("Missing description or note count");
+
+    const int numDegrees = lines[1].trim().getIntValue();
+    if (numDegrees < 1 || numDegrees > 1024 || lines.size() < 2 + numDegrees)
+        return fail("Invalid note count: " + lines[1].trim());
+
+    // degrees[0] = 1/1, degrees[k] = k-th pitch line; the last pitch is the period
+    std::vector<double> degrees(size_t(numDegrees), 1.0);
+    double period = 2.0;
+    for (int k = 0; k < numDegrees; ++k)
+    {
+        double ratio = 0.0;
+        if (!parsePitch(lines[2 + k], ratio) || ratio <= 0.0)
+            return fail("Invalid pitch on line: " + lines[2 + k].trim());
+
+        if (k == numDegrees - 1)
+            period = ratio;
+        else
+            degrees[size_t(k + 1)] = ratio;
+    }
+
+    if (period <= 1.0)
+        return fail("The scale must end above 1/1");
+
+    // Ratio of note n relative to note 60
+    auto ratioFromMiddleC = [&](int n)
+    {
+        const int steps = n - 60;
+        const int octave = steps >= 0 ? steps / numDegrees : -((-steps + numDegrees - 1) / numDegrees);
+        const int degree = steps - octave * numDegrees;
+        return std::pow(period, octave) * degrees[size_t(degree)];
+    };
+
+    const double middleC = 440.0 / ratioFromMiddleC(69);
+
+    const juce::ScopedLock sl(writeLock);
+
+    auto table = std::make_unique<Table>();
+    table->sampleRate = active->sampleRate;
+    table->description = lines[0].trim().isNotEmpty() ? lines[0].trim() : juce::String("Scala scale");
+    table->scalaText = text;
+    for (int n = 0; n < numNotes; ++n)
+        table->frequency[size_t(n)] = middleC * ratioFromMiddleC(n);
+
+    publish(std::move(table));
+    return true;
+}
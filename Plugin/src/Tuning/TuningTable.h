@@ -0,0 +1,99 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @class TuningTable
+ * @brief Precomputed MIDI note → frequency / phase increment table, reloadable from Scala files.
+ *
+ * Note-on only has to index this table, so its cost no longer depends on
+ * pow() or on how many oscillators a voice owns.
+ *
+ * The default tuning is 12-tone equal temperament with A4 (note 69) = 440 Hz.
+ * A Scala scale (.scl) can replace it. It is mapped like Scala's default
+ * keyboard mapping: scale degree 0 on note 60, one scale step per key,
+ * repeating at the scale's last interval, and note 69 fixed at 440 Hz.
+ *
+ * Tables are immutable once published. Writers (message thread, prepareToPlay)
+ * build a new table and swap an atomic pointer; the audio thread reads the
+ * current one with a single atomic load. A replaced table is retired, not
+ * freed: the audio thread calls beginBlock() once per block, and the next
+ * publish frees the tables retired before the running block started, which
+ * no reader can still hold.
+ */
+class TuningTable
+{
+public:
+    static constexpr int numNotes = 128;
+
+    /** @brief One published tuning, for one sample rate. */
+    struct Table
+    {
+        std::array<double, numNotes> frequency{};  ///< Hz.
+        std::array<double, numNotes> phaseDelta{}; ///< frequency / sampleRate.
+        double sampleRate = 44100.0;
+        juce::String description; ///< Scale description, "12-TET" by default.
+        juce::String scalaText;   ///< Source .scl text (empty for the default).
+    };
+
+    /** @brief Starts in 12-TET at 44.1 kHz. */
+    TuningTable();
+
+    /**
+     * @brief Recomputes phase increments for a new sample rate.
+     * @param sampleRate Sample rate in Hz.
+     *
+     * Call from prepareToPlay. No-op if the rate did not change.
+     */
+    void setSampleRate(double sampleRate);
+
+    /**
+     * @brief Loads a Scala .scl file.
+     * @param file Scale file.
+     * @param errorMessage Optional; receives the reason on failure.
+     * @return True if the tuning was replaced.
+     */
+    bool loadScala(const juce::File &file, juce::String *errorMessage = nullptr);
+
+    /** @brief Same as loadScala() from the file contents (used for plugin state). */
+    bool loadScalaText(const juce::String &text, juce::String *errorMessage = nullptr);
+
+    /** @brief Returns to 12-TET, A4 = 440 Hz. No-op if already there. */
+    void resetToEqualTemperament();
+
+    /**
+     * @brief Current table. Lock-free; callable from the audio thread.
+     *
+     * Sequentially consistent, like the counter in beginBlock(): publish()
+     * relies on that order to know which tables a block may have read.
+     */
+    const Table &get() const noexcept { return *current.load(); }
+
+    /** @brief Marks the start of an audio block. Audio thread, before any note-on. */
+    void beginBlock() noexcept { blocksStarted.fetch_add(1); }
+
+    /** @brief Bytes held by the current table and the retired ones not freed yet. */
+    size_t getMemoryBytes() const;
+
+private:
+    /** @brief Fills phase increments, publishes a table and retires the previous one. Caller holds writeLock. */
+    void publish(std::unique_ptr<Table> table);
+
+    /** @brief A replaced table and the value of blocksStarted when it was replaced. */
+    struct RetiredTable
+    {
+        uint64_t block = 0;
+        std::unique_ptr<const Table> table;
+    };
+
+    std::unique_ptr<const Table> active;
+    std::vector<RetiredTable> retired;
+    std::atomic<const Table *> current{nullptr};
+    std::atomic<uint64_t> blocksStarted{0};
+    mutable juce::CriticalSection writeLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TuningTable)
+};
@@ -0,0 +1,175 @@
+#include "AnalyzerComponent.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr float minDb = -100.0f;
+    constexpr float maxDb = 0.0f;
+    constexpr float releaseDbPerFrame = 3.0f;
+    constexpr float minFrequency = 20.0f;
+}
+
+AnalyzerComponent::AnalyzerComponent(ScopeFifo &source)
+    : fifo(source)
+{
+    spectrumDb.fill(minDb);
+    setOpaque(true);
+    startTimerHz(30);
+}
+
+void AnalyzerComponent::timerCallback()
+{
+    // Hidden editor: leave the FIFO alone, the audio thread just drops samples
+    if (!isShowing())
+        return;
+
+    const int pulled = fifo.pull(pullBuffer.data(), int(pullBuffer.size()));
+    if (pulled == 0)
+        return; // host stopped: keep the last frame
+
+    appendToHistory(pullBuffer.data(), pulled);
+    displaySampleRate = fifo.getOutputSampleRate();
+    updateSpectrum();
+
+    repaint();
+}
+
+void AnalyzerComponent::appendToHistory(const float *samples, int numSamples) noexcept
+{
+    // Only the last fftSize samples can ever be displayed
+    if (numSamples > fftSize)
+    {
+        samples += numSamples - fftSize;
+        numSamples = fftSize;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        history[size_t(historyWritePos)] = samples[i];
+        historyWritePos = (historyWritePos + 1) & (fftSize - 1);
+    }
+}
+
+void AnalyzerComponent::updateSpectrum()
+{
+    // Oldest sample first
+    for (int i = 0; i < fftSize; ++i)
+        fftData[size_t(i)] = history[size_t((historyWritePos + i) & (fftSize - 1))];
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+    window.multiplyWithWindowingTable(fftData.data(), size_t(fftSize));
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // Full-scale sine -> 0 dB (hann window has a coherent gain of 0.5)
+    const float normalisation = 2.0f / (0.5f * float(fftSize));
+
+    for (size_t bin = 0; bin < spectrumDb.size(); ++bin)
+    {
+        const float db = juce::Decibels::gainToDecibels(fftData[bin] * normalisation, minDb);
+        // Instant attack, slow release
+        spectrumDb[bin] = juce::jmax(db, spectrumDb[bin] - releaseDbPerFrame);
+    }
+}
+
+void AnalyzerComponent::paint(juce::Graphics &g)
+{
+    g.fillAll(juce::Colours::black);
+
+    auto bounds = getLocalBounds().toFloat();
+    auto scopeArea = bounds.removeFromLeft(bounds.getWidth() / 2).reduced(4.0f);
+    auto spectrumArea = bounds.reduced(4.0f);
+
+    g.setColour(juce::Colours::grey);
+    g.drawRect(scopeArea);
+    g.drawRect(spectrumArea);
+
+    drawScope(g, scopeArea.reduced(1.0f));
+    drawSpectrum(g, spectrumArea.reduced(1.0f));
+
+    g.setColour(juce::Colours::white);
+    g.setFont(12.f);
+    g.drawText("SCOPE", scopeArea.reduced(4.0f), juce::Justification::topLeft);
+    g.drawText("SPECTRUM", spectrumArea.reduced(4.0f), juce::Justification::topLeft);
+}
+
+void AnalyzerComponent::drawScope(juce::Graphics &g, juce::Rectangle<float> bounds) const
+{
+    auto sampleAt = [this](int i)
+    { return history[size_t((historyWritePos + i) & (fftSize - 1))]; };
+
+    // Rising zero crossing in the older part of the history, so a full
+    // scopeSize window always fits after it
+    const int searchEnd = fftSize - scopeSize;
+    int start = searchEnd;
+    for (int i = searchEnd; i > 0; --i)
+    {
+        if (sampleAt(i - 1) < 0.0f && sampleAt(i) >= 0.0f)
+        {
+            start = i;
+            break;
+        }
+    }
+
+    g.setColour(juce::Colours::darkgrey);
+    g.drawHorizontalLine(juce::roundToInt(bounds.getCentreY()), bounds.getX(), bounds.getRight());
+
+    juce::Path path;
+    const float xScale = bounds.getWidth() / float(scopeSize - 1);
+    const float yScale = bounds.getHeight() * 0.5f;
+    for (int i = 0; i < scopeSize; ++i)
+    {
+        const float x = bounds.getX() + float(i) * xScale;
+        const float y = bounds.getCentreY() - juce::jlimit(-1.0f, 1.0f, sampleAt(start + i)) * yScale;
+        if (i == 0)
+            path.startNewSubPath(x, y);
+        else
+            path.lineTo(x, y);
+    }
+
+    g.setColour(juce::Colours::limegreen);
+    g.strokePath(path, juce::PathStrokeType(1.5f));
+}
+
+void AnalyzerComponent::drawSpectrum(juce::Graphics &g, juce::Rectangle<float> bounds) const
+{
+    const float nyquist = float(displaySampleRate * 0.5);
+    const float logMin = std::log10(minFrequency);
+    const float logRange = std::log10(nyquist) - logMin;
+    const float binWidth = float(displaySampleRate) / float(fftSize);
+
+    auto frequencyToX = [&](float f)
+    { return bounds.getX() + bounds.getWidth() * (std::log10(f) - logMin) / logRange; };
+    auto dbToY = [&](float db)
+    { return juce::jmap(juce::jlimit(minDb, maxDb, db), minDb, maxDb, bounds.getBottom(), bounds.getY()); };
+
+    // Decade grid
+    g.setColour(juce::Colours::darkgrey);
+    for (float f : {100.0f, 1000.0f, 10000.0f})
+        if (f < nyquist)
+            g.drawVerticalLine(juce::roundToInt(frequencyToX(f)), bounds.getY(), bounds.getBottom());
+
+    juce::Path path;
+    bool started = false;
+    for (size_t bin = 1; bin < spectrumDb.size(); ++bin)
+    {
+        const float f = float(bin) * binWidth;
+        if (f < minFrequency)
+            continue;
+
+        const float x = frequencyToX(f);
+        const float y = dbToY(spectrumDb[bin]);
+        if (!started)
+        {
+            path.startNewSubPath(x, y);
+            started = true;
+        }
+        else
+        {
+            path.lineTo(x, y);
+        }
+    }
+
+    g.setColour(juce::Colours::orange);
+    g.strokePath(path, juce::PathStrokeType(1.5f));
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <JuceHeader.h>
+#include "ScopeFifo.h"
+#include <array>
+
+/**
+ * @class AnalyzerComponent
+ * @brief Oscilloscope and spectrum display fed by the processor's ScopeFifo.
+ *
+ * All the work happens on the message thread: a timer drains the FIFO into a
+ * history buffer, runs the FFT and repaints. When the component is not
+ * showing (editor closed, minimised or hidden) the timer callback returns
+ * immediately, so the display costs nothing and the FIFO simply fills up and
+ * drops samples on the audio side.
+ *
+ * The left half draws the most recent samples, triggered on a rising zero
+ * crossing so periodic waveforms stand still. The right half draws the
+ * magnitude spectrum on a logarithmic frequency axis (20 Hz .. Nyquist).
+ */
+class AnalyzerComponent : public juce::Component,
+                          private juce::Timer
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int scopeSize = 1024;
+
+    /**
+     * @brief Creates the analyzer.
+     * @param source FIFO written by the audio thread; must outlive this component.
+     */
+    explicit AnalyzerComponent(ScopeFifo &source);
+
+    ~AnalyzerComponent() override = default;
+
+    void paint(juce::Graphics &g) override;
+
+private:
+    /** @brief Drains the FIFO, updates the spectrum and repaints (skipped when hidden). */
+    void timerCallback() override;
+
+    /** @brief Appends pulled samples to the circular history. */
+    void appendToHistory(const float *samples, int numSamples) noexcept;
+
+    /** @brief Windows the latest fftSize samples and updates the smoothed spectrum. */
+    void updateSpectrum();
+
+    void drawScope(juce::Graphics &g, juce::Rectangle<float> bounds) const;
+    void drawSpectrum(juce::Graphics &g, juce::Rectangle<float> bounds) const;
+
+    ScopeFifo &fifo;
+
+    juce::dsp::FFT fft{fftOrder};
+    juce::dsp::WindowingFunction<float> window{size_t(fftSize), juce::dsp::WindowingFunction<float>::hann};
+
+    /** @brief Circular history of the most recent samples (fftSize long). */
+    std::array<float, fftSize> history{};
+    int historyWritePos = 0;
+
+    /** @brief Scratch buffer for pulling from the FIFO. */
+    std::array<float, ScopeFifo::capacity> pullBuffer{};
+
+    /** @brief FFT work area (real input, then magnitudes in the first half). */
+    std::array<float, 2 * fftSize> fftData{};
+
+    /** @brief Smoothed spectrum in dB, fftSize / 2 bins. */
+    std::array<float, fftSize / 2> spectrumDb{};
+
+    double displaySampleRate = 44100.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyzerComponent)
+};
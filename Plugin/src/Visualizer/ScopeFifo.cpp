@@ -0,0 +1,82 @@
+#include "ScopeFifo.h"
+#include <cmath>
+#include <cstring>
+
+ScopeFifo::ScopeFifo()
+    : storage(capacity, 0.0f)
+{
+}
+
+void ScopeFifo::prepare(double sampleRate)
+{
+    decimation = juce::jmax(1, int(std::ceil(sampleRate / 48000.0)));
+    decimationPhase = 0;
+    currentSum = 0.0f;
+    nextSum = 0.0f;
+    outputSampleRate.store(sampleRate / decimation, std::memory_order_relaxed);
+
+    // The read index belongs to the consumer: it drops the old samples itself
+    preparedGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void ScopeFifo::push(const float *samples, int numSamples) noexcept
+{
+    if (samples == nullptr || numSamples <= 0)
+        return;
+
+    if (decimation == 1)
+    {
+        // Bounded memcpy of whatever fits; the rest of the block is dropped
+        const auto scope = fifo.write(juce::jmin(numSamples, fifo.getFreeSpace()));
+        if (scope.blockSize1 > 0)
+            std::memcpy(storage.data() + scope.startIndex1, samples, size_t(scope.blockSize1) * sizeof(float));
+        if (scope.blockSize2 > 0)
+            std::memcpy(storage.data() + scope.startIndex2, samples + scope.blockSize1, size_t(scope.blockSize2) * sizeof(float));
+        return;
+    }
+
+    // CIC of order 2: sample j of a window weighs N - 1 - j in this window's
+    // output and j + 1 in the next one (a triangle over 2N - 1 samples,
+    // total weight N^2). Windows continue across blocks; outputs that do
+    // not fit are still computed, then dropped.
+    const int numKept = (decimationPhase + numSamples) / decimation;
+    const auto scope = fifo.write(juce::jmin(numKept, fifo.getFreeSpace()));
+    const float gain = 1.0f / float(decimation * decimation);
+
+    int kept = 0;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        currentSum += float(decimation - 1 - decimationPhase) * samples[i];
+        nextSum += float(decimationPhase + 1) * samples[i];
+        if (++decimationPhase < decimation)
+            continue;
+
+        if (kept < scope.blockSize1)
+            storage[size_t(scope.startIndex1 + kept)] = currentSum * gain;
+        else if (kept < scope.blockSize1 + scope.blockSize2)
+            storage[size_t(scope.startIndex2 + kept - scope.blockSize1)] = currentSum * gain;
+        ++kept;
+
+        currentSum = nextSum;
+        nextSum = 0.0f;
+        decimationPhase = 0;
+    }
+}
+
+int ScopeFifo::pull(float *dest, int maxSamples) noexcept
+{
+    // After prepare(), whatever is queued may be at the old rate: drop it
+    const uint32_t generation = preparedGeneration.load(std::memory_order_acquire);
+    if (generation != pulledGeneration)
+    {
+        pulledGeneration = generation;
+        fifo.finishedRead(fifo.getNumReady());
+    }
+
+    const auto scope = fifo.read(juce::jmin(maxSamples, fifo.getNumReady()));
+    if (scope.blockSize1 > 0)
+        std::memcpy(dest, storage.data() + scope.startIndex1, size_t(scope.blockSize1) * sizeof(float));
+    if (scope.blockSize2 > 0)
+        std::memcpy(dest + scope.blockSize1, storage.data() + scope.startIndex2, size_t(scope.blockSize2) * sizeof(float));
+    return scope.blockSize1 + scope.blockSize2;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * @class ScopeFifo
+ * @brief Single-producer / single-consumer sample FIFO feeding the GUI visualizers.
+ *
+ * The audio thread pushes the rendered output once per block; the message
+ * thread pulls whatever has arrived when its repaint timer fires.
+ *
+ * The producer side is wait-free and bounded: it copies at most
+ * numSamples / decimation values into preallocated memory and drops samples
+ * when the consumer has fallen behind (e.g. the editor is closed). It never
+ * allocates and never takes a lock.
+ *
+ * Decimation keeps the displayed time span roughly constant at high sample
+ * rates: every N-th sample is kept, with N chosen in prepare(), after a
+ * second-order CIC lowpass (a box of N samples applied twice, i.e. a
+ * triangle over 2N - 1 samples). Its double nulls at every multiple of the
+ * output rate remove what would otherwise fold onto DC and the low bins of
+ * the spectrum; a tone just below the input's Nyquist is down ~48 dB at 2×.
+ *
+ * Each side only moves its own FIFO index: prepare() resets producer state
+ * and asks the consumer to drop what is left at the old rate, which the
+ * next pull() does.
+ */
+class ScopeFifo
+{
+public:
+    /** @brief Capacity in (decimated) samples. */
+    static constexpr int capacity = 8192;
+
+    ScopeFifo();
+
+    /**
+     * @brief Chooses the decimation factor for a sample rate and discards queued samples.
+     * @param sampleRate Host sample rate in Hz.
+     *
+     * Rates up to 48 kHz are kept as-is; higher rates are decimated down to
+     * 48 kHz or below. Call from prepareToPlay (producer side, audio thread
+     * stopped); the samples already queued are dropped by the next pull().
+     */
+    void prepare(double sampleRate);
+
+    /**
+     * @brief Pushes one block of samples (audio thread only).
+     * @param samples Mono samples to push.
+     * @param numSamples Number of samples.
+     */
+    void push(const float *samples, int numSamples) noexcept;
+
+    /**
+     * @brief Pulls available samples (message thread only).
+     * @param dest Destination buffer.
+     * @param maxSamples Capacity of dest.
+     * @return Number of samples written to dest.
+     */
+    int pull(float *dest, int maxSamples) noexcept;
+
+    /** @brief Sample rate of the pulled (decimated) signal, in Hz. */
+    double getOutputSampleRate() const noexcept { return outputSampleRate.load(std::memory_order_relaxed); }
+
+    /** @brief Bytes of the preallocated sample storage. */
+    size_t getMemoryBytes() const noexcept { return storage.capacity() * sizeof(float); }
+
+private:
+    juce::AbstractFifo fifo{capacity};
+    std::vector<float> storage;
+
+    int decimation = 1;
+    int decimationPhase = 0; ///< Position in the current decimation window.
+    float currentSum = 0.0f; ///< Triangle-weighted sum for the next output sample.
+    float nextSum = 0.0f;    ///< Leading half of the triangle for the one after it.
+    std::atomic<double> outputSampleRate{44100.0};
+
+    std::atomic<uint32_t> preparedGeneration{0}; ///< Bumped by prepare().
+    uint32_t pulledGeneration = 0;               ///< Last generation seen by pull() (consumer only).
+};
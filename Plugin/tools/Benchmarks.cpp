@@ -0,0 +1,708 @@
+/**
+ * @file Benchmarks.cpp
+ * @brief Microbenchmarks for every DSP stage, from one oscillator up to processBlock, as JSON.
+ *
+ * Each benchmark is a function that renders a known number of samples. It is
+ * run repeatedly for --min-time seconds (after one warm-up call), three times;
+ * the fastest run is reported as ns/sample and samples/s. The lowest run is
+ * the least disturbed by the OS, which keeps numbers comparable across runs.
+ *
+ * Components and sweeps:
+ *  - oscillator/<wave>/sample: WavetableOscillator::getNextSample()
+ *  - oscillator/<wave>/block:  WavetableOscillator::renderBlock()     (block sizes)
+ *  - oscillator/additive/<path>/<partials>: AdditiveOscillator::renderBlock(), one frame,
+ *                              path forced (oscillators, spectral, automatic)
+ *  - oscillator/wavetable/<read>: UserWavetableOscillator::renderBlock(), 64 frames,
+ *                              on one frame or morphing between two (frame, morph)
+ *  - envelope/<stage>/sample:  Envelope::processSample() held in one stage
+ *  - envelope/<stage>/block:   Envelope::processBlock()               (block sizes)
+ *  - filter/<type>/sample:     RCFilter::processSample()
+ *  - filter/<type>/block:      RCFilter::processBlock()               (block sizes)
+ *  - filter/<type>/ramped:     RCFilter::processRampedBlock(), envelope ramp fused in (block sizes)
+ *  - voice:                    SynthVoice::renderNextBlock(), one held note (block sizes)
+ *  - voice/modulated:          same with pitch bend and vibrato (per-sample pitch)
+ *  - voice/layers:             same in layer mode, four layers (octave, detune, one synced)
+ *  - engine:                   SynthEngine::renderNextBlock(), N held notes (voices × block sizes)
+ *  - engine/paraphonic:        same with one shared filter on the mix instead of one per voice
+ *  - engine/sustain-cache:     same with the sustain cache on (held notes replay a settled loop)
+ *  - engine/fm:                same with the FM source, six operators (one with feedback)
+ *  - engine/additive:          same with the additive source, 64 partials (automatic path)
+ *  - engine/wavetable:         same with an imported wavetable, morphing between two frames
+ *  - processor:                AudioPluginAudioProcessor::processBlock(), N held notes
+ *                              (N capped at the processor's 8 voices; voices × block sizes)
+ * Every component is measured at each sample rate. For engine and processor,
+ * nsPerSample is per output sample (all voices) and nsPerVoiceSample divides
+ * it by the voice count.
+ *
+ * Usage:
+ *   TECBenchmarks [--out=FILE.json] [--filter=SUBSTRING] [--min-time=S] [--quick]
+ *
+ * Without --out the JSON goes to stdout; progress always goes to stderr.
+ */
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "SynthEngine.h"
+#include "SynthVoice.h"
+#include "Envelope.h"
+#include "Filter/RCFilter.h"
+#include "Oscillator/Waves/Sine.h"
+#include "Oscillator/Waves/Saw.h"
+#include "Oscillator/Waves/Square.h"
+#include "Oscillator/Waves/Triangle.h"
+#include "Oscillator/AdditiveOscillator.h"
+#include "Oscillator/UserWavetableOscillator.h"
+#include "DSP/KernelDispatch.h"
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    /** @brief Keeps results alive so the compiler cannot drop the benchmarked work. */
+    volatile float sink = 0.0f;
+
+    class BenchSound : public juce::SynthesiserSound
+    {
+    public:
+        bool appliesToNote(int) override { return true; }
+        bool appliesToChannel(int) override { return true; }
+    };
+
+    struct Config
+    {
+        std::vector<double> sampleRates{44100.0, 48000.0, 96000.0, 192000.0};
+        std::vector<int> blockSizes{16, 64, 256, 1024, 4096};
+        std::vector<int> voiceCounts{1, 8, 32, 128};
+        double minSeconds = 0.05;
+        juce::String filter;
+    };
+
+    class Suite
+    {
+    public:
+        explicit Suite(const Config &c) : config(c) {}
+
+        /** @brief True if name, or a benchmark below the name prefix, matches --filter. */
+        bool wants(const juce::String &name) const
+        {
+            return config.filter.isEmpty() || name.contains(config.filter) || config.filter.startsWith(name);
+        }
+
+        /**
+         * @brief Times fn, which renders samplesPerCall samples per call.
+         * @param voices Voices summed into each output sample (1 for single components).
+         */
+        template <typename Fn>
+        void run(const juce::String &name, double sampleRate, int blockSize, int voices,
+                 int samplesPerCall, Fn &&fn)
+        {
+            fn(); // warm-up: caches, lazy tables, branch predictors
+
+            const auto ticksPerSecond = double(juce::Time::getHighResolutionTicksPerSecond());
+            double bestNs = 1.0e30;
+            juce::int64 totalCalls = 0;
+
+            for (int repeat = 0; repeat < 3; ++repeat)
+            {
+                juce::int64 calls = 0;
+                const auto start = juce::Time::getHighResolutionTicks();
+                juce::int64 elapsed = 0;
+                do
+                {
+                    fn();
+                    ++calls;
+                    elapsed = juce::Time::getHighResolutionTicks() - start;
+                } while (double(elapsed) / ticksPerSecond < config.minSeconds / 3.0);
+
+                const double ns = double(elapsed) / ticksPerSecond * 1.0e9 / (double(calls) * samplesPerCall);
+                bestNs = juce::jmin(bestNs, ns);
+                totalCalls += calls;
+            }
+
+            auto *entry = new juce::DynamicObject();
+            entry->setProperty("name", name);
+            entry->setProperty("sampleRate", sampleRate);
+            entry->setProperty("blockSize", blockSize);
+            entry->setProperty("voices", voices);
+            entry->setProperty("nsPerSample", bestNs);
+            entry->setProperty("nsPerVoiceSample", bestNs / voices);
+            entry->setProperty("samplesPerSecond", 1.0e9 / bestNs);
+            entry->setProperty("realtimeFactor", 1.0e9 / bestNs / sampleRate);
+            entry->setProperty("calls", totalCalls);
+            results.add(juce::var(entry));
+
+            std::fprintf(stderr, "%-34s %8.0f Hz %5d smp %4d v %10.2f ns/smp\n",
+                         name.toRawUTF8(), sampleRate, blockSize, voices, bestNs);
+        }
+
+        juce::Array<juce::var> results;
+
+    private:
+        const Config &config;
+    };
+
+    std::unique_ptr<WavetableOscillator> makeWave(int waveIndex, double sampleRate)
+    {
+        std::unique_ptr<WavetableOscillator> osc;
+        switch (waveIndex)
+        {
+        case 0:
+            osc = std::make_unique<Sine>(sampleRate, 1.0f);
+            break;
+        case 1:
+            osc = std::make_unique<Saw>(sampleRate, 1.0f);
+            break;
+        case 2:
+            osc = std::make_unique<Square>(sampleRate, 1.0f);
+            break;
+        default:
+            osc = std::make_unique<Triangle>(sampleRate, 1.0f);
+            break;
+        }
+        osc->setTableFormat(WavetableOscillator::defaultTableFormat);
+        osc->setFrequency(440.0, sampleRate);
+        return osc;
+    }
+
+    /** @brief Wavetable of 64 frames from saw to sine, mip-maps on the heap (no cache file). */
+    std::unique_ptr<UserWavetable> makeUserWavetable()
+    {
+        constexpr int numFrames = 64;
+        const int size = UserWavetable::frameSize;
+        std::vector<float> frames(size_t(numFrames * size));
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            const float t = float(frame) / float(numFrames - 1);
+            for (int i = 0; i < size; ++i)
+            {
+                const float x = float(i) / float(size);
+                frames[size_t(frame * size + i)] = (1.0f - t) * (2.0f * x - 1.0f) +
+                                                   t * std::sin(juce::MathConstants<float>::twoPi * x);
+            }
+        }
+        return UserWavetable::build(frames, juce::File());
+    }
+
+    void benchOscillators(Suite &suite, const Config &config, double sampleRate, std::vector<float> &scratch)
+    {
+        const char *waveNames[] = {"sine", "saw", "square", "triangle"};
+        for (int wave = 0; wave < 4; ++wave)
+        {
+            const juce::String prefix = juce::String("oscillator/") + waveNames[wave];
+            if (!suite.wants(prefix))
+                continue;
+
+            auto osc = makeWave(wave, sampleRate);
+
+            if (suite.wants(prefix + "/sample"))
+                suite.run(prefix + "/sample", sampleRate, 1, 1, 256, [&]
+                          {
+                              float acc = 0.0f;
+                              for (int i = 0; i < 256; ++i)
+                                  acc += osc->getNextSample();
+                              sink = acc; });
+
+            if (suite.wants(prefix + "/block"))
+                for (int block : config.blockSizes)
+                    suite.run(prefix + "/block", sampleRate, block, 1, block, [&]
+                              {
+                                  osc->renderBlock(scratch.data(), block);
+                                  sink = scratch[0]; });
+        }
+
+        // Aditiva: cada camino forzado, por cantidad de parciales. A 40 Hz los 512
+        // quedan bajo Nyquist; sustain 1 mantiene todos audibles durante la medición
+        const std::pair<AdditiveOscillator::Path, const char *> paths[] = {
+            {AdditiveOscillator::Path::Oscillators, "oscillators"},
+            {AdditiveOscillator::Path::Spectral, "spectral"},
+            {AdditiveOscillator::Path::Automatic, "automatic"}};
+        for (const auto &[path, pathName] : paths)
+        {
+            const juce::String prefix = juce::String("oscillator/additive/") + pathName;
+            if (!suite.wants(prefix))
+                continue;
+
+            for (int partials : {16, 64, 256, 512})
+            {
+                AdditiveOscillator additive;
+                AdditiveOscillator::Settings settings;
+                settings.partials = partials;
+                settings.sustain = 1.0f;
+                additive.setSampleRate(sampleRate);
+                additive.setSettings(settings);
+                additive.setPath(path);
+                additive.setPhaseDelta(40.0 / sampleRate);
+                additive.noteOn();
+
+                const int block = AdditiveOscillator::frameSize;
+                suite.run(prefix + "/" + juce::String(partials), sampleRate, block, 1, block, [&]
+                          {
+                              additive.renderBlock(scratch.data(), block);
+                              sink = scratch[0]; });
+            }
+        }
+
+        // Wavetable importada: sobre un frame (una lectura) o entre dos (dos lecturas y una mezcla)
+        if (suite.wants("oscillator/wavetable"))
+        {
+            const auto table = makeUserWavetable();
+            const std::pair<float, const char *> reads[] = {{0.0f, "frame"}, {0.5f, "morph"}};
+            for (const auto &[position, readName] : reads)
+            {
+                UserWavetableOscillator osc;
+                osc.setTable(table.get());
+                osc.setPosition(position);
+                osc.setPhaseDelta(440.0 / sampleRate);
+                osc.noteOn();
+
+                for (int block : config.blockSizes)
+                    suite.run(juce::String("oscillator/wavetable/") + readName, sampleRate, block, 1, block, [&]
+                              {
+                                  osc.renderBlock(scratch.data(), block);
+                                  sink = scratch[0]; });
+            }
+        }
+    }
+
+    /** @brief Puts an envelope into a stage that lasts far longer than the benchmark. */
+    void holdEnvelopeIn(Envelope &env, Envelope::Stage stage, double sampleRate)
+    {
+        const float forever = 1.0e4f;
+        env.setSampleRate(sampleRate);
+        switch (stage)
+        {
+        case Envelope::Stage::Attack:
+            env.setParameters(forever, forever, 0.8f, forever);
+            env.enterAttack();
+            break;
+        case Envelope::Stage::Decay:
+            env.setParameters(0.001f, forever, 0.8f, forever);
+            env.enterAttack();
+            break;
+        case Envelope::Stage::Sustain:
+        case Envelope::Stage::Release:
+            env.setParameters(0.001f, 0.001f, 0.8f, forever);
+            env.enterAttack();
+            break;
+        case Envelope::Stage::Idle:
+            env.reset();
+            return;
+        }
+
+        // Past the 1 ms segments into the stage being measured
+        for (int i = 0; i < int(sampleRate * 0.01); ++i)
+            env.processSample();
+
+        if (stage == Envelope::Stage::Release)
+            env.enterRelease();
+    }
+
+    void benchEnvelope(Suite &suite, const Config &config, double sampleRate, std::vector<float> &scratch)
+    {
+        const std::pair<Envelope::Stage, const char *> stages[] = {
+            {Envelope::Stage::Idle, "idle"},
+            {Envelope::Stage::Attack, "attack"},
+            {Envelope::Stage::Decay, "decay"},
+            {Envelope::Stage::Sustain, "sustain"},
+            {Envelope::Stage::Release, "release"}};
+
+        for (const auto &[stage, stageName] : stages)
+        {
+            const juce::String prefix = juce::String("envelope/") + stageName;
+            if (!suite.wants(prefix))
+                continue;
+
+            Envelope env;
+            holdEnvelopeIn(env, stage, sampleRate);
+
+            if (suite.wants(prefix + "/sample"))
+                suite.run(prefix + "/sample", sampleRate, 1, 1, 256, [&]
+                          {
+                              float acc = 0.0f;
+                              for (int i = 0; i < 256; ++i)
+                                  acc += env.processSample();
+                              sink = acc; });
+
+            if (suite.wants(prefix + "/block"))
+                for (int block : config.blockSizes)
+                    suite.run(prefix + "/block", sampleRate, block, 1, block, [&]
+                              {
+                                  std::fill(scratch.begin(), scratch.begin() + block, 0.5f);
+                                  env.processBlock(scratch.data(), block);
+                                  sink = scratch[0]; });
+        }
+    }
+
+    void benchFilters(Suite &suite, const Config &config, double sampleRate, std::vector<float> &scratch)
+    {
+        const std::pair<RCFilterType, const char *> types[] = {
+            {RCFilterType::Lowpass, "lowpass"},
+            {RCFilterType::Highpass, "highpass"},
+            {RCFilterType::Bandpass, "bandpass"}};
+
+        // Ruido blanco como entrada: mismo costo para cualquier tipo
+        juce::Random random(1234);
+        std::vector<float> input(4096);
+        for (auto &x : input)
+            x = random.nextFloat() * 2.0f - 1.0f;
+
+        for (const auto &[type, typeName] : types)
+        {
+            const juce::String prefix = juce::String("filter/") + typeName;
+            if (!suite.wants(prefix))
+                continue;
+
+            RCFilter filter;
+            filter.setSampleRate(sampleRate);
+            filter.setType(type);
+            filter.setCutoff(1000.0f);
+
+            if (suite.wants(prefix + "/sample"))
+                suite.run(prefix + "/sample", sampleRate, 1, 1, 256, [&]
+                          {
+                              float acc = 0.0f;
+                              for (int i = 0; i < 256; ++i)
+                                  acc += filter.processSample(input[size_t(i)]);
+                              sink = acc; });
+
+            if (suite.wants(prefix + "/block"))
+                for (int block : config.blockSizes)
+                    suite.run(prefix + "/block", sampleRate, block, 1, block, [&]
+                              {
+                                  std::copy(input.begin(), input.begin() + block, scratch.begin());
+                                  filter.processBlock(scratch.data(), block);
+                                  sink = scratch[0]; });
+
+            if (suite.wants(prefix + "/ramped"))
+                for (int block : config.blockSizes)
+                    suite.run(prefix + "/ramped", sampleRate, block, 1, block, [&]
+                              {
+                                  std::copy(input.begin(), input.begin() + block, scratch.begin());
+                                  filter.processRampedBlock(scratch.data(), block, 1.0f, -1.0e-5f);
+                                  sink = scratch[0]; });
+        }
+    }
+
+    /** @brief SynthEngine with numVoices saw voices, all holding a different note. */
+    void startEngine(SynthEngine &engine, int numVoices, double sampleRate)
+    {
+        engine.clearVoices();
+        auto wavetables = std::make_shared<WavetableSet>(sampleRate); // compartidas, como en el plugin
+        for (int i = 0; i < numVoices; ++i)
+        {
+            auto *voice = new SynthVoice();
+            voice->setWavetables(wavetables);
+            voice->prepare(sampleRate);
+            voice->materializeWave(1);
+            voice->setWaveType(1);
+            voice->setEnvelopeParameters(0.01f, 0.1f, 0.8f, 0.2f);
+            voice->setFilterParameters(1000.0f, RCFilterType::Lowpass);
+            engine.addVoice(voice);
+        }
+        engine.clearSounds();
+        engine.addSound(new BenchSound());
+        engine.setCurrentPlaybackSampleRate(sampleRate);
+        engine.setMaxActiveVoices(numVoices);
+
+        // Notas distintas (7 y 128 son coprimos): el Synthesiser no reutiliza voces
+        for (int i = 0; i < numVoices; ++i)
+            engine.noteOn(1, (24 + i * 7) % 128, 0.8f);
+    }
+
+    void benchVoiceAndEngine(Suite &suite, const Config &config, double sampleRate)
+    {
+        juce::AudioBuffer<float> buffer(2, config.blockSizes.back());
+
+        if (suite.wants("voice"))
+        {
+            SynthEngine engine;
+            startEngine(engine, 1, sampleRate);
+            auto *voice = engine.getVoice(0);
+
+            for (int block : config.blockSizes)
+                suite.run("voice", sampleRate, block, 1, block, [&]
+                          {
+                              buffer.clear(0, block);
+                              voice->renderNextBlock(buffer, 0, block);
+                              sink = buffer.getSample(0, 0); });
+        }
+
+        if (suite.wants("voice/modulated"))
+        {
+            SynthEngine engine;
+            startEngine(engine, 1, sampleRate);
+            auto *voice = static_cast<SynthVoice *>(engine.getVoice(0));
+            voice->setPitchModulation(12.0f, 0.0f, 6.0f, 1.0f); // ±1 st vibrato, crosses banks
+            voice->pitchWheelMoved(12000);
+
+            for (int block : config.blockSizes)
+                suite.run("voice/modulated", sampleRate, block, 1, block, [&]
+                          {
+                              buffer.clear(0, block);
+                              voice->renderNextBlock(buffer, 0, block);
+                              sink = buffer.getSample(0, 0); });
+        }
+
+        if (suite.wants("voice/layers"))
+        {
+            SynthEngine engine;
+            startEngine(engine, 1, sampleRate);
+            auto *voice = static_cast<SynthVoice *>(engine.getVoice(0));
+            for (int wave = 0; wave < OscillatorWrapper::numWaveTypes; ++wave)
+                voice->materializeWave(wave);
+
+            // Las cuatro capas sonando: sub-octava, desafinada y una con sync
+            std::array<OscillatorWrapper::LayerSettings, OscillatorWrapper::numWaveTypes> layers;
+            layers[0] = {0.5f, -1, 0.0f, false};
+            layers[1] = {0.5f, 0, 7.0f, false};
+            layers[2] = {0.3f, 0, -7.0f, false};
+            layers[3] = {0.3f, 1, 5.0f, true};
+            voice->setLayers(true, layers);
+
+            for (int block : config.blockSizes)
+                suite.run("voice/layers", sampleRate, block, 1, block, [&]
+                          {
+                              buffer.clear(0, block);
+                              voice->renderNextBlock(buffer, 0, block);
+                              sink = buffer.getSample(0, 0); });
+        }
+
+        if (suite.wants("engine"))
+        {
+            for (int voices : config.voiceCounts)
+            {
+                SynthEngine engine;
+                startEngine(engine, voices, sampleRate);
+                juce::MidiBuffer noMidi;
+
+                for (int block : config.blockSizes)
+                    suite.run("engine", sampleRate, block, voices, block, [&]
+                              {
+                                  buffer.clear(0, block);
+                                  engine.renderNextBlock(buffer, noMidi, 0, block);
+                                  sink = buffer.getSample(0, 0); });
+            }
+        }
+
+        if (suite.wants("engine/paraphonic"))
+        {
+            for (int voices : config.voiceCounts)
+            {
+                SynthEngine engine;
+                startEngine(engine, voices, sampleRate);
+                for (int i = 0; i < engine.getNumVoices(); ++i)
+                    static_cast<SynthVoice *>(engine.getVoice(i))->setFilterEnabled(false);
+                engine.setSharedFilterParameters(RCFilterType::Lowpass, 1000.0f);
+                engine.setParaphonicFilter(true);
+                juce::MidiBuffer noMidi;
+
+                for (int block : config.blockSizes)
+                    suite.run("engine/paraphonic", sampleRate, block, voices, block, [&]
+                              {
+                                  buffer.clear(0, block);
+                                  engine.renderNextBlock(buffer, noMidi, 0, block);
+                                  sink = buffer.getSample(0, 0); });
+            }
+        }
+
+        if (suite.wants("engine/sustain-cache"))
+        {
+            for (int voices : config.voiceCounts)
+            {
+                SynthEngine engine;
+                startEngine(engine, voices, sampleRate);
+                for (int i = 0; i < engine.getNumVoices(); ++i)
+                    static_cast<SynthVoice *>(engine.getVoice(i))->setSustainCacheEnabled(true);
+                juce::MidiBuffer noMidi;
+
+                for (int block : config.blockSizes)
+                    suite.run("engine/sustain-cache", sampleRate, block, voices, block, [&]
+                              {
+                                  buffer.clear(0, block);
+                                  engine.renderNextBlock(buffer, noMidi, 0, block);
+                                  sink = buffer.getSample(0, 0); });
+            }
+        }
+
+        if (suite.wants("engine/fm"))
+        {
+            // Seis operadores sonando (dos pilas de tres), feedback en el 6
+            std::array<FMOscillator::OperatorSettings, FMOscillator::numOperators> operators;
+            for (int k = 0; k < FMOscillator::numOperators; ++k)
+                operators[size_t(k)] = {float(k % 3 + 1), k % 3 == 0 ? 0.8f : 0.4f, 0.0f};
+            operators[5].feedback = 0.5f;
+
+            for (int voices : config.voiceCounts)
+            {
+                SynthEngine engine;
+                startEngine(engine, voices, sampleRate);
+                for (int i = 0; i < engine.getNumVoices(); ++i)
+                    static_cast<SynthVoice *>(engine.getVoice(i))->setFM(true, 1, operators, 1.0f, 0.5f);
+                juce::MidiBuffer noMidi;
+
+                for (int block : config.blockSizes)
+                    suite.run("engine/fm", sampleRate, block, voices, block, [&]
+                              {
+                                  buffer.clear(0, block);
+                                  engine.renderNextBlock(buffer, noMidi, 0, block);
+                                  sink = buffer.getSample(0, 0); });
+            }
+        }
+
+        if (suite.wants("engine/additive"))
+        {
+            const AdditiveOscillator::Settings additive; // 64 parciales, decaimiento por defecto
+            for (int voices : config.voiceCounts)
+            {
+                SynthEngine engine;
+                startEngine(engine, voices, sampleRate);
+                for (int i = 0; i < engine.getNumVoices(); ++i)
+                    static_cast<SynthVoice *>(engine.getVoice(i))->setAdditive(true, additive);
+                juce::MidiBuffer noMidi;
+
+                for (int block : config.blockSizes)
+                    suite.run("engine/additive", sampleRate, block, voices, block, [&]
+                              {
+                                  buffer.clear(0, block);
+                                  engine.renderNextBlock(buffer, noMidi, 0, block);
+                                  sink = buffer.getSample(0, 0); });
+            }
+        }
+
+        if (suite.wants("engine/wavetable"))
+        {
+            const auto table = makeUserWavetable(); // vive más que las voces que la leen
+            for (int voices : config.voiceCounts)
+            {
+                SynthEngine engine;
+                startEngine(engine, voices, sampleRate);
+                for (int i = 0; i < engine.getNumVoices(); ++i)
+                {
+                    auto *voice = static_cast<SynthVoice *>(engine.getVoice(i));
+                    voice->setUserWavetable(table.get());
+                    voice->setUserWavetableMode(true, 0.5f);
+                }
+                juce::MidiBuffer noMidi;
+
+                for (int block : config.blockSizes)
+                    suite.run("engine/wavetable", sampleRate, block, voices, block, [&]
+                              {
+                                  buffer.clear(0, block);
+                                  engine.renderNextBlock(buffer, noMidi, 0, block);
+                                  sink = buffer.getSample(0, 0); });
+            }
+        }
+    }
+
+    void benchProcessor(Suite &suite, const Config &config, double sampleRate)
+    {
+        if (!suite.wants("processor"))
+            return;
+
+        int lastVoices = 0;
+        for (int requested : config.voiceCounts)
+        {
+            const int voices = juce::jmin(requested, 8); // polifonía fija del processor
+            if (voices == lastVoices)
+                continue;
+            lastVoices = voices;
+
+            AudioPluginAudioProcessor processor;
+
+            // Sin governor: el benchmark mide siempre el mismo trabajo
+            processor.setNonRealtime(true);
+            processor.setPlayConfigDetails(0, 2, sampleRate, config.blockSizes.back());
+            if (auto *wave = processor.apvts.getParameter("WAVE"))
+                wave->setValueNotifyingHost(wave->convertTo0to1(1.0f));
+            processor.prepareToPlay(sampleRate, config.blockSizes.back());
+
+            juce::AudioBuffer<float> buffer(2, config.blockSizes.back());
+            juce::MidiBuffer midi;
+            for (int i = 0; i < voices; ++i)
+                midi.addEvent(juce::MidiMessage::noteOn(1, 36 + i * 5, 0.8f), 0);
+            processor.processBlock(buffer, midi);
+            midi.clear();
+
+            for (int block : config.blockSizes)
+            {
+                juce::AudioBuffer<float> view(buffer.getArrayOfWritePointers(), 2, block);
+                suite.run("processor", sampleRate, block, voices, block, [&]
+                          {
+                              processor.processBlock(view, midi);
+                              sink = view.getSample(0, 0); });
+            }
+        }
+    }
+
+    juce::var describeMachine(const Config &config)
+    {
+        auto *meta = new juce::DynamicObject();
+        meta->setProperty("tool", "TECBenchmarks");
+        meta->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+        meta->setProperty("cpu", juce::SystemStats::getCpuModel());
+        meta->setProperty("numCpus", juce::SystemStats::getNumCpus());
+        meta->setProperty("os", juce::SystemStats::getOperatingSystemName());
+        meta->setProperty("kernels", KernelDispatch::get().name);
+        meta->setProperty("wavetableFormat", int(WavetableOscillator::defaultTableFormat));
+#if JUCE_DEBUG
+        meta->setProperty("build", "debug");
+#else
+        meta->setProperty("build", "release");
+#endif
+        meta->setProperty("minSeconds", config.minSeconds);
+        return juce::var(meta);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    Config config;
+    if (const auto v = args.getValueForOption("--min-time"); v.isNotEmpty())
+        config.minSeconds = juce::jmax(0.001, v.getDoubleValue());
+    config.filter = args.getValueForOption("--filter");
+
+    if (args.containsOption("--quick"))
+    {
+        config.sampleRates = {48000.0};
+        config.blockSizes = {64, 512};
+        config.voiceCounts = {1, 8, 32};
+    }
+
+    Suite suite(config);
+    std::vector<float> scratch(size_t(config.blockSizes.back()));
+
+    for (double sampleRate : config.sampleRates)
+    {
+        benchOscillators(suite, config, sampleRate, scratch);
+        benchEnvelope(suite, config, sampleRate, scratch);
+        benchFilters(suite, config, sampleRate, scratch);
+        benchVoiceAndEngine(suite, config, sampleRate);
+        benchProcessor(suite, config, sampleRate);
+    }
+
+    auto *root = new juce::DynamicObject();
+    root->setProperty("meta", describeMachine(config));
+    root->setProperty("results", suite.results);
+    const auto json = juce::JSON::toString(juce::var(root));
+
+    const auto outArg = args.getValueForOption("--out");
+    if (outArg.isNotEmpty())
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(outArg);
+        if (!file.replaceWithText(json))
+        {
+            std::fprintf(stderr, "cannot write %s\n", file.getFullPathName().toRawUTF8());
+            return 1;
+        }
+        std::fprintf(stderr, "%d results written to %s\n", suite.results.size(), file.getFullPathName().toRawUTF8());
+    }
+    else
+    {
+        std::printf("%s\n", json.toRawUTF8());
+    }
+    return 0;
+}
@@ -0,0 +1,448 @@
+/**
+ * @file GoldenCheck.cpp
+ * @brief Replays the MATLAB golden vectors through the C++ DSP and reports the error.
+ *
+ * MATLAB/export_reference.m runs the reference models (adsr_envelope.m,
+ * filter_block.m, sine/saw/square/triangle.m) and writes one .ref file per
+ * case to MATLAB/reference/. This tool feeds the same parameters and inputs
+ * to the C++ classes and compares sample by sample:
+ *  - envelope:  Envelope::processSample() and Envelope::processBlock()
+ *  - filter:    RCFilter::processSample() and RCFilter::processBlock()
+ *  - wavetable: the band-limited tables of Sine and Saw, and one rendered
+ *               cycle per bank of Square and Triangle (derived from saw reads)
+ * Block paths go through KernelDispatch, so a kernel change is checked on
+ * the ISA of the machine running the tool.
+ *
+ * Each case prints the max absolute and RMS error and PASS/FAIL against its
+ * tolerance (from the file, overridable per kind). A "deviation" line
+ * documents why a case differs from the model, and "deviationMaxError" /
+ * "deviationRmsError" bound the expected difference: within them the case is
+ * reported as KNOWN, above them it fails as any other case. A deviation
+ * without bounds fails unless --allow-deviations, which also accepts any
+ * error beyond the bounds. The exit code is 1 if any case fails or no
+ * reference files are found; CMake registers the tool as the TECGoldenCheck
+ * ctest.
+ *
+ * Usage:
+ *   TECGoldenCheck [--reference-dir=DIR] [--allow-deviations]
+ *                  [--tolerance=X] [--envelope-tolerance=X]
+ *                  [--filter-tolerance=X] [--wavetable-tolerance=X]
+ */
+
+#include <JuceHeader.h>
+#include "Envelope.h"
+#include "Filter/RCFilter.h"
+#include "Oscillator/Waves/Sine.h"
+#include "Oscillator/Waves/Saw.h"
+#include "Oscillator/Waves/Square.h"
+#include "Oscillator/Waves/Triangle.h"
+#include "DSP/KernelDispatch.h"
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    /** @brief One case: header values plus the data columns. */
+    struct Reference
+    {
+        juce::String name;
+        juce::StringPairArray header;
+        std::vector<std::vector<double>> columns;
+
+        juce::String get(const juce::String &key) const { return header.getValue(key, {}); }
+        double getDouble(const juce::String &key) const { return get(key).getDoubleValue(); }
+        size_t numRows() const { return columns.empty() ? 0 : columns[0].size(); }
+    };
+
+    /** @brief Error of one C++ path against the reference column. */
+    struct Comparison
+    {
+        juce::String path;
+        double maxAbsError = 0.0;
+        double rmsError = 0.0;
+        long firstFailure = -1;
+        double got = 0.0;
+        double expected = 0.0;
+    };
+
+    Comparison compare(const juce::String &path, const std::vector<float> &got,
+                       const std::vector<double> &expected, double tolerance)
+    {
+        Comparison c;
+        c.path = path;
+        double sumSquares = 0.0;
+
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            const double value = i < got.size() ? double(got[i]) : std::numeric_limits<double>::quiet_NaN();
+            // 0/0 in a model (a bank with no harmonics) matches a NaN or silence
+            double error = std::isnan(expected[i]) && (std::isnan(value) || std::abs(value) <= tolerance)
+                               ? 0.0
+                               : std::abs(value - expected[i]);
+            if (std::isnan(error))
+                error = std::numeric_limits<double>::infinity();
+
+            c.maxAbsError = std::max(c.maxAbsError, error);
+            sumSquares += error * error;
+
+            if (error > tolerance && c.firstFailure < 0)
+            {
+                c.firstFailure = long(i);
+                c.got = value;
+                c.expected = expected[i];
+            }
+        }
+
+        c.rmsError = expected.empty() ? 0.0 : std::sqrt(sumSquares / double(expected.size()));
+        return c;
+    }
+
+    //==========================================================================
+    // Reference files
+
+    bool parseReference(const juce::File &file, Reference &ref, juce::String &error)
+    {
+        juce::StringArray lines;
+        file.readLines(lines);
+        ref.name = file.getFileNameWithoutExtension();
+
+        int line = 0;
+        for (; line < lines.size(); ++line)
+        {
+            const auto text = lines[line].trim();
+            if (text.isEmpty() || text.startsWithChar('#'))
+                continue;
+
+            const auto key = text.upToFirstOccurrenceOf(" ", false, false);
+            const auto value = text.fromFirstOccurrenceOf(" ", false, false).trim();
+
+            if (key == "data")
+            {
+                ref.columns.assign(size_t(juce::jmax(1, value.getIntValue())), {});
+                ++line;
+                break;
+            }
+            if (key == "name")
+                ref.name = value;
+            ref.header.set(key, value);
+        }
+
+        if (ref.columns.empty())
+        {
+            error = "no data section";
+            return false;
+        }
+
+        for (; line < lines.size(); ++line)
+        {
+            const auto text = lines[line].trim();
+            if (text.isEmpty() || text.startsWithChar('#'))
+                continue;
+
+            const char *p = text.toRawUTF8();
+            for (auto &column : ref.columns)
+            {
+                char *end = nullptr;
+                const double v = std::strtod(p, &end);
+                if (end == p)
+                {
+                    error = "bad data row " + juce::String(line + 1);
+                    return false;
+                }
+                column.push_back(v);
+                p = end;
+            }
+        }
+        return true;
+    }
+
+    /** @brief MATLAB/reference, searched upwards from the working directory and the executable. */
+    juce::File findReferenceDirectory()
+    {
+        for (auto start : {juce::File::getCurrentWorkingDirectory(),
+                           juce::File::getSpecialLocation(juce::File::currentExecutableFile).getParentDirectory()})
+        {
+            for (auto dir = start; dir.exists(); dir = dir.getParentDirectory())
+            {
+                const auto candidate = dir.getChildFile("MATLAB").getChildFile("reference");
+                if (candidate.isDirectory())
+                    return candidate;
+                if (dir.isRoot())
+                    break;
+            }
+        }
+        return {};
+    }
+
+    //==========================================================================
+    // C++ side
+
+    /** @brief Gives the tool read access to the generated banks. */
+    template <typename Wave>
+    struct TableProbe : Wave
+    {
+        using Wave::Wave;
+        const std::vector<std::vector<float>> &tables() const { return this->floatTables(); }
+    };
+
+    template <typename Wave>
+    std::vector<std::vector<float>> wavetablesOf(double fs)
+    {
+        return TableProbe<Wave>(fs, 1.0f).tables();
+    }
+
+    /**
+     * @brief One rendered cycle per bank for waveforms without tables of their own.
+     *
+     * Square and Triangle are phase differences of saw / integrated-saw reads,
+     * so they are compared on what the oscillator outputs when played at each
+     * bank's center with the bank's own cycle length.
+     */
+    template <typename Wave>
+    std::vector<std::vector<float>> derivedCyclesOf(double fs)
+    {
+        Wave osc(fs, 1.0f);
+        std::vector<std::vector<float>> cycles;
+        for (double bankFreq : osc.getBankFrequencies())
+        {
+            const int ns = int(std::round(fs / bankFreq));
+            std::vector<float> cycle(size_t(ns), 0.0f);
+            osc.resetPhase();
+            osc.setFrequencyAndDelta(bankFreq, 1.0 / ns);
+            osc.renderBlock(cycle.data(), ns);
+            cycles.push_back(std::move(cycle));
+        }
+        return cycles;
+    }
+
+    std::vector<Comparison> runEnvelope(const Reference &ref, double tolerance)
+    {
+        const double fs = ref.getDouble("sampleRate");
+        const int gate = ref.get("gate").getIntValue();
+        const size_t total = ref.numRows();
+
+        Envelope env;
+        env.setSampleRate(fs);
+        env.setParameters(float(ref.getDouble("attack")), float(ref.getDouble("decay")),
+                          float(ref.getDouble("sustain")), float(ref.getDouble("release")));
+
+        std::vector<float> perSample(total);
+        env.enterAttack();
+        for (size_t i = 0; i < total; ++i)
+        {
+            if (long(i) == gate)
+                env.enterRelease();
+            perSample[i] = env.processSample();
+        }
+
+        // Mismo corte que el sintetizador: note-off entre bloques, bloques de 256
+        std::vector<float> perBlock(total, 1.0f);
+        env.reset();
+        env.enterAttack();
+        for (size_t pos = 0; pos < total;)
+        {
+            if (long(pos) == gate)
+                env.enterRelease();
+            const size_t limit = long(pos) < gate ? size_t(gate) : total;
+            const size_t n = std::min({limit - pos, total - pos, size_t(256)});
+            env.processBlock(perBlock.data() + pos, int(n));
+            pos += n;
+        }
+
+        return {compare("sample", perSample, ref.columns[0], tolerance),
+                compare("block", perBlock, ref.columns[0], tolerance)};
+    }
+
+    std::vector<Comparison> runFilter(const Reference &ref, double tolerance)
+    {
+        if (ref.columns.size() < 2)
+            return {};
+
+        const auto typeName = ref.get("type");
+        const auto type = typeName == "highpass"   ? RCFilterType::Highpass
+                          : typeName == "bandpass" ? RCFilterType::Bandpass
+                                                   : RCFilterType::Lowpass;
+        const int blockSize = juce::jmax(1, ref.get("blockSize").getIntValue());
+        const auto &x = ref.columns[0];
+
+        RCFilter filter;
+        filter.setSampleRate(ref.getDouble("sampleRate"));
+        filter.setType(type);
+        filter.setCutoff(float(ref.getDouble("cutoff")));
+
+        std::vector<float> perSample(x.size());
+        for (size_t i = 0; i < x.size(); ++i)
+            perSample[i] = filter.processSample(float(x[i]));
+
+        std::vector<float> perBlock(x.begin(), x.end());
+        filter.reset();
+        for (size_t pos = 0; pos < perBlock.size(); pos += size_t(blockSize))
+            filter.processBlock(perBlock.data() + pos, int(std::min(perBlock.size() - pos, size_t(blockSize))));
+
+        return {compare("sample", perSample, ref.columns[1], tolerance),
+                compare("block", perBlock, ref.columns[1], tolerance)};
+    }
+
+    std::vector<Comparison> runWavetable(const Reference &ref, double tolerance)
+    {
+        if (ref.columns.size() < 2)
+            return {};
+
+        const double fs = ref.getDouble("sampleRate");
+        const auto wave = ref.get("wave");
+        const auto tables = wave == "sine"     ? wavetablesOf<Sine>(fs)
+                            : wave == "saw"    ? wavetablesOf<Saw>(fs)
+                            : wave == "square" ? derivedCyclesOf<Square>(fs)
+                                               : derivedCyclesOf<Triangle>(fs);
+
+        // Filas (banco, valor): se lee el banco en orden; un banco o largo distinto da NaN
+        std::vector<float> got(ref.numRows(), std::numeric_limits<float>::quiet_NaN());
+        std::vector<size_t> next(tables.size(), 0);
+        for (size_t row = 0; row < got.size(); ++row)
+        {
+            const auto bank = size_t(ref.columns[0][row]);
+            if (bank < tables.size() && next[bank] < tables[bank].size())
+                got[row] = tables[bank][next[bank]++];
+        }
+
+        return {compare("tables", got, ref.columns[1], tolerance)};
+    }
+
+    struct Options
+    {
+        double tolerance = 0.0; ///< 0: per-file tolerance
+        juce::StringPairArray kindTolerance;
+        bool allowDeviations = false;
+    };
+
+    /** @brief Runs one case and prints its lines; returns false if it fails the run. */
+    bool check(const Reference &ref, const Options &options, int &numPassed, int &numFailed, int &numDeviations)
+    {
+        const auto kind = ref.get("kind");
+        double tolerance = ref.get("tolerance").isNotEmpty() ? ref.getDouble("tolerance") : 1e-5;
+        if (options.tolerance > 0.0)
+            tolerance = options.tolerance;
+        if (const auto v = options.kindTolerance.getValue(kind, {}); v.isNotEmpty())
+            tolerance = v.getDoubleValue();
+
+        std::vector<Comparison> results;
+        if (kind == "envelope")
+            results = runEnvelope(ref, tolerance);
+        else if (kind == "filter")
+            results = runFilter(ref, tolerance);
+        else if (kind == "wavetable")
+            results = runWavetable(ref, tolerance);
+
+        if (results.empty())
+        {
+            std::printf("%-34s unknown kind or missing columns, skipped\n", ref.name.toRawUTF8());
+            ++numFailed;
+            return false;
+        }
+
+        const auto deviation = ref.get("deviation");
+        const bool bounded = ref.get("deviationMaxError").isNotEmpty() && ref.get("deviationRmsError").isNotEmpty();
+        bool ok = true;
+
+        for (const auto &r : results)
+        {
+            const bool pass = r.firstFailure < 0;
+            const bool withinBounds = bounded && r.maxAbsError <= ref.getDouble("deviationMaxError")
+                                      && r.rmsError <= ref.getDouble("deviationRmsError");
+            const bool known = deviation.isNotEmpty() && (withinBounds || options.allowDeviations);
+            const char *verdict = pass ? "PASS" : (known ? "KNOWN" : "FAIL");
+            std::printf("%-34s %-7s max %.3e  rms %.3e  tol %.0e  %s\n",
+                        ref.name.toRawUTF8(), r.path.toRawUTF8(), r.maxAbsError, r.rmsError, tolerance, verdict);
+
+            if (!pass)
+                std::printf("%-34s         first at %ld: got %.9g, expected %.9g\n",
+                            "", r.firstFailure, r.got, r.expected);
+
+            if (pass)
+                ++numPassed;
+            else if (known)
+                ++numDeviations;
+            else
+            {
+                ++numFailed;
+                ok = false;
+            }
+        }
+
+        if (deviation.isNotEmpty())
+        {
+            std::printf("%-34s         known deviation: %s\n", "", deviation.toRawUTF8());
+            if (bounded)
+                std::printf("%-34s         expected within max %.3e  rms %.3e\n", "",
+                            ref.getDouble("deviationMaxError"), ref.getDouble("deviationRmsError"));
+        }
+
+        return ok;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::printf("Usage: TECGoldenCheck [--reference-dir=DIR] [--allow-deviations]\n"
+                    "                      [--tolerance=X] [--envelope-tolerance=X]\n"
+                    "                      [--filter-tolerance=X] [--wavetable-tolerance=X]\n");
+        return 0;
+    }
+
+    Options options;
+    options.allowDeviations = args.containsOption("--allow-deviations");
+    if (const auto v = args.getValueForOption("--tolerance"); v.isNotEmpty())
+        options.tolerance = v.getDoubleValue();
+    for (const char *kind : {"envelope", "filter", "wavetable"})
+        if (const auto v = args.getValueForOption(juce::String("--") + kind + "-tolerance"); v.isNotEmpty())
+            options.kindTolerance.set(kind, v);
+
+    const auto dirArg = args.getValueForOption("--reference-dir");
+    const auto dir = dirArg.isNotEmpty() ? juce::File::getCurrentWorkingDirectory().getChildFile(dirArg)
+                                         : findReferenceDirectory();
+
+    auto files = dir.isDirectory() ? dir.findChildFiles(juce::File::findFiles, false, "*.ref")
+                                   : juce::Array<juce::File>();
+    files.sort();
+
+    std::vector<Reference> refs;
+    for (const auto &file : files)
+    {
+        Reference ref;
+        juce::String error;
+        if (!parseReference(file, ref, error))
+        {
+            std::fprintf(stderr, "%s: %s\n", file.getFullPathName().toRawUTF8(), error.toRawUTF8());
+            return 1;
+        }
+        refs.push_back(std::move(ref));
+    }
+
+    if (refs.empty())
+    {
+        std::fprintf(stderr, "No reference vectors in %s; run MATLAB/export_reference.m to create them.\n",
+                     dir.getFullPathName().isNotEmpty() ? dir.getFullPathName().toRawUTF8() : "MATLAB/reference");
+        return 1;
+    }
+
+    std::printf("TEC Synth golden check: %d case(s) from %s, kernels %s\n\n",
+                int(refs.size()), dir.getFullPathName().toRawUTF8(), KernelDispatch::get().name);
+
+    int numPassed = 0, numFailed = 0, numDeviations = 0;
+    for (const auto &ref : refs)
+        check(ref, options, numPassed, numFailed, numDeviations);
+
+    std::printf("\n%d passed, %d failed, %d known deviation(s)%s\n",
+                numPassed, numFailed, numDeviations, options.allowDeviations ? " (deviations allowed)" : "");
+    return numFailed > 0 ? 1 : 0;
+}
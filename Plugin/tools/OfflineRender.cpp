@@ -0,0 +1,422 @@
+/**
+ * @file OfflineRender.cpp
+ * @brief Renders Standard MIDI Files or MATLAB melody files to WAV with the plugin's DSP, headless.
+ *
+ * Every input file gets its own AudioPluginAudioProcessor, driven block by
+ * block with setNonRealtime(true) (the quality governor stays off), so the
+ * output is exactly what the plugin renders offline in a host. No GUI and no
+ * audio device are opened.
+ *
+ * Inputs:
+ *  - .mid / .midi: all tracks are merged; tempo changes are honoured.
+ *  - anything else: the `note velocity duration` rows used in MATLAB/melodies/.
+ *    Each `name = [ ... ];` block is one monophonic line starting at time 0
+ *    (blocks play together, like the voices in MATLAB/engine.m). Note 0 is a
+ *    rest, velocity is 0..1, duration is in seconds, `%` starts a comment.
+ *    A file without brackets is read as a single line.
+ *
+ * Files are rendered in parallel on a juce::ThreadPool, one file per job. For
+ * each file the tool prints the real-time factor of processBlock alone and
+ * including WAV writing, the output peak, the peak polyphony and the peak
+ * memory of its plugin instance; --memory adds the per-subsystem breakdown
+ * (MemoryUsage) and --voices the voice activity counters (VoiceTelemetry:
+ * steals, time per envelope stage, note-on to onset delay, oldest voice).
+ *
+ * Usage:
+ *   TECOfflineRender [--preset=NAME|INDEX] [--state=FILE] [--tuning=FILE.scl]
+ *                    [--sample-rate=HZ] [--block-size=N] [--tail=S] [--jobs=N]
+ *                    [--out-dir=DIR] [--memory] [--voices] input...
+ */
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    struct Settings
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        double tailSeconds = 2.0;
+        juce::String preset;
+        juce::File stateFile;
+        juce::File tuningFile;
+        juce::File outputDirectory;
+    };
+
+    struct RenderResult
+    {
+        juce::File input;
+        juce::File output;
+        juce::String error;
+        double audioSeconds = 0.0;
+        double renderSeconds = 0.0; ///< processBlock only.
+        double totalSeconds = 0.0;  ///< Including event setup and WAV writing.
+        float peak = 0.0f;
+        MemoryUsage memory; ///< Of this file's processor, after rendering.
+        VoiceTelemetry::Snapshot voices; ///< Voice activity over the whole file.
+    };
+
+    /** @brief Reads a MIDI file into one sequence with timestamps in seconds. */
+    bool loadMidiFile(const juce::File &file, juce::MidiMessageSequence &sequence, juce::String &error)
+    {
+        juce::FileInputStream stream(file);
+        juce::MidiFile midiFile;
+        if (!stream.openedOk() || !midiFile.readFrom(stream))
+        {
+            error = "cannot read MIDI file";
+            return false;
+        }
+
+        if (midiFile.getTimeFormat() <= 0)
+        {
+            error = "SMPTE time format is not supported";
+            return false;
+        }
+
+        midiFile.convertTimestampTicksToSeconds();
+        for (int track = 0; track < midiFile.getNumTracks(); ++track)
+            sequence.addSequence(*midiFile.getTrack(track), 0.0);
+
+        sequence.sort();
+        return true;
+    }
+
+    /** @brief Appends one `note velocity duration` row to a melody line. */
+    bool addMelodyRow(const juce::String &row, int channel, double &time,
+                      juce::MidiMessageSequence &sequence, juce::String &error)
+    {
+        juce::StringArray values;
+        values.addTokens(row, " \t,", "");
+        values.removeEmptyStrings();
+        if (values.isEmpty())
+            return true;
+
+        if (values.size() != 3)
+        {
+            error = "expected `note velocity duration`, got: " + row.trim();
+            return false;
+        }
+
+        const int note = values[0].getIntValue();
+        const float velocity = juce::jlimit(0.0f, 1.0f, values[1].getFloatValue());
+        const double duration = values[2].getDoubleValue();
+        if (!juce::isPositiveAndBelow(note, 128) || duration < 0.0)
+        {
+            error = "invalid note or duration: " + row.trim();
+            return false;
+        }
+
+        if (note > 0 && velocity > 0.0f)
+        {
+            sequence.addEvent(juce::MidiMessage::noteOn(channel, note, velocity).withTimeStamp(time));
+            sequence.addEvent(juce::MidiMessage::noteOff(channel, note).withTimeStamp(time + duration));
+        }
+
+        time += duration;
+        return true;
+    }
+
+    /** @brief Reads a MATLAB/melodies file; each bracketed matrix is a line starting at 0 s. */
+    bool loadMelodyFile(const juce::File &file, juce::MidiMessageSequence &sequence, juce::String &error)
+    {
+        const auto text = file.loadFileAsString();
+        const bool hasBlocks = text.containsChar('[');
+
+        bool inBlock = !hasBlocks;
+        int numLines = hasBlocks ? 0 : 1;
+        double time = 0.0;
+
+        for (auto line : juce::StringArray::fromLines(text))
+        {
+            line = line.upToFirstOccurrenceOf("%", false, false);
+
+            if (hasBlocks && !inBlock)
+            {
+                if (!line.containsChar('['))
+                    continue;
+
+                inBlock = true;
+                ++numLines;
+                time = 0.0;
+                line = line.fromFirstOccurrenceOf("[", false, false);
+            }
+
+            const bool endsBlock = hasBlocks && line.containsChar(']');
+            if (endsBlock)
+                line = line.upToFirstOccurrenceOf("]", false, false);
+
+            juce::StringArray rows;
+            rows.addTokens(line, ";", "");
+            for (const auto &row : rows)
+                if (!addMelodyRow(row, 1, time, sequence, error))
+                    return false;
+
+            if (endsBlock)
+                inBlock = false;
+        }
+
+        if (numLines == 0 || sequence.getNumEvents() == 0)
+        {
+            error = "no notes found";
+            return false;
+        }
+
+        sequence.sort();
+        return true;
+    }
+
+    /** @brief Applies --state, --preset and --tuning to a fresh processor. */
+    bool configure(AudioPluginAudioProcessor &processor, const Settings &settings, juce::String &error)
+    {
+        if (settings.stateFile != juce::File())
+        {
+            juce::MemoryBlock state;
+            if (!settings.stateFile.loadFileAsData(state))
+            {
+                error = "cannot read state file " + settings.stateFile.getFullPathName();
+                return false;
+            }
+            processor.setStateInformation(state.getData(), int(state.getSize()));
+        }
+
+        if (settings.preset.isNotEmpty())
+        {
+            int program = -1;
+            if (settings.preset.containsOnly("0123456789"))
+                program = settings.preset.getIntValue();
+            else
+                for (int i = 0; i < processor.getNumPrograms() && program < 0; ++i)
+                    if (processor.getProgramName(i).equalsIgnoreCase(settings.preset))
+                        program = i;
+
+            if (!juce::isPositiveAndBelow(program, processor.getNumPrograms()))
+            {
+                error = "unknown preset " + settings.preset;
+                return false;
+            }
+            processor.setCurrentProgram(program);
+        }
+
+        if (settings.tuningFile != juce::File())
+        {
+            juce::String tuningError;
+            if (!processor.loadTuningFile(settings.tuningFile, &tuningError))
+            {
+                error = "tuning: " + tuningError;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /** @brief Renders one input with an already configured and prepared processor. */
+    void render(AudioPluginAudioProcessor &processor, const Settings &settings, RenderResult &result)
+    {
+        const double start = juce::Time::getMillisecondCounterHiRes();
+
+        juce::MidiMessageSequence sequence;
+        const auto extension = result.input.getFileExtension().toLowerCase();
+        const bool loaded = extension == ".mid" || extension == ".midi"
+                                ? loadMidiFile(result.input, sequence, result.error)
+                                : loadMelodyFile(result.input, sequence, result.error);
+        if (!loaded)
+            return;
+
+        const double fs = settings.sampleRate;
+        const auto totalSamples = juce::int64(std::ceil((sequence.getEndTime() + settings.tailSeconds) * fs));
+
+        result.output.deleteFile();
+        std::unique_ptr<juce::OutputStream> stream(result.output.createOutputStream());
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        if (stream != nullptr)
+            writer.reset(wav.createWriterFor(stream.get(), fs, 2, 24, {}, 0));
+        if (writer == nullptr)
+        {
+            result.error = "cannot write " + result.output.getFullPathName();
+            return;
+        }
+        stream.release(); // owned by the writer
+
+        juce::AudioBuffer<float> buffer(2, settings.blockSize);
+        juce::MidiBuffer midi;
+        int nextEvent = 0;
+
+        for (juce::int64 position = 0; position < totalSamples; position += settings.blockSize)
+        {
+            const int numSamples = int(juce::jmin(juce::int64(settings.blockSize), totalSamples - position));
+
+            midi.clear();
+            for (; nextEvent < sequence.getNumEvents(); ++nextEvent)
+            {
+                const auto &message = sequence.getEventPointer(nextEvent)->message;
+                const auto sample = juce::int64(std::llround(message.getTimeStamp() * fs));
+                if (sample >= position + numSamples)
+                    break;
+
+                if (message.isNoteOnOrOff() || message.isController() || message.isPitchWheel())
+                    midi.addEvent(message, int(juce::jmax(juce::int64(0), sample - position)));
+            }
+
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, numSamples);
+
+            const double blockStart = juce::Time::getMillisecondCounterHiRes();
+            {
+                // Como un host: los cambios del hilo de mensajes y del constructor de tablas se serializan con el bloque
+                const juce::ScopedLock sl(processor.getCallbackLock());
+                processor.processBlock(block, midi);
+            }
+            result.renderSeconds += (juce::Time::getMillisecondCounterHiRes() - blockStart) * 0.001;
+
+            result.peak = juce::jmax(result.peak, block.getMagnitude(0, numSamples));
+            writer->writeFromAudioSampleBuffer(block, 0, numSamples);
+        }
+
+        writer.reset();
+        result.audioSeconds = double(totalSamples) / fs;
+        result.totalSeconds = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+        result.memory = processor.getMemoryUsage();
+        result.voices = processor.getVoiceTelemetrySnapshot();
+    }
+
+    juce::File resolve(const juce::String &path)
+    {
+        return juce::File::getCurrentWorkingDirectory().getChildFile(path.unquoted());
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    Settings settings;
+    const auto option = [&args](const char *name)
+    { return args.removeValueForOption(name); };
+
+    if (const auto v = option("--sample-rate"); v.isNotEmpty())
+        settings.sampleRate = juce::jmax(8000.0, v.getDoubleValue());
+    if (const auto v = option("--block-size"); v.isNotEmpty())
+        settings.blockSize = juce::jmax(1, v.getIntValue());
+    if (const auto v = option("--tail"); v.isNotEmpty())
+        settings.tailSeconds = juce::jmax(0.0, v.getDoubleValue());
+    if (const auto v = option("--state"); v.isNotEmpty())
+        settings.stateFile = resolve(v);
+    if (const auto v = option("--tuning"); v.isNotEmpty())
+        settings.tuningFile = resolve(v);
+    settings.preset = option("--preset");
+    const bool showMemory = args.removeOptionIfFound("--memory");
+    const bool showVoices = args.removeOptionIfFound("--voices");
+
+    const auto jobsArg = option("--jobs");
+    const int numJobs = jobsArg.isNotEmpty() ? juce::jmax(1, jobsArg.getIntValue())
+                                             : juce::SystemStats::getNumCpus();
+
+    const auto outArg = option("--out-dir");
+    settings.outputDirectory = outArg.isNotEmpty() ? resolve(outArg) : juce::File::getCurrentWorkingDirectory();
+    settings.outputDirectory.createDirectory();
+
+    std::vector<RenderResult> results;
+    for (const auto &arg : args.arguments)
+    {
+        RenderResult r;
+        r.input = resolve(arg.text);
+        r.output = settings.outputDirectory.getChildFile(r.input.getFileNameWithoutExtension() + ".wav");
+        results.push_back(r);
+    }
+
+    if (results.empty())
+    {
+        std::printf("Usage: TECOfflineRender [--preset=NAME|INDEX] [--state=FILE] [--tuning=FILE.scl]\n"
+                    "                        [--sample-rate=HZ] [--block-size=N] [--tail=S] [--jobs=N]\n"
+                    "                        [--out-dir=DIR] [--memory] [--voices] input.mid|melody.txt ...\n");
+        return 1;
+    }
+
+    std::printf("TEC Synth offline render: %d file(s), %.0f Hz, %d samples/block, %d job(s)\n\n",
+                int(results.size()), settings.sampleRate, settings.blockSize, numJobs);
+
+    // Los processors se construyen y preparan en el hilo principal (APVTS,
+    // timers); solo el render corre en el pool. Se procesa por tandas de
+    // numJobs archivos para no tener todos los processors vivos a la vez.
+    juce::ThreadPool pool(numJobs);
+    const double wallStart = juce::Time::getMillisecondCounterHiRes();
+
+    for (size_t first = 0; first < results.size(); first += size_t(numJobs))
+    {
+        const size_t last = juce::jmin(results.size(), first + size_t(numJobs));
+        std::vector<std::unique_ptr<AudioPluginAudioProcessor>> processors;
+
+        for (size_t i = first; i < last; ++i)
+        {
+            auto processor = std::make_unique<AudioPluginAudioProcessor>();
+            processor->setNonRealtime(true);
+            processor->setPlayConfigDetails(0, 2, settings.sampleRate, settings.blockSize);
+
+            if (configure(*processor, settings, results[i].error))
+                processor->prepareToPlay(settings.sampleRate, settings.blockSize);
+            else
+                processor.reset();
+
+            processors.push_back(std::move(processor));
+        }
+
+        // El estado restaurado encola sus formas de onda y su wavetable importada
+        // en segundo plano: se espera a que estén listas para que el render no
+        // dependa del momento
+        for (const auto &processor : processors)
+            while (processor != nullptr
+                   && (processor->hasPendingWaveBuilds() || processor->getWavetableStatus().loading))
+                juce::Thread::sleep(1);
+
+        for (size_t i = first; i < last; ++i)
+            if (auto *processor = processors[i - first].get())
+                pool.addJob([processor, &settings, &result = results[i]]
+                            { render(*processor, settings, result); });
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(1);
+    }
+
+    const double wallSeconds = (juce::Time::getMillisecondCounterHiRes() - wallStart) * 0.001;
+
+    std::printf("%-32s %10s %10s %10s %10s %9s %7s %10s\n", "file", "audio s", "render s", "RTF", "RTF (io)", "peak dB",
+                "voices", "memory");
+
+    double totalAudio = 0.0;
+    int failures = 0;
+    for (const auto &r : results)
+    {
+        const auto name = r.input.getFileName().toRawUTF8();
+        if (r.error.isNotEmpty())
+        {
+            std::printf("%-32s FAILED: %s\n", name, r.error.toRawUTF8());
+            ++failures;
+            continue;
+        }
+
+        totalAudio += r.audioSeconds;
+        std::printf("%-32s %10.2f %10.3f %9.1fx %9.1fx %9.1f %7d %10s\n", name, r.audioSeconds, r.renderSeconds,
+                    r.audioSeconds / juce::jmax(1.0e-9, r.renderSeconds),
+                    r.audioSeconds / juce::jmax(1.0e-9, r.totalSeconds),
+                    juce::Decibels::gainToDecibels(r.peak, -120.0f),
+                    r.voices.peakPolyphony,
+                    MemoryUsage::formatBytes(r.memory.peakTotalBytes).toRawUTF8());
+
+        if (showMemory)
+            std::printf("%s\n", r.memory.toDetailedString().toRawUTF8());
+        if (showVoices)
+            std::printf("%s\n", r.voices.toDetailedString().toRawUTF8());
+    }
+
+    std::printf("\n%.2f s of audio in %.3f s wall clock: %.1fx real time across %d job(s)\n",
+                totalAudio, wallSeconds, totalAudio / juce::jmax(1.0e-9, wallSeconds), numJobs);
+    std::printf("RTF = audio seconds / processBlock seconds; RTF (io) includes parsing and WAV writing.\n");
+    return failures == 0 ? 0 : 2;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file ResamplerCheck.cpp
+ * @brief Checks the stopband and passband of PolyphaseResampler at the rates the engine converts between.
+ *
+ * For every pair of rates a sine is converted and the output is measured at
+ * one frequency (Goertzel over a Blackman-Harris window):
+ *  - stopband: tones that fold back into the output. Downsampling, a tone
+ *    between the output and input Nyquist frequencies aliases to
+ *    outputRate - f; upsampling, a tone below the input Nyquist frequency
+ *    images to inputRate - f. Both must be at least stopbandDb down,
+ *    starting exactly at the lower Nyquist frequency.
+ *  - passband: a tone at 0.8 × the lower Nyquist frequency keeps its level
+ *    within passbandDb.
+ *
+ * The exit code is 1 if any measurement fails; CMake registers the tool as
+ * the TECResamplerCheck ctest.
+ *
+ * Usage:
+ *   TECResamplerCheck
+ */
+
+#include <JuceHeader.h>
+#include "DSP/PolyphaseResampler.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    constexpr double stopbandDb = -70.0;
+    constexpr double passbandDb = 0.5;
+    constexpr int blockSize = 512;
+    constexpr int numMeasured = 16384;
+
+    /** @brief Converts a unit sine at frequency f; returns numMeasured output samples after the converter settles. */
+    std::vector<float> convertTone(double inputRate, double outputRate, double f)
+    {
+        PolyphaseResampler resampler;
+        resampler.prepare(inputRate, outputRate, blockSize);
+
+        std::vector<float> input(size_t(resampler.getMaxInputSamples()));
+        std::vector<float> block(blockSize);
+        std::vector<float> output;
+
+        // Se descarta el retardo del filtro más un bloque
+        const int skip = int(std::ceil(resampler.getLatencyInOutputSamples())) + blockSize;
+        const double delta = juce::MathConstants<double>::twoPi * f / inputRate;
+        double phase = 0.0;
+
+        for (int produced = 0; int(output.size()) < numMeasured; produced += blockSize)
+        {
+            const int numInput = resampler.getInputSamplesNeeded(blockSize);
+            for (int i = 0; i < numInput; ++i, phase += delta)
+                input[size_t(i)] = float(std::sin(phase));
+
+            resampler.process(input.data(), numInput, block.data(), blockSize);
+
+            for (int i = 0; i < blockSize && int(output.size()) < numMeasured; ++i)
+                if (produced + i >= skip)
+                    output.push_back(block[size_t(i)]);
+        }
+        return output;
+    }
+
+    /** @brief Level of one frequency in dB relative to a unit sine (Goertzel, 4-term Blackman-Harris window). */
+    double levelDb(const std::vector<float> &x, double f, double sampleRate)
+    {
+        const double w = juce::MathConstants<double>::twoPi * f / sampleRate;
+        const double coeff = 2.0 * std::cos(w);
+        const double n = double(x.size() - 1);
+        double s1 = 0.0, s2 = 0.0, windowSum = 0.0;
+
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            const double a = juce::MathConstants<double>::twoPi * double(i) / n;
+            const double window = 0.35875 - 0.48829 * std::cos(a) + 0.14128 * std::cos(2.0 * a) - 0.01168 * std::cos(3.0 * a);
+            const double s0 = window * x[i] + coeff * s1 - s2;
+            s2 = s1;
+            s1 = s0;
+            windowSum += window;
+        }
+
+        const double magnitude = std::sqrt(std::max(0.0, s1 * s1 + s2 * s2 - coeff * s1 * s2));
+        return juce::Decibels::gainToDecibels(2.0 * magnitude / windowSum, -200.0);
+    }
+
+    /** @brief Checks one pair of rates and prints one line per measurement; returns the number of failures. */
+    int checkRates(double inputRate, double outputRate)
+    {
+        const double lowerNyquist = 0.5 * std::min(inputRate, outputRate);
+        const bool downsampling = inputRate > outputRate;
+        int failures = 0;
+
+        const auto report = [&](const char *band, double tone, double measuredAt, double level, bool pass)
+        {
+            std::printf("%6.0f -> %6.0f  %-8s tone %8.1f Hz  at %8.1f Hz  %7.1f dB  %s\n", inputRate, outputRate,
+                        band, tone, measuredAt, level, pass ? "PASS" : "FAIL");
+            if (!pass)
+                ++failures;
+        };
+
+        // Desde el Nyquist más bajo hacia dentro de la banda de rechazo
+        for (double offset : {0.0, 0.01, 0.02, 0.04, 0.08})
+        {
+            const double tone = downsampling ? lowerNyquist * (1.0 + offset) : lowerNyquist * (1.0 - offset);
+            if (tone >= 0.5 * inputRate)
+                continue;
+
+            const double folded = downsampling ? outputRate - tone : inputRate - tone;
+            const double level = levelDb(convertTone(inputRate, outputRate, tone), folded, outputRate);
+            report("stopband", tone, folded, level, level <= stopbandDb);
+        }
+
+        const double tone = 0.8 * lowerNyquist;
+        const double level = levelDb(convertTone(inputRate, outputRate, tone), tone, outputRate);
+        report("passband", tone, tone, level, std::abs(level) <= passbandDb);
+
+        return failures;
+    }
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    std::printf("TEC Synth resampler check: %d taps, stopband <= %.0f dB from the lower Nyquist, passband +-%.1f dB\n\n",
+                PolyphaseResampler::numTaps, stopbandDb, passbandDb);
+
+    int failures = 0;
+    for (const auto &rates : {std::pair<double, double>{48000.0, 44100.0}, {44100.0, 48000.0}, {48000.0, 88200.0},
+                              {44100.0, 96000.0}, {48000.0, 192000.0}})
+        failures += checkRates(rates.first, rates.second);
+
+    std::printf("\n%s\n", failures == 0 ? "All measurements passed" : "Resampler check FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file StartupBenchmark.cpp
+ * @brief Measures the cost of bringing plugin instances up, as a host does when opening a project.
+ *
+ * For every instance it times:
+ *  - construction of AudioPluginAudioProcessor (voices build the Sine at 44.1 kHz),
+ *  - prepareToPlay (rebuilds the Sine, and builds the selected WAVE, at the host rate),
+ *  - a state round trip (getStateInformation + setStateInformation),
+ *  - the first processBlock.
+ *
+ * It also times materializing the remaining waveforms, which is the work the
+ * oscillators used to do eagerly in their constructors and now happens lazily
+ * on a background thread.
+ *
+ * Usage:
+ *   TECStartupBenchmark [--instances N] [--sample-rate HZ] [--block-size N]
+ */
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    struct PhaseStats
+    {
+        const char *name;
+        double totalMs = 0.0;
+        double minMs = 1.0e30;
+        double maxMs = 0.0;
+
+        void add(double ms)
+        {
+            totalMs += ms;
+            minMs = juce::jmin(minMs, ms);
+            maxMs = juce::jmax(maxMs, ms);
+        }
+    };
+
+    template <typename Fn>
+    double timeMs(Fn &&fn)
+    {
+        const double start = juce::Time::getMillisecondCounterHiRes();
+        fn();
+        return juce::Time::getMillisecondCounterHiRes() - start;
+    }
+
+    int intOption(const juce::ArgumentList &args, const char *option, int fallback)
+    {
+        const auto value = args.getValueForOption(option);
+        return value.isNotEmpty() ? value.getIntValue() : fallback;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    const int numInstances = juce::jmax(1, intOption(args, "--instances", 16));
+    const double sampleRate = double(juce::jmax(8000, intOption(args, "--sample-rate", 48000)));
+    const int blockSize = juce::jmax(1, intOption(args, "--block-size", 512));
+
+    PhaseStats construct{"constructor"};
+    PhaseStats prepare{"prepareToPlay"};
+    PhaseStats state{"state round trip"};
+    PhaseStats firstBlock{"first processBlock"};
+    PhaseStats remainingWaves{"other waves (background)"};
+
+    std::vector<std::unique_ptr<AudioPluginAudioProcessor>> instances;
+    instances.reserve(size_t(numInstances));
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+
+    const double wallStart = juce::Time::getMillisecondCounterHiRes();
+
+    for (int i = 0; i < numInstances; ++i)
+    {
+        std::unique_ptr<AudioPluginAudioProcessor> p;
+        construct.add(timeMs([&]
+                             { p = std::make_unique<AudioPluginAudioProcessor>(); }));
+
+        p->setPlayConfigDetails(0, 2, sampleRate, blockSize);
+        prepare.add(timeMs([&]
+                           { p->prepareToPlay(sampleRate, blockSize); }));
+
+        state.add(timeMs([&]
+                         {
+                             juce::MemoryBlock data;
+                             p->getStateInformation(data);
+                             p->setStateInformation(data.getData(), int(data.getSize())); }));
+
+        firstBlock.add(timeMs([&]
+                              { p->processBlock(buffer, midi); }));
+
+        instances.push_back(std::move(p));
+    }
+
+    const double wallMs = juce::Time::getMillisecondCounterHiRes() - wallStart;
+
+    // Lo que antes pagaba cada constructor: el resto de las formas de onda
+    for (auto &p : instances)
+        remainingWaves.add(timeMs([&]
+                                  {
+                                      for (int wave = 1; wave < OscillatorWrapper::numWaveTypes; ++wave)
+                                          p->materializeWave(wave); }));
+
+    std::printf("TEC Synth startup benchmark: %d instances, %.0f Hz, %d samples/block\n\n",
+                numInstances, sampleRate, blockSize);
+    std::printf("%-26s %10s %10s %10s %12s\n", "phase", "mean ms", "min ms", "max ms", "total ms");
+
+    for (const auto *s : {&construct, &prepare, &state, &firstBlock, &remainingWaves})
+        std::printf("%-26s %10.3f %10.3f %10.3f %12.3f\n",
+                    s->name, s->totalMs / numInstances, s->minMs, s->maxMs, s->totalMs);
+
+    std::printf("\nproject open (all instances, excluding background work): %.3f ms\n", wallMs);
+    return 0;
+}
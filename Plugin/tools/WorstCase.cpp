@@ -0,0 +1,399 @@
+/**
+ * @file WorstCase.cpp
+ * @brief Drives AudioPluginAudioProcessor like an irregular host and reports tail block times.
+ *
+ * Audio dropouts come from the slowest block, not the average one, so this
+ * tool plays a seeded, reproducible "host" against the processor and keeps
+ * the time of every single processBlock call:
+ *  - block sizes drawn log-uniformly from 1 to --max-block (default 4096),
+ *  - sample-rate switches (releaseResources + prepareToPlay) every few seconds,
+ *  - parameter automation on every parameter, any block,
+ *  - ordinary note on/off traffic at random offsets,
+ *  - retrigger storms: one note hammered dozens of times within a block,
+ *  - clusters: all 128 notes on (and later off) in a single block.
+ *
+ * Each block is labelled with the heaviest event it contained. For every
+ * label and overall it prints the median, p99, p99.9 and max of:
+ *  - ns per sample (block time / block size),
+ *  - load (block time / real-time duration of the block; > 100% is a dropout).
+ * The slowest blocks are listed with their size, rate and seed position, so a
+ * regression can be reproduced with the same --seed.
+ *
+ * The processor runs as a realtime host would (QualityGovernor on, unless
+ * --no-governor). All waveforms are materialized up front, as the background
+ * builder would have done by the time a user plays.
+ *
+ * Usage:
+ *   TECWorstCase [--seconds=S] [--max-block=N] [--sample-rates=44100,48000,...]
+ *                [--seed=N] [--no-governor] [--out=FILE.json]
+ */
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "Oscillator/OscillatorWrapper.h"
+#include "DSP/KernelDispatch.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    enum class Scenario
+    {
+        Steady,
+        Automation,
+        RateSwitch,
+        Retrigger,
+        Cluster
+    };
+
+    constexpr int numScenarios = 5;
+
+    const char *scenarioName(Scenario s)
+    {
+        switch (s)
+        {
+        case Scenario::Steady:
+            return "steady";
+        case Scenario::Automation:
+            return "automation";
+        case Scenario::RateSwitch:
+            return "rate-switch";
+        case Scenario::Retrigger:
+            return "retrigger";
+        case Scenario::Cluster:
+            return "cluster";
+        }
+        return "?";
+    }
+
+    struct Settings
+    {
+        double seconds = 60.0; ///< Simulated audio time, all rates together.
+        int maxBlock = 4096;
+        std::vector<double> sampleRates{44100.0, 48000.0, 88200.0, 96000.0};
+        juce::int64 seed = 1;
+        bool governor = true;
+    };
+
+    struct BlockRecord
+    {
+        double nsPerSample;
+        double load;
+        int blockSize;
+        double sampleRate;
+        Scenario scenario;
+        juce::int64 index;
+    };
+
+    /** @brief Host behaviour: block sizes, MIDI and automation, all from one seeded generator. */
+    class HostSimulator
+    {
+    public:
+        HostSimulator(AudioPluginAudioProcessor &p, const Settings &s)
+            : settings(s), random(s.seed)
+        {
+            for (auto *param : p.getParameters())
+                if (auto *ranged = dynamic_cast<juce::RangedAudioParameter *>(param))
+                    if (ranged->isAutomatable() && ranged->getParameterID() != "GOVERNOR")
+                        automatable.push_back(ranged);
+        }
+
+        /** @brief Log-uniform in [1, maxBlock]: small blocks are as likely per octave as large ones. */
+        int nextBlockSize()
+        {
+            const double octaves = std::log2(double(settings.maxBlock));
+            return juce::jlimit(1, settings.maxBlock, int(std::pow(2.0, random.nextDouble() * octaves) + 0.5));
+        }
+
+        /** @brief Fills the MIDI for one block; returns the heaviest event it contains. */
+        Scenario fillBlock(juce::MidiBuffer &midi, int blockSize)
+        {
+            Scenario scenario = Scenario::Steady;
+            const auto raise = [&scenario](Scenario s)
+            { scenario = juce::jmax(scenario, s); };
+            const auto offset = [this, blockSize]
+            { return random.nextInt(blockSize); };
+
+            // Automatización: el host escribe parámetros en el hilo de audio
+            if (random.nextFloat() < 0.05f)
+            {
+                for (int n = 1 + random.nextInt(4); --n >= 0;)
+                    automatable[size_t(random.nextInt(int(automatable.size())))]->setValueNotifyingHost(random.nextFloat());
+                raise(Scenario::Automation);
+            }
+
+            // Tráfico normal de notas
+            if (random.nextFloat() < 0.3f)
+            {
+                for (int n = 1 + random.nextInt(3); --n >= 0;)
+                {
+                    const int note = 24 + random.nextInt(72);
+                    if (held[size_t(note)])
+                        noteOff(midi, note, offset());
+                    else
+                        noteOn(midi, note, offset());
+                }
+            }
+
+            // Retrigger: una nota golpeada decenas de veces en el mismo bloque
+            if (random.nextFloat() < 0.01f)
+            {
+                const int note = 36 + random.nextInt(48);
+                for (int n = 16 + random.nextInt(48); --n >= 0;)
+                {
+                    noteOn(midi, note, offset());
+                    noteOff(midi, note, offset());
+                }
+                raise(Scenario::Retrigger);
+            }
+
+            // Cluster: las 128 notas a la vez, y más adelante todas fuera
+            if (random.nextFloat() < 0.005f)
+            {
+                const bool release = numHeld > 64;
+                for (int note = 0; note < 128; ++note)
+                {
+                    if (release)
+                        noteOff(midi, note, offset());
+                    else
+                        noteOn(midi, note, offset());
+                }
+                raise(Scenario::Cluster);
+            }
+
+            return scenario;
+        }
+
+    private:
+        void noteOn(juce::MidiBuffer &midi, int note, int sample)
+        {
+            midi.addEvent(juce::MidiMessage::noteOn(1, note, 0.2f + 0.8f * random.nextFloat()), sample);
+            if (!held[size_t(note)])
+                ++numHeld;
+            held[size_t(note)] = true;
+        }
+
+        void noteOff(juce::MidiBuffer &midi, int note, int sample)
+        {
+            midi.addEvent(juce::MidiMessage::noteOff(1, note), sample);
+            if (held[size_t(note)])
+                --numHeld;
+            held[size_t(note)] = false;
+        }
+
+        const Settings &settings;
+        juce::Random random;
+        std::vector<juce::RangedAudioParameter *> automatable;
+        std::array<bool, 128> held{};
+        int numHeld = 0;
+    };
+
+    /** @brief Value at quantile q of an already sorted vector. */
+    double quantile(const std::vector<double> &sorted, double q)
+    {
+        if (sorted.empty())
+            return 0.0;
+        const auto index = size_t(std::ceil(q * double(sorted.size()))) - 1;
+        return sorted[juce::jlimit<size_t>(0, sorted.size() - 1, index)];
+    }
+
+    struct Summary
+    {
+        size_t blocks = 0;
+        double nsPerSample[4]{}; ///< median, p99, p99.9, max
+        double load[4]{};
+    };
+
+    Summary summarize(const std::vector<BlockRecord> &records, int scenarioFilter)
+    {
+        std::vector<double> ns, load;
+        for (const auto &r : records)
+            if (scenarioFilter < 0 || int(r.scenario) == scenarioFilter)
+            {
+                ns.push_back(r.nsPerSample);
+                load.push_back(r.load);
+            }
+
+        std::sort(ns.begin(), ns.end());
+        std::sort(load.begin(), load.end());
+
+        Summary s;
+        s.blocks = ns.size();
+        const double qs[4] = {0.5, 0.99, 0.999, 1.0};
+        for (int i = 0; i < 4; ++i)
+        {
+            s.nsPerSample[i] = quantile(ns, qs[i]);
+            s.load[i] = quantile(load, qs[i]);
+        }
+        return s;
+    }
+
+    juce::var summaryToVar(const Summary &s)
+    {
+        auto *obj = new juce::DynamicObject();
+        obj->setProperty("blocks", int(s.blocks));
+        const char *names[4] = {"median", "p99", "p99.9", "max"};
+        for (int i = 0; i < 4; ++i)
+        {
+            obj->setProperty(juce::String("nsPerSample_") + names[i], s.nsPerSample[i]);
+            obj->setProperty(juce::String("load_") + names[i], s.load[i]);
+        }
+        return juce::var(obj);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::printf("Usage: TECWorstCase [--seconds=S] [--max-block=N] [--sample-rates=44100,48000,...]\n"
+                    "                    [--seed=N] [--no-governor] [--out=FILE.json]\n");
+        return 0;
+    }
+
+    Settings settings;
+    if (const auto v = args.getValueForOption("--seconds"); v.isNotEmpty())
+        settings.seconds = juce::jmax(1.0, v.getDoubleValue());
+    if (const auto v = args.getValueForOption("--max-block"); v.isNotEmpty())
+        settings.maxBlock = juce::jmax(1, v.getIntValue());
+    if (const auto v = args.getValueForOption("--seed"); v.isNotEmpty())
+        settings.seed = v.getLargeIntValue();
+    if (const auto v = args.getValueForOption("--sample-rates"); v.isNotEmpty())
+    {
+        settings.sampleRates.clear();
+        for (const auto &rate : juce::StringArray::fromTokens(v, ",", {}))
+            if (rate.getDoubleValue() >= 8000.0)
+                settings.sampleRates.push_back(rate.getDoubleValue());
+        if (settings.sampleRates.empty())
+            settings.sampleRates = {48000.0};
+    }
+    settings.governor = !args.containsOption("--no-governor");
+
+    AudioPluginAudioProcessor processor;
+    if (auto *governor = processor.apvts.getParameter("GOVERNOR"))
+        governor->setValueNotifyingHost(settings.governor ? 1.0f : 0.0f);
+
+    HostSimulator host(processor, settings);
+    juce::Random schedule(settings.seed + 1);
+
+    juce::AudioBuffer<float> buffer(2, settings.maxBlock);
+    juce::MidiBuffer midi;
+    std::vector<BlockRecord> records;
+    double worstPrepareMs = 0.0;
+
+    std::printf("TEC Synth worst-case harness: %.0f s simulated, blocks 1-%d, seed %lld, kernels %s, governor %s\n\n",
+                settings.seconds, settings.maxBlock, (long long)settings.seed,
+                KernelDispatch::get().name, settings.governor ? "on" : "off");
+
+    const double ticksPerNs = double(juce::Time::getHighResolutionTicksPerSecond()) / 1.0e9;
+    double simulated = 0.0;
+    double sampleRate = 0.0;
+    juce::int64 blockIndex = 0;
+
+    while (simulated < settings.seconds)
+    {
+        // Cambio de sample rate, como al cambiar de interfaz de audio
+        double nextRate = settings.sampleRates[size_t(schedule.nextInt(int(settings.sampleRates.size())))];
+        if (settings.sampleRates.size() > 1)
+            while (nextRate == sampleRate)
+                nextRate = settings.sampleRates[size_t(schedule.nextInt(int(settings.sampleRates.size())))];
+        sampleRate = nextRate;
+
+        const double prepareStart = juce::Time::getMillisecondCounterHiRes();
+        processor.releaseResources();
+        processor.setPlayConfigDetails(0, 2, sampleRate, settings.maxBlock);
+        processor.prepareToPlay(sampleRate, settings.maxBlock);
+        worstPrepareMs = juce::jmax(worstPrepareMs, juce::Time::getMillisecondCounterHiRes() - prepareStart);
+
+        for (int wave = 0; wave < OscillatorWrapper::numWaveTypes; ++wave)
+            processor.materializeWave(wave);
+
+        const double segmentSeconds = juce::jmin(settings.seconds - simulated, 1.0 + 4.0 * schedule.nextDouble());
+        const auto segmentSamples = juce::int64(segmentSeconds * sampleRate);
+        int blocksSincePrepare = 0;
+
+        for (juce::int64 done = 0; done < segmentSamples; ++blockIndex, ++blocksSincePrepare)
+        {
+            const int blockSize = int(juce::jmin<juce::int64>(host.nextBlockSize(), segmentSamples - done));
+            midi.clear();
+            auto scenario = host.fillBlock(midi, blockSize);
+            if (blocksSincePrepare < 4)
+                scenario = juce::jmax(scenario, Scenario::RateSwitch);
+
+            juce::AudioBuffer<float> view(buffer.getArrayOfWritePointers(), 2, blockSize);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(view, midi);
+            const double ns = double(juce::Time::getHighResolutionTicks() - start) / ticksPerNs;
+
+            const double budgetNs = 1.0e9 * blockSize / sampleRate;
+            records.push_back({ns / blockSize, ns / budgetNs, blockSize, sampleRate, scenario, blockIndex});
+            done += blockSize;
+        }
+
+        simulated += segmentSeconds;
+    }
+
+    std::printf("%-12s %9s  %-41s  %s\n", "", "", "ns/sample: median / p99 / p99.9 / max",
+                "load %: median / p99 / p99.9 / max");
+
+    const auto printRow = [](const char *name, const Summary &s)
+    {
+        if (s.blocks == 0)
+            return;
+        std::printf("%-12s %9zu  %8.1f %8.1f %8.1f %10.1f    %6.1f %6.1f %7.1f %8.1f\n",
+                    name, s.blocks,
+                    s.nsPerSample[0], s.nsPerSample[1], s.nsPerSample[2], s.nsPerSample[3],
+                    100.0 * s.load[0], 100.0 * s.load[1], 100.0 * s.load[2], 100.0 * s.load[3]);
+    };
+
+    const auto overall = summarize(records, -1);
+    printRow("all", overall);
+    for (int s = 0; s < numScenarios; ++s)
+        printRow(scenarioName(Scenario(s)), summarize(records, s));
+
+    std::printf("\nworst prepareToPlay: %.2f ms\n\nslowest blocks (by load):\n", worstPrepareMs);
+
+    auto worst = records;
+    const size_t numWorst = juce::jmin<size_t>(10, worst.size());
+    std::partial_sort(worst.begin(), worst.begin() + long(numWorst), worst.end(),
+                      [](const BlockRecord &a, const BlockRecord &b)
+                      { return a.load > b.load; });
+
+    for (size_t i = 0; i < numWorst; ++i)
+        std::printf("  block %8lld  %4d samples @ %6.0f Hz  %-11s  %9.1f ns/sample  load %6.1f%%\n",
+                    (long long)worst[i].index, worst[i].blockSize, worst[i].sampleRate,
+                    scenarioName(worst[i].scenario), worst[i].nsPerSample, 100.0 * worst[i].load);
+
+    const auto outArg = args.getValueForOption("--out");
+    if (outArg.isNotEmpty())
+    {
+        auto *root = new juce::DynamicObject();
+        root->setProperty("tool", "TECWorstCase");
+        root->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+        root->setProperty("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty("kernels", KernelDispatch::get().name);
+        root->setProperty("seed", settings.seed);
+        root->setProperty("seconds", settings.seconds);
+        root->setProperty("maxBlock", settings.maxBlock);
+        root->setProperty("governor", settings.governor);
+        root->setProperty("worstPrepareMs", worstPrepareMs);
+        root->setProperty("all", summaryToVar(overall));
+        for (int s = 0; s < numScenarios; ++s)
+            root->setProperty(scenarioName(Scenario(s)), summaryToVar(summarize(records, s)));
+
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(outArg);
+        if (!file.replaceWithText(juce::JSON::toString(juce::var(root))))
+        {
+            std::fprintf(stderr, "cannot write %s\n", file.getFullPathName().toRawUTF8());
+            return 1;
+        }
+    }
+    return 0;
+}